@@ -6,10 +6,19 @@ Public Domain
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
 
 #include <pigpiod_if2.h>
 
 #include "DHTXXD.h"
+#include "clock_source.h"
+#include "rt_sched.h"
+#include "dht_bits.h"
 
 /*
 
@@ -19,6 +28,10 @@ Code to read the DHTXX temperature/humidity sensors.
 
 /* PRIVATE ---------------------------------------------------------------- */
 
+#define ASYNC_IDLE    0 /* no asynchronous read in progress */
+#define ASYNC_RELEASE 1 /* start pulse being held low */
+#define ASYNC_WAIT    2 /* waiting for the frame or the timeout */
+
 struct DHTXXD_s
 {
    int pi;
@@ -40,8 +53,146 @@ struct DHTXXD_s
    DHTXXD_data_t _data;
    uint32_t _last_edge_tick;
    int _ignore_reading;
+   int decoder;
+   DHTBitCalib _calib;
+   uint16_t _edges[DHT_FRAME_BITS];
+   FILE *_trace;
+   /* asynchronous read state */
+   pthread_mutex_t _async_lock;
+   int _async_state;
+   int _async_started;
+   double _async_timeout;
+   DHTXXD_DONE_t _async_done;
+   void *_async_user;
+   DHTXXD_data_t _async_result;
+   int _async_result_ready;
+   int _timer_fd;
+   int _event_fd;
+   int _stop_fd;
+   pthread_t _async_thread;
 };
 
+static void _arm_timer(DHTXXD_t *self, double seconds)
+{
+   struct itimerspec its;
+
+   memset(&its, 0, sizeof(its));
+   its.it_value.tv_sec = (time_t)seconds;
+   its.it_value.tv_nsec = (long)((seconds - its.it_value.tv_sec) * 1e9);
+   if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+      its.it_value.tv_nsec = 1; /* zero would disarm the timer */
+   timerfd_settime(self->_timer_fd, 0, &its, NULL);
+}
+
+static void _disarm_timer(DHTXXD_t *self)
+{
+   struct itimerspec its;
+
+   memset(&its, 0, sizeof(its));
+   timerfd_settime(self->_timer_fd, 0, &its, NULL);
+}
+
+/*
+Finishes the pending asynchronous read.  Called with _async_lock held,
+returns with it released.
+*/
+static void _async_complete(DHTXXD_t *self, DHTXXD_data_t data)
+{
+   DHTXXD_DONE_t done;
+   void *user;
+   uint64_t one = 1;
+
+   _disarm_timer(self);
+   self->_async_state = ASYNC_IDLE;
+   self->_async_result = data;
+   self->_async_result_ready = 1;
+   done = self->_async_done;
+   user = self->_async_user;
+   pthread_mutex_unlock(&self->_async_lock);
+
+   if (done) done(data, user);
+   if (write(self->_event_fd, &one, sizeof(one)) < 0) { /* counter saturated */ }
+}
+
+static void *_async_thread_func(void *x)
+{
+   DHTXXD_t *self=x;
+   struct pollfd fds[2];
+   uint64_t expirations;
+
+   fds[0].fd = self->_timer_fd;
+   fds[0].events = POLLIN;
+   fds[1].fd = self->_stop_fd;
+   fds[1].events = POLLIN;
+
+   while (1)
+   {
+      if (poll(fds, 2, -1) < 0) continue;
+      if (fds[1].revents & POLLIN) break;
+      if (!(fds[0].revents & POLLIN)) continue;
+      if (read(self->_timer_fd, &expirations, sizeof(expirations)) < 0) continue;
+
+      pthread_mutex_lock(&self->_async_lock);
+
+      if (self->_async_state == ASYNC_RELEASE)
+      {
+         /*
+         End of the start pulse, let the sensor answer.  The lock is
+         released first as the frame edges complete the read.
+         */
+         self->_async_state = ASYNC_WAIT;
+         _arm_timer(self, self->_async_timeout);
+         pthread_mutex_unlock(&self->_async_lock);
+         set_mode(self->pi, self->gpio, PI_INPUT);
+      }
+      else if (self->_async_state == ASYNC_WAIT)
+      {
+         /*
+         No frame arrived in time.  As on the frame path the callback
+         runs without the lock held; a cancel or late frame in between
+         completes the read instead.
+         */
+         DHTXXD_data_t data;
+
+         self->_data.timestamp = clock_now();
+         self->_data.status = DHT_TIMEOUT;
+         self->_ready = 1;
+         data = self->_data;
+         pthread_mutex_unlock(&self->_async_lock);
+
+         if (self->cb) (self->cb)(data);
+
+         pthread_mutex_lock(&self->_async_lock);
+         if (self->_async_state == ASYNC_WAIT) _async_complete(self, data);
+         else pthread_mutex_unlock(&self->_async_lock);
+      }
+      else pthread_mutex_unlock(&self->_async_lock);
+   }
+   return NULL;
+}
+
+static int _async_init(DHTXXD_t *self)
+{
+   if (self->_async_started) return 0;
+
+   self->_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+   self->_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   self->_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+   if ((self->_timer_fd < 0) || (self->_event_fd < 0) || (self->_stop_fd < 0) ||
+       pthread_create(&self->_async_thread, NULL, _async_thread_func, self))
+   {
+      if (self->_timer_fd >= 0) close(self->_timer_fd);
+      if (self->_event_fd >= 0) close(self->_event_fd);
+      if (self->_stop_fd >= 0) close(self->_stop_fd);
+      self->_timer_fd = self->_event_fd = self->_stop_fd = -1;
+      return -1;
+   }
+
+   self->_async_started = 1;
+   return 0;
+}
+
 static void _decode_dhtxx(DHTXXD_t *self)
 {
 /*
@@ -69,7 +220,7 @@ DHT44 |      |      |      |      |      |
    float t, h;
    int valid;
 
-   self->_data.timestamp = time_time();
+   self->_data.timestamp = clock_now();
 
    chksum = (self->_byte[1] + self->_byte[2] +
              self->_byte[3] + self->_byte[4]) & 0xFF;
@@ -162,6 +313,38 @@ DHT44 |      |      |      |      |      |
    self->_new_reading = 1;
 
    if (self->cb) (self->cb)(self->_data);
+
+   if (self->_async_started)
+   {
+      pthread_mutex_lock(&self->_async_lock);
+      if (self->_async_state == ASYNC_WAIT) _async_complete(self, self->_data);
+      else pthread_mutex_unlock(&self->_async_lock);
+   }
+}
+
+static void _frame_complete(DHTXXD_t *self)
+{
+   uint64_t code;
+   int rc;
+   int i;
+
+   if (self->_trace)
+   {
+      fprintf(self->_trace, "%.3f", clock_now());
+      for (i=0; i<DHT_FRAME_BITS; i++) fprintf(self->_trace, " %u", self->_edges[i]);
+      fputc('\n', self->_trace);
+   }
+
+   if (self->decoder == DHT_DECODER_ADAPTIVE)
+      rc = dht_bits_adaptive(self->_edges, &self->_calib, &code);
+   else
+      rc = dht_bits_fixed(self->_edges, &code);
+
+   if (rc) return; /* invalid bit */
+
+   self->_code = code;
+
+   if (!self->_ignore_reading) _decode_dhtxx(self);
 }
 
 static void _cb(
@@ -171,6 +354,8 @@ static void _cb(
    DHTXXD_t *self=user;
    int edge_len;
 
+   rt_capture_thread_hook(); /* real-time mode: promote the callback thread once */
+
    edge_len = tick - self->_last_edge_tick;
    self->_last_edge_tick = tick;
 
@@ -185,29 +370,13 @@ static void _cb(
       self->_bits++;
       if (self->_bits >= 1)
       {
-         self->_code <<= 1;
+         /* record the edge, classify once the frame is complete */
+         self->_edges[self->_bits - 1] = (edge_len < 0) ? 0 : edge_len;
 
-         if ((edge_len >= 60) && (edge_len <= 100))
+         if (self->_bits == DHT_FRAME_BITS)
          {
-            /* 0 bit */
-         }
-         else if ((edge_len > 100) && (edge_len <= 150))
-         {
-            /* 1 bit */
-            self->_code += 1;
-         }
-         else
-         {
-            /* invalid bit */
             self->_in_code = 0;
-         }
-
-         if (self->_in_code)
-         {
-            if (self->_bits == 40)
-            {
-               if (!self->_ignore_reading) _decode_dhtxx(self);
-            }
+            _frame_complete(self);
          }
       }
    }
@@ -216,7 +385,7 @@ static void _cb(
 static void _trigger(DHTXXD_t *self)
 {
    gpio_write(self->pi, self->gpio, 0);
-   if (self->model != DHTXX) time_sleep(0.018); else time_sleep(0.001);
+   if (self->model != DHTXX) clock_sleep(0.018); else clock_sleep(0.001);
    set_mode(self->pi, self->gpio, PI_INPUT);
 }
 
@@ -233,17 +402,17 @@ static void *pthTriggerThread(void *x)
       {
          if (seconds >= 30.0)
          {
-            time_sleep(seconds - 4.0);
+            clock_sleep(seconds - 4.0);
             self->_ignore_reading = 1;
             _trigger(self);
-            time_sleep(4.0);
+            clock_sleep(4.0);
             self->_ignore_reading = 0;
          }
-         else time_sleep(seconds);
+         else clock_sleep(seconds);
 
          DHTXXD_manual_read(self);
       }
-      else time_sleep(1);
+      else clock_sleep(1);
    }
    return NULL;
 }
@@ -272,6 +441,10 @@ DHTXXD_t *DHTXXD(int pi, int gpio, int model, DHTXXD_CB_t cb_func)
 
    self->_ignore_reading = 0;
 
+   self->decoder = DHT_DECODER_FIXED;
+   dht_bits_calib_init(&self->_calib);
+   self->_trace = NULL;
+
    self->_pth = NULL;
 
    self->_in_code = 0;
@@ -279,6 +452,12 @@ DHTXXD_t *DHTXXD(int pi, int gpio, int model, DHTXXD_CB_t cb_func)
    self->_ready = 0;
    self->_new_reading = 0;
 
+   pthread_mutex_init(&self->_async_lock, NULL);
+   self->_async_state = ASYNC_IDLE;
+   self->_async_started = 0;
+   self->_async_result_ready = 0;
+   self->_timer_fd = self->_event_fd = self->_stop_fd = -1;
+
    set_mode(pi, gpio, PI_INPUT);
 
    self->_last_edge_tick = get_current_tick(pi) - 10000;
@@ -303,6 +482,19 @@ void DHTXXD_cancel(DHTXXD_t *self)
          callback_cancel(self->_cb_id);
          self->_cb_id = -1;
       }
+
+      if (self->_async_started)
+      {
+         uint64_t one = 1;
+
+         DHTXXD_read_cancel(self);
+         if (write(self->_stop_fd, &one, sizeof(one)) == sizeof(one))
+            pthread_join(self->_async_thread, NULL);
+         close(self->_timer_fd);
+         close(self->_event_fd);
+         close(self->_stop_fd);
+      }
+      pthread_mutex_destroy(&self->_async_lock);
       free(self);
    }
 }
@@ -330,13 +522,13 @@ void DHTXXD_manual_read(DHTXXD_t *self)
 
    self->_new_reading = 0;
    _trigger(self);
-   timestamp = time_time();
+   timestamp = clock_now();
 
    /* timeout if no new reading */
 
    for (i=0; i<5; i++) /* 0.25 seconds */
    {
-      time_sleep(0.05);
+      clock_sleep(0.05);
       if (self->_new_reading) break;
    }
 
@@ -366,3 +558,91 @@ void DHTXXD_auto_read(DHTXXD_t *self, float seconds)
    if (seconds > 0.0) self->_pth = start_thread(pthTriggerThread, self);
 }
 
+int DHTXXD_read_async(DHTXXD_t *self, float timeout,
+                      DHTXXD_DONE_t done_func, void *userdata)
+{
+   if (_async_init(self)) return -1;
+
+   pthread_mutex_lock(&self->_async_lock);
+
+   if (self->_async_state != ASYNC_IDLE)
+   {
+      pthread_mutex_unlock(&self->_async_lock);
+      return -1; /* busy */
+   }
+
+   self->_async_done = done_func;
+   self->_async_user = userdata;
+   self->_async_timeout = (timeout > 0.0) ? timeout : 0.25;
+   self->_async_result_ready = 0;
+   self->_new_reading = 0;
+
+   /* start pulse, released by the timer thread */
+   gpio_write(self->pi, self->gpio, 0);
+   self->_async_state = ASYNC_RELEASE;
+   _arm_timer(self, (self->model != DHTXX) ? 0.018 : 0.001);
+
+   pthread_mutex_unlock(&self->_async_lock);
+   return 0;
+}
+
+int DHTXXD_read_fd(DHTXXD_t *self)
+{
+   if (_async_init(self)) return -1;
+   return self->_event_fd;
+}
+
+int DHTXXD_read_result(DHTXXD_t *self, DHTXXD_data_t *data)
+{
+   uint64_t count;
+   int ready;
+
+   if (!self->_async_started) return 0;
+
+   /* clear the fd readiness */
+   if (read(self->_event_fd, &count, sizeof(count)) < 0) { /* nothing pending */ }
+
+   pthread_mutex_lock(&self->_async_lock);
+   ready = self->_async_result_ready;
+   if (ready && data) *data = self->_async_result;
+   self->_async_result_ready = 0;
+   pthread_mutex_unlock(&self->_async_lock);
+
+   return ready;
+}
+
+void DHTXXD_read_cancel(DHTXXD_t *self)
+{
+   if (!self->_async_started) return;
+
+   int release = 0;
+
+   pthread_mutex_lock(&self->_async_lock);
+
+   if (self->_async_state != ASYNC_IDLE)
+   {
+      _disarm_timer(self);
+      release = (self->_async_state == ASYNC_RELEASE);
+      self->_async_state = ASYNC_IDLE;
+   }
+
+   pthread_mutex_unlock(&self->_async_lock);
+
+   /* stop holding the line low */
+   if (release) set_mode(self->pi, self->gpio, PI_INPUT);
+}
+
+void DHTXXD_set_decoder(DHTXXD_t *self, int decoder)
+{
+   self->decoder = decoder;
+}
+
+void DHTXXD_decoder_stats(DHTXXD_t *self, DHTBitCalib *calib)
+{
+   *calib = self->_calib;
+}
+
+void DHTXXD_set_edge_trace(DHTXXD_t *self, FILE *fp)
+{
+   self->_trace = fp;
+}
@@ -7,6 +7,10 @@ Public Domain
 #ifndef DHTXXD_H
 #define DHTXXD_H
 
+#include <stdio.h>
+
+#include "dht_bits.h"
+
 struct DHTXXD_s;
 
 typedef struct DHTXXD_s DHTXXD_t;
@@ -32,6 +36,8 @@ typedef struct
 
 typedef void (*DHTXXD_CB_t)(DHTXXD_data_t);
 
+typedef void (*DHTXXD_DONE_t)(DHTXXD_data_t, void *);
+
 /*
 DHTXXD starts a DHTXX sensor on Pi pi with GPIO gpio.
 
@@ -56,6 +62,26 @@ DHT22 more than once every 3 seconds.  The DHT11 can
 safely be read once a second.  I don't know about the
 other models.
 
+A non-blocking reading may be started with DHTXXD_read_async.
+It drives the start pulse, returns at once and completes later
+with either the decoded frame or DHT_TIMEOUT after timeout
+seconds (0.25 if not positive).  On completion done_func (if
+not null) is called with the result and userdata, and the fd
+returned by DHTXXD_read_fd becomes readable.  The result is
+collected with DHTXXD_read_result, which also clears the fd.
+Only one asynchronous read may be pending; DHTXXD_read_async
+returns -1 if busy.  A pending read may be abandoned with
+DHTXXD_read_cancel.
+
+Bits are classified with fixed windows by default (DHT_DECODER_FIXED).
+DHTXXD_set_decoder(self, DHT_DECODER_ADAPTIVE) records each frame's
+40 edge lengths and finds the 0/1 split from the frame itself, falling
+back to a running estimate; the checksum still decides validity.
+DHTXXD_decoder_stats returns the current estimate and counters.  If
+DHTXXD_set_edge_trace is given a stream, every complete frame is
+written to it as a line of a timestamp and 40 edge lengths in
+microseconds (see dht_replay).
+
 At program end the DHTXX sensor should be cancelled using
 DHTXXD_cancel.  This releases system resources.
 */
@@ -75,5 +101,22 @@ void          DHTXXD_manual_read (DHTXXD_t *self);
 
 void          DHTXXD_auto_read   (DHTXXD_t *self, float seconds);
 
+int           DHTXXD_read_async  (DHTXXD_t *self,
+                                  float timeout,
+                                  DHTXXD_DONE_t done_func,
+                                  void *userdata);
+
+int           DHTXXD_read_fd     (DHTXXD_t *self);
+
+int           DHTXXD_read_result (DHTXXD_t *self, DHTXXD_data_t *data);
+
+void          DHTXXD_read_cancel (DHTXXD_t *self);
+
+void          DHTXXD_set_decoder (DHTXXD_t *self, int decoder);
+
+void          DHTXXD_decoder_stats(DHTXXD_t *self, DHTBitCalib *calib);
+
+void          DHTXXD_set_edge_trace(DHTXXD_t *self, FILE *fp);
+
 #endif
 
@@ -0,0 +1,412 @@
+#include "alarm_rules.h"
+#include "trend.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+// 지표 슬롯: 직접 지표 다음에 변화율 슬롯이 온다
+enum { M_TEMPERATURE, M_HUMIDITY, M_DEW_POINT, M_ABS_HUMIDITY, M_HEAT_INDEX, M_FAN, M_STALE, M_DIRECT_COUNT };
+#define RATE_METRICS 5 // 변화율을 구할 수 있는 지표 (temperature ~ heat_index)
+#define RATE_BASE    M_DIRECT_COUNT
+#define SLOT_COUNT   (M_DIRECT_COUNT + RATE_METRICS)
+
+enum { OP_GT, OP_GE, OP_LT, OP_LE, OP_EQ, OP_NE };
+
+#define ACTION_BUZZER 0x1
+#define ACTION_NOTIFY 0x2
+#define ACTION_LCD    0x4
+
+#define ALARM_MAX_PREDICATES (ALARM_MAX_RULES * 4)
+#define ALARM_LINE_LEN 256
+
+typedef struct {
+    uint8_t slot;
+    uint8_t op;
+    float value;
+} AlarmPredicate;
+
+typedef struct {
+    char name[ALARM_NAME_LEN];
+    uint16_t first;       // g_rule_preds 안의 시작 위치
+    uint16_t count;       // AND로 묶인 비교식 수
+    double duration;      // 조건이 계속 참이어야 하는 시간(초)
+    unsigned int actions;
+    char lcd_text[ALARM_LCD_TEXT_LEN];
+    double true_since;    // 조건이 참이 된 시각 (거짓이면 -1)
+    int active;
+} AlarmRule;
+
+static const char *metric_names[M_DIRECT_COUNT] = {
+    "temperature", "humidity", "dew_point", "abs_humidity", "heat_index", "fan", "stale"
+};
+
+// 설정 파일이 없을 때의 기본 규칙 (기존 하드코딩 임계값과 동일한 동작)
+static const char *default_rules[] = {
+    "hot: temperature >= 28 -> buzzer, lcd \"FAN ON NOW!\"",
+    "humid: humidity >= 70 -> buzzer, lcd \"FAN ON NOW!\"",
+};
+
+/* --- 컴파일된 프로그램 --- */
+typedef struct {
+    AlarmPredicate preds[ALARM_MAX_PREDICATES]; // 중복 제거된 비교식
+    int pred_count;
+    uint16_t rule_preds[ALARM_MAX_PREDICATES];  // 규칙별 비교식 인덱스 목록
+    int rule_pred_count;
+    AlarmRule rules[ALARM_MAX_RULES];
+    int rule_count;
+    unsigned int rate_mask;                     // 변화율이 필요한 지표
+} AlarmProgram;
+
+static AlarmProgram g_prog;    // 평가에 쓰는 프로그램
+static AlarmProgram g_staging; // 파일을 컴파일하는 중인 프로그램 (전부 성공해야 g_prog로 교체)
+
+/* --- 실행 상태 --- */
+static float g_slots[SLOT_COUNT];
+static TrendEstimator g_rate_trend[RATE_METRICS];
+static double g_last_sample_time = 0.0;
+static int g_buzzer_active = 0;
+
+/* --- 규칙 해석 --- */
+
+static char *skip_spaces(char *s) {
+    while (*s && isspace((unsigned char)*s)) s++;
+    return s;
+}
+
+static int metric_index(const char *name, size_t len) {
+    for (int i = 0; i < M_DIRECT_COUNT; i++) {
+        if (strlen(metric_names[i]) == len && strncmp(metric_names[i], name, len) == 0) return i;
+    }
+    return -1;
+}
+
+static int intern_predicate(AlarmProgram *prog, int slot, int op, float value) {
+    for (int i = 0; i < prog->pred_count; i++) {
+        if (prog->preds[i].slot == slot && prog->preds[i].op == op && prog->preds[i].value == value) return i;
+    }
+    if (prog->pred_count >= ALARM_MAX_PREDICATES) return -1;
+    prog->preds[prog->pred_count].slot = (uint8_t)slot;
+    prog->preds[prog->pred_count].op = (uint8_t)op;
+    prog->preds[prog->pred_count].value = value;
+    return prog->pred_count++;
+}
+
+// "<metric> <op> <value>" 또는 "rate(<metric>) <op> <value>"
+static int compile_condition(AlarmProgram *prog, char *s) {
+    int slot;
+    s = skip_spaces(s);
+    if (strncmp(s, "rate(", 5) == 0) {
+        char *close = strchr(s, ')');
+        if (close == NULL) return -1;
+        int m = metric_index(s + 5, close - s - 5);
+        if (m < 0 || m >= RATE_METRICS) return -1;
+        slot = RATE_BASE + m;
+        prog->rate_mask |= 1u << m;
+        s = close + 1;
+    } else {
+        size_t len = strcspn(s, " \t<>=!");
+        slot = metric_index(s, len);
+        if (slot < 0) return -1;
+        s += len;
+    }
+
+    s = skip_spaces(s);
+    int op;
+    if (strncmp(s, ">=", 2) == 0) { op = OP_GE; s += 2; }
+    else if (strncmp(s, "<=", 2) == 0) { op = OP_LE; s += 2; }
+    else if (strncmp(s, "==", 2) == 0) { op = OP_EQ; s += 2; }
+    else if (strncmp(s, "!=", 2) == 0) { op = OP_NE; s += 2; }
+    else if (*s == '>') { op = OP_GT; s++; }
+    else if (*s == '<') { op = OP_LT; s++; }
+    else return -1;
+
+    char *end;
+    float value = strtof(s, &end);
+    if (end == s) return -1;
+    end = skip_spaces(end);
+    if (*end == '%') end = skip_spaces(end + 1); // "humidity > 75 %" 허용
+    if (*end != '\0') return -1;
+    return intern_predicate(prog, slot, op, value);
+}
+
+static int parse_duration(const char *s, double *seconds) {
+    char *end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0) return -1;
+    end = skip_spaces(end);
+    if (*end == 's' || *end == '\0') *seconds = v;
+    else if (*end == 'm') *seconds = v * 60.0;
+    else if (*end == 'h') *seconds = v * 3600.0;
+    else return -1;
+    return 0;
+}
+
+static int compile_actions(char *s, AlarmRule *rule) {
+    while (*(s = skip_spaces(s))) {
+        if (strncmp(s, "buzzer", 6) == 0) {
+            rule->actions |= ACTION_BUZZER;
+            s += 6;
+        } else if (strncmp(s, "notify", 6) == 0) {
+            rule->actions |= ACTION_NOTIFY;
+            s += 6;
+        } else if (strncmp(s, "lcd", 3) == 0) {
+            s = skip_spaces(s + 3);
+            if (*s != '"') return -1;
+            char *close = strchr(s + 1, '"');
+            if (close == NULL) return -1;
+            size_t len = close - s - 1;
+            if (len >= ALARM_LCD_TEXT_LEN) len = ALARM_LCD_TEXT_LEN - 1;
+            memcpy(rule->lcd_text, s + 1, len);
+            rule->lcd_text[len] = '\0';
+            rule->actions |= ACTION_LCD;
+            s = close + 1;
+        } else {
+            return -1;
+        }
+        s = skip_spaces(s);
+        if (*s == ',') s++;
+        else if (*s != '\0') return -1;
+    }
+    return rule->actions ? 0 : -1;
+}
+
+static int compile_rule(AlarmProgram *prog, const char *text) {
+    char line[ALARM_LINE_LEN];
+    size_t n = strcspn(text, "\r\n");
+    if (n >= sizeof(line)) return -1;
+    memcpy(line, text, n);
+    line[n] = '\0';
+
+    // 따옴표(LCD 문구) 밖의 '#' 이후는 주석
+    int quoted = 0;
+    for (char *p = line; *p; p++) {
+        if (*p == '"') quoted = !quoted;
+        else if (*p == '#' && !quoted) {
+            *p = '\0';
+            break;
+        }
+    }
+
+    char *s = skip_spaces(line);
+    if (*s == '\0') return 0; // 빈 줄
+    if (prog->rule_count >= ALARM_MAX_RULES) return -1;
+
+    char *colon = strchr(s, ':');
+    char *arrow = strstr(s, "->");
+    if (colon == NULL || arrow == NULL || arrow < colon) return -1;
+
+    AlarmRule *rule = &prog->rules[prog->rule_count];
+    memset(rule, 0, sizeof(*rule));
+    size_t name_len = colon - s;
+    if (name_len == 0 || name_len >= ALARM_NAME_LEN) return -1;
+    memcpy(rule->name, s, name_len);
+    rule->true_since = -1.0;
+
+    *arrow = '\0';
+    char *cond = colon + 1;
+    char *for_kw = strstr(cond, " for ");
+    if (for_kw) {
+        *for_kw = '\0';
+        if (parse_duration(skip_spaces(for_kw + 5), &rule->duration) != 0) return -1;
+    }
+
+    rule->first = (uint16_t)prog->rule_pred_count;
+    while (cond) {
+        char *and_kw = strstr(cond, " and ");
+        if (and_kw) *and_kw = '\0';
+        int p = compile_condition(prog, cond);
+        if (p < 0 || prog->rule_pred_count >= ALARM_MAX_PREDICATES) return -1;
+        prog->rule_preds[prog->rule_pred_count++] = (uint16_t)p;
+        rule->count++;
+        cond = and_kw ? and_kw + 5 : NULL;
+    }
+
+    if (compile_actions(arrow + 2, rule) != 0) return -1;
+    prog->rule_count++;
+    return 1;
+}
+
+static void reset_program(AlarmProgram *prog) {
+    prog->pred_count = 0;
+    prog->rule_pred_count = 0;
+    prog->rule_count = 0;
+    prog->rate_mask = 0;
+}
+
+static void compile_defaults(AlarmProgram *prog) {
+    reset_program(prog);
+    for (size_t i = 0; i < sizeof(default_rules) / sizeof(default_rules[0]); i++) compile_rule(prog, default_rules[i]);
+}
+
+int alarm_rules_load(const char *path, double now) {
+    for (int i = 0; i < RATE_METRICS; i++) trend_init(&g_rate_trend[i]);
+    memset(g_slots, 0, sizeof(g_slots));
+    g_last_sample_time = now;
+    g_buzzer_active = 0;
+
+    FILE *fp = path ? fopen(path, "r") : NULL;
+    if (fp == NULL) {
+        compile_defaults(&g_prog);
+        printf("[Alarm] Using %d built-in rules\n", g_prog.rule_count);
+        return g_prog.rule_count;
+    }
+
+    // 파일 전체가 컴파일되어야 교체 (일부 규칙만 남은 프로그램으로 동작하지 않도록)
+    reset_program(&g_staging);
+    char line[ALARM_LINE_LEN];
+    int line_no = 0, errors = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (compile_rule(&g_staging, line) < 0) {
+            fprintf(stderr, "[Alarm] %s:%d: invalid rule: %s", path, line_no, line);
+            errors++;
+        }
+    }
+    fclose(fp);
+    if (errors) {
+        compile_defaults(&g_prog);
+        fprintf(stderr, "[Alarm] %s rejected (%d invalid rules), using %d built-in rules\n", path, errors,
+                g_prog.rule_count);
+        return -1;
+    }
+    memcpy(&g_prog, &g_staging, sizeof(g_prog));
+    printf("[Alarm] Compiled %d rules (%d distinct conditions) from %s\n", g_prog.rule_count, g_prog.pred_count,
+           path);
+    return g_prog.rule_count;
+}
+
+/* --- 평가 --- */
+
+void alarm_rules_sample(const AlarmSample *sample, double now) {
+    g_slots[M_TEMPERATURE] = sample->temperature;
+    g_slots[M_HUMIDITY] = sample->humidity;
+    g_slots[M_DEW_POINT] = sample->dew_point;
+    g_slots[M_ABS_HUMIDITY] = sample->abs_humidity;
+    g_slots[M_HEAT_INDEX] = sample->heat_index;
+    g_slots[M_FAN] = sample->fan_on ? 1.0f : 0.0f;
+    g_last_sample_time = now;
+
+    // 규칙이 참조하는 지표만 변화율 계산 (분당)
+    for (int m = 0; m < RATE_METRICS; m++) {
+        if (!(g_prog.rate_mask & (1u << m))) continue;
+        double slope;
+        trend_add(&g_rate_trend[m], now, g_slots[m]);
+        g_slots[RATE_BASE + m] = trend_fit(&g_rate_trend[m], now, &slope, NULL) == 0 ? (float)(slope * 60.0) : 0.0f;
+    }
+}
+
+static int compare(float x, int op, float v) {
+    switch (op) {
+    case OP_GT: return x > v;
+    case OP_GE: return x >= v;
+    case OP_LT: return x < v;
+    case OP_LE: return x <= v;
+    case OP_EQ: return x == v;
+    default:    return x != v;
+    }
+}
+
+void alarm_rules_evaluate(double now, AlarmOutput *out) {
+    uint8_t truth[ALARM_MAX_PREDICATES];
+
+    g_slots[M_STALE] = (float)(now - g_last_sample_time);
+
+    // 1) 비교식은 규칙 수와 무관하게 한 번씩만 계산
+    for (int i = 0; i < g_prog.pred_count; i++) {
+        truth[i] = (uint8_t)compare(g_slots[g_prog.preds[i].slot], g_prog.preds[i].op, g_prog.preds[i].value);
+    }
+
+    // 2) 규칙은 인덱스 조회와 AND, 지속 시간 판정만 수행
+    int buzzer_now = 0;
+    out->active_count = 0;
+    out->changed = 0;
+    out->lcd_text = NULL;
+    for (int r = 0; r < g_prog.rule_count; r++) {
+        AlarmRule *rule = &g_prog.rules[r];
+        int all = 1;
+        for (int k = 0; k < rule->count; k++) all &= truth[g_prog.rule_preds[rule->first + k]];
+
+        int active = 0;
+        if (all) {
+            if (rule->true_since < 0.0) rule->true_since = now;
+            active = (now - rule->true_since) >= rule->duration;
+        } else {
+            rule->true_since = -1.0;
+        }
+
+        if (active != rule->active) {
+            rule->active = active;
+            out->changed = 1;
+            if (rule->actions & ACTION_NOTIFY) {
+                if (active) log_warn("[Alarm] %s TRIGGERED", rule->name);
+                else log_info("[Alarm] %s cleared", rule->name);
+            }
+        }
+        if (!active) continue;
+
+        out->active_count++;
+        if (rule->actions & ACTION_BUZZER) buzzer_now = 1;
+        if ((rule->actions & ACTION_LCD) && out->lcd_text == NULL) out->lcd_text = rule->lcd_text;
+    }
+
+    // 버저 규칙이 하나도 없다가 생기는 순간에만 울림 (기존 경고 상태 전환과 동일)
+    out->buzzer = buzzer_now && !g_buzzer_active;
+    g_buzzer_active = buzzer_now;
+}
+
+int alarm_rules_save_active(char *buf, int len) {
+    int used = 0;
+    if (len <= 0) return 0;
+    buf[0] = '\0';
+    for (int r = 0; r < g_prog.rule_count; r++) {
+        if (!g_prog.rules[r].active) continue;
+        int n = snprintf(buf + used, len - used, "%s%s", used ? "," : "", g_prog.rules[r].name);
+        if (n >= len - used) { // 잘린 이름은 지움
+            buf[used] = '\0';
+            break;
+        }
+        used += n;
+    }
+    return used;
+}
+
+void alarm_rules_restore_active(const char *names, double now) {
+    for (int r = 0; r < g_prog.rule_count; r++) {
+        AlarmRule *rule = &g_prog.rules[r];
+        size_t len = strlen(rule->name);
+        for (const char *p = names; *p;) {
+            const char *end = strchr(p, ',');
+            size_t n = end ? (size_t)(end - p) : strlen(p);
+            if (n == len && strncmp(p, rule->name, len) == 0) {
+                rule->active = 1;
+                rule->true_since = now - rule->duration;
+                if (rule->actions & ACTION_BUZZER) g_buzzer_active = 1;
+                break;
+            }
+            p += n;
+            if (*p == ',') p++;
+        }
+    }
+}
+
+int alarm_rules_format_active(char *buf, int len) {
+    if (len < 3) {
+        if (len > 0) buf[0] = '\0';
+        return 0;
+    }
+    int used = 1;
+    buf[0] = '[';
+    for (int r = 0; r < g_prog.rule_count; r++) {
+        if (!g_prog.rules[r].active) continue;
+        // 닫는 괄호와 '\0' 자리를 남겨 두고 다 들어가는 이름만 추가
+        int n = snprintf(buf + used, len - 2 - used, "%s\"%s\"", used > 1 ? "," : "", g_prog.rules[r].name);
+        if (n >= len - 2 - used) break;
+        used += n;
+    }
+    buf[used++] = ']';
+    buf[used] = '\0';
+    return used;
+}
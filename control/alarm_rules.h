@@ -0,0 +1,64 @@
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+// 설정 파일 기반 경고 규칙 엔진
+//
+// 규칙 형식 (한 줄에 하나, '#' 주석):
+//   <name>: <cond> [and <cond> ...] [for <N>s|m|h] -> <action>[, <action> ...]
+//     cond   : <metric> <op> <value> | rate(<metric>) <op> <value> (분당 변화량)
+//     metric : temperature, humidity, dew_point, abs_humidity, heat_index, fan, stale(마지막 판독 후 초)
+//     op     : > >= < <= == !=
+//     action : buzzer | notify | lcd "<16자 이하 문구>"
+//   예) damp: humidity > 75 for 10m -> notify, lcd "DAMP - VENTING"
+//
+// 불러온 규칙은 한 번 컴파일되어 (1) 중복 제거된 비교식 배열과 (2) 규칙별 비교식 인덱스
+// 목록으로 구성된 평탄한 프로그램이 된다. 평가 시 비교식을 한 번씩만 계산하고 규칙은
+// 인덱스만 조회하므로, 같은 조건을 공유하는 규칙이 늘어도 비용이 거의 늘지 않는다.
+// 변화율은 규칙에서 참조하는 지표만 슬라이딩 윈도우 추세로 계산한다.
+// 워커 스레드 전용 (스레드 안전하지 않음).
+
+#define ALARM_MAX_RULES     64
+#define ALARM_LCD_TEXT_LEN  17
+#define ALARM_NAME_LEN      24
+
+// 모든 규칙이 활성일 때의 JSON 배열 길이 (이름마다 따옴표 2개와 ',', 양끝 괄호와 '\0')
+#define ALARM_ACTIVE_JSON_LEN (ALARM_MAX_RULES * (ALARM_NAME_LEN + 2) + 3)
+
+typedef struct {
+    float temperature;
+    float humidity;
+    float dew_point;
+    float abs_humidity;
+    float heat_index;
+    int fan_on;
+} AlarmSample;
+
+typedef struct {
+    int active_count;              // 현재 활성 규칙 수
+    int buzzer;                    // 버저 규칙이 하나도 없다가 활성화된 순간 1
+    int changed;                   // 활성 규칙 집합이 바뀌었으면 1
+    const char *lcd_text;          // 활성 규칙 중 가장 앞선 LCD 문구 (없으면 NULL)
+} AlarmOutput;
+
+// 규칙 파일 컴파일 (path가 NULL이거나 없으면 기본 규칙). 불러온 규칙 수
+// 한 줄이라도 잘못되면 파일 전체를 버리고 기본 규칙으로 동작하며 -1 (잘못된 줄은 stderr에 출력)
+int alarm_rules_load(const char *path, double now);
+
+// 새 판독값 반영 (비교식은 다음 평가 때 계산)
+void alarm_rules_sample(const AlarmSample *sample, double now);
+
+// now 기준으로 규칙 평가 (판독 사이에도 호출하면 stale 및 지속 시간 조건이 갱신됨)
+void alarm_rules_evaluate(double now, AlarmOutput *out);
+
+// 활성 규칙 이름을 JSON 문자열 배열로 기록 (예: ["hot","damp"], 기록한 길이)
+// buf가 ALARM_ACTIVE_JSON_LEN보다 작아 넘치면 마지막으로 다 들어간 이름까지만 넣고 배열은 항상 닫는다
+int alarm_rules_format_active(char *buf, int len);
+
+// 활성 규칙 이름을 ','로 이어 기록 (상태 체크포인트용, 예: hot,damp, 넘치면 다 들어간 이름까지만)
+int alarm_rules_save_active(char *buf, int len);
+
+// 저장해 둔 이름의 규칙을 이미 활성인 상태로 복원 (재시작 직후 같은 경고로 버저가 다시 울리지 않도록)
+// 조건이 계속 참이면 그대로 유지되고, 거짓이면 다음 평가에서 해제된다
+void alarm_rules_restore_active(const char *names, double now);
+
+#endif
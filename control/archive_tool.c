@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "history_archive.h"
+#include "psychrometrics.h"
+
+// 센서 이력 아카이브 도구
+//   archive_tool dump <archive>          : CSV로 출력 (스트리밍)
+//   archive_tool report <archive>        : 일별 요약 (이슬점/절대습도/체감온도 포함, CSV)
+//   archive_tool export <archive> [--from T] [--to T] [--format csv|columnar]
+//                                        : 시간 구간 내보내기 (mmap 스트리밍, 표준출력)
+//   archive_tool bench [samples]         : 압축률, 디코딩 및 파생 지표 처리량 측정
+
+#define RAW_RECORD_SIZE 18 // 고정 폭 레코드 (int64 시각 + float 2개 + 상태 2바이트)
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int dump_archive(const char *path) {
+    ArchiveReader *reader = archive_reader_open(path);
+    if (reader == NULL) return 1;
+
+    ArchiveSample s;
+    int ret;
+    printf("timestamp,temperature,humidity,fan_on,mode\n");
+    while ((ret = archive_reader_next(reader, &s)) == 1) {
+        printf("%lld,%.1f,%.1f,%d,%s\n", (long long)s.timestamp, s.temperature, s.humidity,
+               s.fan_on, s.mode == 0 ? "auto" : "manual");
+    }
+    archive_reader_close(reader);
+    return ret < 0 ? 1 : 0;
+}
+
+// 내보내기 컬럼 파일 (--format columnar)
+//   헤더: "SVCX" 매직, 버전(1), 컬럼 수(5), 예약 2바이트
+//   청크: uint32 샘플 수 n, int64 timestamp[n], float temperature[n], float humidity[n],
+//         uint8 fan_on[n], uint8 mode[n] (아카이브 블록 하나당 청크 하나, 최대 ARCHIVE_BLOCK_SAMPLES)
+//   끝: 샘플 수 0인 청크
+// 값은 호스트 바이트 순서(라즈베리 파이/x86 모두 리틀 엔디언)로 기록되어 numpy.frombuffer 등으로 바로 읽힌다.
+#define EXPORT_MAGIC   "SVCX"
+#define EXPORT_VERSION 1
+#define EXPORT_COLUMNS 5
+
+typedef struct {
+    int64_t timestamp[ARCHIVE_BLOCK_SAMPLES];
+    float temperature[ARCHIVE_BLOCK_SAMPLES];
+    float humidity[ARCHIVE_BLOCK_SAMPLES];
+    uint8_t fan_on[ARCHIVE_BLOCK_SAMPLES];
+    uint8_t mode[ARCHIVE_BLOCK_SAMPLES];
+} ExportChunk;
+
+static void write_chunk(const ExportChunk *c, uint32_t n) {
+    fwrite(&n, sizeof(n), 1, stdout);
+    if (n == 0) return;
+    fwrite(c->timestamp, sizeof(c->timestamp[0]), n, stdout);
+    fwrite(c->temperature, sizeof(c->temperature[0]), n, stdout);
+    fwrite(c->humidity, sizeof(c->humidity[0]), n, stdout);
+    fwrite(c->fan_on, 1, n, stdout);
+    fwrite(c->mode, 1, n, stdout);
+}
+
+// 시각 인자: epoch 초 또는 UTC 날짜/시각 (YYYY-MM-DD, YYYY-MM-DDTHH:MM[:SS])
+static int parse_time_arg(const char *arg, int64_t *out) {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    int n = sscanf(arg, "%d-%d-%dT%d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                   &tm.tm_hour, &tm.tm_min, &tm.tm_sec);
+    if (n >= 3 && strchr(arg, '-') != NULL) {
+        tm.tm_year -= 1900;
+        tm.tm_mon -= 1;
+        *out = (int64_t)timegm(&tm);
+        return 0;
+    }
+    char *end;
+    long long v = strtoll(arg, &end, 10);
+    if (end == arg || *end != '\0') return -1;
+    *out = v;
+    return 0;
+}
+
+static int export_usage() {
+    fprintf(stderr, "[Export] Usage: export <archive> [--from T] [--to T] [--format csv|columnar]\n");
+    return 1;
+}
+
+// 구간 내보내기. 아카이브는 mmap으로 한 블록씩 디코딩하므로 메모리 사용량은 기간과 무관하다.
+// CSV의 event 열은 직전 샘플 대비 팬 상태가 바뀐 행에 fan_on/fan_off를 표시한다.
+static int export_archive(int argc, char *argv[]) {
+    static ArchiveSample samples[ARCHIVE_BLOCK_SAMPLES];
+    static ExportChunk chunk;
+    static char out_buffer[1 << 16];
+    const char *path = argv[0];
+    int64_t from = INT64_MIN, to = INT64_MAX;
+    int columnar = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            if (parse_time_arg(argv[++i], &from) != 0) return export_usage();
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            if (parse_time_arg(argv[++i], &to) != 0) return export_usage();
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "columnar") == 0) columnar = 1;
+            else if (strcmp(argv[i], "csv") != 0) return export_usage();
+        } else {
+            return export_usage();
+        }
+    }
+
+    ArchiveMap *map = archive_map_open(path);
+    if (map == NULL) return 1;
+    setvbuf(stdout, out_buffer, _IOFBF, sizeof(out_buffer));
+
+    if (columnar) {
+        uint8_t header[8] = { EXPORT_MAGIC[0], EXPORT_MAGIC[1], EXPORT_MAGIC[2], EXPORT_MAGIC[3],
+                              EXPORT_VERSION, EXPORT_COLUMNS, 0, 0 };
+        fwrite(header, 1, sizeof(header), stdout);
+    } else {
+        printf("timestamp,temperature,humidity,fan_on,mode,event\n");
+    }
+
+    int count, prev_fan = -1;
+    long exported = 0;
+    while ((count = archive_map_next_block(map, from, to, samples)) > 0) {
+        uint32_t n = 0;
+        for (int i = 0; i < count; i++) {
+            const ArchiveSample *s = &samples[i];
+            if (s->timestamp < from || s->timestamp > to) continue;
+            if (columnar) {
+                chunk.timestamp[n] = s->timestamp;
+                chunk.temperature[n] = s->temperature;
+                chunk.humidity[n] = s->humidity;
+                chunk.fan_on[n] = s->fan_on;
+                chunk.mode[n] = s->mode;
+            } else {
+                const char *event = "";
+                if (prev_fan >= 0 && s->fan_on != prev_fan) event = s->fan_on ? "fan_on" : "fan_off";
+                printf("%lld,%.1f,%.1f,%d,%s,%s\n", (long long)s->timestamp, s->temperature,
+                       s->humidity, s->fan_on, s->mode == 0 ? "auto" : "manual", event);
+            }
+            prev_fan = s->fan_on;
+            n++;
+        }
+        if (columnar && n > 0) write_chunk(&chunk, n);
+        exported += n;
+    }
+    if (columnar) write_chunk(&chunk, 0);
+    archive_map_close(map);
+
+    if (fflush(stdout) != 0 || ferror(stdout)) {
+        fprintf(stderr, "[Export] Output closed early after %ld samples.\n", exported);
+        return 1;
+    }
+    fprintf(stderr, "[Export] %ld samples exported.\n", exported);
+    return count < 0 ? 1 : 0;
+}
+
+// 리포트용 열 단위 버퍼 (파생 지표는 PSYCHRO_BATCH개씩 배치 계산)
+typedef struct {
+    int64_t timestamp[PSYCHRO_BATCH];
+    float temperature[PSYCHRO_BATCH];
+    float humidity[PSYCHRO_BATCH];
+    float dew_point[PSYCHRO_BATCH];
+    float abs_humidity[PSYCHRO_BATCH];
+    float heat_index[PSYCHRO_BATCH];
+    uint8_t fan_on[PSYCHRO_BATCH];
+} ReportBatch;
+
+typedef struct {
+    int64_t day; // epoch 기준 일 번호 (UTC)
+    long count;
+    long fan_on;
+    double temp_sum, humi_sum, dew_sum, ah_sum;
+    float dew_min, dew_max, hi_max;
+} DayStats;
+
+static void print_day(const DayStats *d) {
+    if (d->count == 0) return;
+    time_t t = (time_t)(d->day * 86400);
+    struct tm tm;
+    char date[16];
+    gmtime_r(&t, &tm);
+    strftime(date, sizeof(date), "%Y-%m-%d", &tm);
+    printf("%s,%ld,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", date, d->count,
+           d->temp_sum / d->count, d->humi_sum / d->count,
+           d->dew_min, d->dew_sum / d->count, d->dew_max,
+           d->ah_sum / d->count, d->hi_max, 100.0 * d->fan_on / d->count);
+}
+
+static void accumulate_batch(ReportBatch *b, int n, DayStats *d) {
+    psychro_dew_point_batch(b->temperature, b->humidity, b->dew_point, n);
+    psychro_abs_humidity_batch(b->temperature, b->humidity, b->abs_humidity, n);
+    psychro_heat_index_batch(b->temperature, b->humidity, b->heat_index, n);
+
+    for (int i = 0; i < n; i++) {
+        int64_t day = b->timestamp[i] / 86400;
+        if (day != d->day) {
+            print_day(d);
+            memset(d, 0, sizeof(*d));
+            d->day = day;
+            d->dew_min = d->dew_max = b->dew_point[i];
+            d->hi_max = b->heat_index[i];
+        }
+        d->count++;
+        d->fan_on += b->fan_on[i];
+        d->temp_sum += b->temperature[i];
+        d->humi_sum += b->humidity[i];
+        d->dew_sum += b->dew_point[i];
+        d->ah_sum += b->abs_humidity[i];
+        if (b->dew_point[i] < d->dew_min) d->dew_min = b->dew_point[i];
+        if (b->dew_point[i] > d->dew_max) d->dew_max = b->dew_point[i];
+        if (b->heat_index[i] > d->hi_max) d->hi_max = b->heat_index[i];
+    }
+}
+
+static int report_archive(const char *path) {
+    static ReportBatch batch;
+    ArchiveReader *reader = archive_reader_open(path);
+    if (reader == NULL) return 1;
+
+    DayStats day;
+    memset(&day, 0, sizeof(day));
+    day.day = INT64_MIN;
+
+    ArchiveSample s;
+    int ret, n = 0;
+    printf("date,samples,temp_mean,humi_mean,dew_min,dew_mean,dew_max,abs_humidity_mean,heat_index_max,fan_on_pct\n");
+    while ((ret = archive_reader_next(reader, &s)) == 1) {
+        batch.timestamp[n] = s.timestamp;
+        batch.temperature[n] = s.temperature;
+        batch.humidity[n] = s.humidity;
+        batch.fan_on[n] = s.fan_on;
+        if (++n == PSYCHRO_BATCH) {
+            accumulate_batch(&batch, n, &day);
+            n = 0;
+        }
+    }
+    if (n > 0) accumulate_batch(&batch, n, &day);
+    print_day(&day);
+    archive_reader_close(reader);
+    return ret < 0 ? 1 : 0;
+}
+
+// 1초 간격의 현실적인 센서 데이터 생성
+// quantum: 센서 분해능 (DHT11: 1.0, DHT22: 0.1)
+static void generate_samples(ArchiveSample *samples, long count, float quantum) {
+    int64_t t = 1700000000;
+    for (long i = 0; i < count; i++) {
+        double day = (double)i / 86400.0;
+        double temp = 24.0 + 5.0 * sin(2 * M_PI * day) + 0.3 * sin(i / 37.0);
+        double humi = 55.0 + 15.0 * sin(2 * M_PI * day * 2 + 1.0) + 0.5 * sin(i / 53.0);
+        samples[i].timestamp = t;
+        samples[i].temperature = (float)(floor(temp / quantum + 0.5) * quantum);
+        samples[i].humidity = (float)(floor(humi / quantum + 0.5) * quantum);
+        samples[i].fan_on = (temp >= 28.0 || humi >= 70.0);
+        samples[i].mode = 0;
+        // 가끔 샘플링 지연이 발생
+        t += (i % 97 == 0) ? 2 : 1;
+    }
+}
+
+static int bench_profile(const char *name, long count, float quantum) {
+    ArchiveSample *samples = malloc(count * sizeof(ArchiveSample));
+    ArchiveSample *decoded = malloc(ARCHIVE_BLOCK_SAMPLES * sizeof(ArchiveSample));
+    long nblocks = (count + ARCHIVE_BLOCK_SAMPLES - 1) / ARCHIVE_BLOCK_SAMPLES;
+    uint8_t *encoded = malloc(nblocks * ARCHIVE_BLOCK_MAX_BYTES);
+    size_t *offsets = malloc((nblocks + 1) * sizeof(size_t));
+    if (!samples || !decoded || !encoded || !offsets) {
+        fprintf(stderr, "[Bench] Out of memory.\n");
+        return 1;
+    }
+
+    generate_samples(samples, count, quantum);
+
+    // 인코딩
+    double t0 = wall_seconds();
+    size_t total = 0;
+    for (long b = 0; b < nblocks; b++) {
+        long first = b * ARCHIVE_BLOCK_SAMPLES;
+        int n = (int)((count - first) < ARCHIVE_BLOCK_SAMPLES ? (count - first) : ARCHIVE_BLOCK_SAMPLES);
+        offsets[b] = total;
+        size_t len = archive_encode_block(samples + first, n, encoded + total, ARCHIVE_BLOCK_MAX_BYTES);
+        if (len == 0) {
+            fprintf(stderr, "[Bench] Encoding failed at block %ld.\n", b);
+            return 1;
+        }
+        total += len;
+    }
+    offsets[nblocks] = total;
+    double encode_time = wall_seconds() - t0;
+
+    // 디코딩 (검증 포함)
+    t0 = wall_seconds();
+    long decoded_total = 0;
+    for (long b = 0; b < nblocks; b++) {
+        int n = archive_decode_block(encoded + offsets[b], offsets[b + 1] - offsets[b],
+                                     decoded, ARCHIVE_BLOCK_SAMPLES);
+        if (n < 0) {
+            fprintf(stderr, "[Bench] Decoding failed at block %ld.\n", b);
+            return 1;
+        }
+        const ArchiveSample *orig = samples + b * ARCHIVE_BLOCK_SAMPLES;
+        for (int i = 0; i < n; i++) {
+            if (decoded[i].timestamp != orig[i].timestamp ||
+                decoded[i].temperature != orig[i].temperature ||
+                decoded[i].humidity != orig[i].humidity ||
+                decoded[i].fan_on != orig[i].fan_on || decoded[i].mode != orig[i].mode) {
+                fprintf(stderr, "[Bench] Round-trip mismatch at sample %ld.\n", b * ARCHIVE_BLOCK_SAMPLES + i);
+                return 1;
+            }
+        }
+        decoded_total += n;
+    }
+    double decode_time = wall_seconds() - t0;
+
+    printf("[Bench] %-12s samples=%ld  bytes=%zu  %.3f bytes/sample (raw %d, %.1fx)\n",
+           name, count, total, (double)total / count, RAW_RECORD_SIZE,
+           RAW_RECORD_SIZE * (double)count / total);
+    printf("[Bench] %-12s encode %.1f Msamples/s, decode %.1f Msamples/s\n", name,
+           count / encode_time / 1e6, decoded_total / decode_time / 1e6);
+
+    free(samples);
+    free(decoded);
+    free(encoded);
+    free(offsets);
+    return 0;
+}
+
+// 파생 지표 처리량: libm 스칼라 계산 대비 배치 계산
+static int bench_psychro(long count) {
+    float *temp = malloc(count * sizeof(float));
+    float *humi = malloc(count * sizeof(float));
+    float *out = malloc(count * sizeof(float));
+    if (!temp || !humi || !out) {
+        fprintf(stderr, "[Bench] Out of memory.\n");
+        return 1;
+    }
+    for (long i = 0; i < count; i++) {
+        temp[i] = -10.0f + 50.0f * (float)((i * 7919) % 1000) / 1000.0f;
+        humi[i] = 5.0f + 95.0f * (float)((i * 104729) % 1000) / 1000.0f;
+    }
+
+    // 기준: libm exp/log를 쓰는 스칼라 Magnus 식
+    double t0 = wall_seconds();
+    for (long i = 0; i < count; i++) {
+        float gamma = logf(humi[i] / 100.0f) + 17.62f * temp[i] / (243.12f + temp[i]);
+        out[i] = 243.12f * gamma / (17.62f - gamma);
+    }
+    double scalar_time = wall_seconds() - t0;
+    float *reference = out;
+    out = malloc(count * sizeof(float));
+    if (!out) {
+        fprintf(stderr, "[Bench] Out of memory.\n");
+        return 1;
+    }
+
+    t0 = wall_seconds();
+    for (long i = 0; i < count; i += PSYCHRO_BATCH) {
+        long n = (count - i) < PSYCHRO_BATCH ? (count - i) : PSYCHRO_BATCH;
+        psychro_dew_point_batch(temp + i, humi + i, out + i, n);
+    }
+    double batch_time = wall_seconds() - t0;
+
+    float max_err = 0.0f;
+    for (long i = 0; i < count; i++) {
+        float err = fabsf(out[i] - reference[i]);
+        if (err > max_err) max_err = err;
+    }
+
+    t0 = wall_seconds();
+    for (long i = 0; i < count; i += PSYCHRO_BATCH) {
+        long n = (count - i) < PSYCHRO_BATCH ? (count - i) : PSYCHRO_BATCH;
+        psychro_dew_point_batch(temp + i, humi + i, out + i, n);
+        psychro_abs_humidity_batch(temp + i, humi + i, out + i, n);
+        psychro_heat_index_batch(temp + i, humi + i, out + i, n);
+    }
+    double all_time = wall_seconds() - t0;
+
+    printf("[Bench] Dew point    libm %.1f Msamples/s, batch %.1f Msamples/s (max error %.4f C)\n",
+           count / scalar_time / 1e6, count / batch_time / 1e6, max_err);
+    printf("[Bench] All derived  batch %.1f Msamples/s\n", count / all_time / 1e6);
+
+    free(temp);
+    free(humi);
+    free(out);
+    free(reference);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "dump") == 0) {
+        return dump_archive(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "report") == 0) {
+        return report_archive(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "export") == 0) {
+        return export_archive(argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        long count = argc >= 3 ? atol(argv[2]) : 7L * 86400; // 기본: 1주일치 1Hz 데이터
+        if (count <= 0) count = 86400;
+        if (bench_profile("DHT11 (1.0)", count, 1.0f) != 0) return 1;
+        if (bench_profile("DHT22 (0.1)", count, 0.1f) != 0) return 1;
+        if (bench_psychro(count) != 0) return 1;
+        return 0;
+    }
+
+    fprintf(stderr, "Usage: %s dump <archive> | report <archive> | export <archive> [options] | bench [samples]\n", argv[0]);
+    return 1;
+}
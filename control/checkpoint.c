@@ -0,0 +1,133 @@
+#include "checkpoint.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define CHECKPOINT_MAGIC   0x50435653u // "SVCP"
+#define CHECKPOINT_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t seq;          // 클수록 최신 (0이면 빈 칸)
+    CheckpointState state;
+    uint32_t crc;          // magic부터 state까지의 CRC-32
+    uint32_t reserved;
+} CheckpointSlot;
+
+typedef struct {
+    CheckpointSlot slots[2];
+} CheckpointFile;
+
+static CheckpointFile *g_file = NULL;
+static int g_latest = -1;          // 가장 최근에 기록한 칸 (없으면 -1)
+static uint64_t g_seq = 0;
+static int g_sync_pending = 0;     // 제어 상태가 바뀐 뒤 msync 전 (게시 스레드에서 확인)
+
+static uint32_t crc32(const uint8_t *data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+static uint32_t slot_crc(const CheckpointSlot *slot) {
+    return crc32((const uint8_t *)slot, offsetof(CheckpointSlot, crc));
+}
+
+static int slot_valid(const CheckpointSlot *slot) {
+    return slot->magic == CHECKPOINT_MAGIC && slot->version == CHECKPOINT_VERSION && slot->seq != 0 &&
+           slot->crc == slot_crc(slot);
+}
+
+int checkpoint_open(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+        perror("[Checkpoint] Failed to open checkpoint file");
+        return -1;
+    }
+    if (ftruncate(fd, sizeof(CheckpointFile)) == -1) {
+        perror("[Checkpoint] ftruncate failed");
+        close(fd);
+        return -1;
+    }
+    void *addr = mmap(NULL, sizeof(CheckpointFile), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        perror("[Checkpoint] mmap failed");
+        return -1;
+    }
+    g_file = (CheckpointFile *)addr;
+
+    // 이어서 기록할 순번 (깨진 칸은 다음 저장에서 덮어씀)
+    g_latest = -1;
+    g_seq = 0;
+    for (int i = 0; i < 2; i++) {
+        const CheckpointSlot *slot = &g_file->slots[i];
+        if (slot_valid(slot) && slot->seq > g_seq) {
+            g_seq = slot->seq;
+            g_latest = i;
+        }
+    }
+    return 0;
+}
+
+int checkpoint_load(CheckpointState *out) {
+    if (g_file == NULL || g_latest < 0) return -1;
+    memcpy(out, &g_file->slots[g_latest].state, sizeof(*out));
+    return 0;
+}
+
+int checkpoint_save(const CheckpointState *state) {
+    if (g_file == NULL) return CHECKPOINT_UNCHANGED;
+
+    int result = CHECKPOINT_CONTROL;
+    if (g_latest >= 0) {
+        const CheckpointState *last = &g_file->slots[g_latest].state;
+        if (memcmp(&last->reading_time, &state->reading_time,
+                   sizeof(*state) - offsetof(CheckpointState, reading_time)) == 0) {
+            return CHECKPOINT_UNCHANGED;
+        }
+        if (last->mode == state->mode && last->fan_on == state->fan_on && last->alert == state->alert &&
+            last->fan_duty == state->fan_duty && strcmp(last->alarms, state->alarms) == 0) {
+            result = CHECKPOINT_READING;
+        }
+    }
+
+    // 오래된 칸에 기록하고 CRC는 마지막에 (도중에 중단되면 그 칸만 깨짐)
+    int next = g_latest == 0 ? 1 : 0;
+    CheckpointSlot *slot = &g_file->slots[next];
+    slot->magic = CHECKPOINT_MAGIC;
+    slot->version = CHECKPOINT_VERSION;
+    slot->seq = ++g_seq;
+    memcpy(&slot->state, state, sizeof(*state));
+    slot->reserved = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->crc = slot_crc(slot);
+    g_latest = next;
+
+    if (result == CHECKPOINT_CONTROL) __atomic_store_n(&g_sync_pending, 1, __ATOMIC_RELEASE);
+    return result;
+}
+
+int checkpoint_sync() {
+    if (g_file == NULL || !__atomic_exchange_n(&g_sync_pending, 0, __ATOMIC_ACQ_REL)) return 0;
+    if (msync(g_file, sizeof(CheckpointFile), MS_SYNC) == -1) {
+        perror("[Checkpoint] msync failed");
+        return 0;
+    }
+    return 1;
+}
+
+void checkpoint_close() {
+    if (g_file == NULL) return;
+    msync(g_file, sizeof(CheckpointFile), MS_SYNC);
+    munmap(g_file, sizeof(CheckpointFile));
+    g_file = NULL;
+    g_latest = -1;
+}
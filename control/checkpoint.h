@@ -0,0 +1,50 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+
+// 재시작 후 이어서 동작하기 위한 제어 상태 체크포인트 (메모리 매핑 파일)
+//
+// 파일에는 같은 크기의 칸 두 개가 있고, 저장할 때마다 오래된 쪽 칸에 순번과 CRC를 붙여 기록한다.
+// 기록 도중 프로세스가 죽거나 전원이 나가 한 칸이 깨져도 다른 칸의 직전 상태로 복원된다.
+// 매핑 영역에 쓰면 바로 페이지 캐시에 남으므로 프로세스 비정상 종료에는 저장 즉시 안전하고,
+// 전원 차단에 대비한 디스크 반영(msync)은 checkpoint_sync로 따로 하여 제어 스레드가 저장 장치를 기다리지 않는다.
+
+#define CHECKPOINT_ALARMS_LEN 128
+
+typedef struct {
+    double saved_at;        // 저장 시각 (epoch, 변경 비교에서 제외)
+    double reading_time;    // 마지막 정상 판독 시각 (0이면 없음)
+    float temperature;      // 마지막 정상 판독값
+    float humidity;
+    float fan_duty;         // 0이면 꺼짐
+    uint8_t mode;           // SystemMode
+    uint8_t fan_on;
+    uint8_t alert;
+    uint8_t reserved;
+    char alarms[CHECKPOINT_ALARMS_LEN]; // 활성 경고 규칙 이름 (',' 구분)
+} CheckpointState;
+
+// checkpoint_save 반환값
+enum {
+    CHECKPOINT_UNCHANGED = 0,
+    CHECKPOINT_READING,  // 판독값만 바뀜 (디스크 반영은 커널 writeback에 맡김)
+    CHECKPOINT_CONTROL,  // 모드/팬/경고 상태가 바뀜 (다음 checkpoint_sync에서 디스크에 반영)
+};
+
+// 파일 열기 (없으면 만듦). 실패 시 -1이며 이후 저장은 무시됨
+int checkpoint_open(const char *path);
+
+// 가장 최근의 온전한 상태 (없거나 두 칸 모두 깨졌으면 -1)
+int checkpoint_load(CheckpointState *out);
+
+// 이전 저장과 다르면 기록 (여러 스레드에서 호출 시 호출자가 직렬화)
+int checkpoint_save(const CheckpointState *state);
+
+// 제어 상태 변경 이후 디스크에 반영하지 않은 기록이 있으면 msync (반영했으면 1, 다른 스레드에서 호출 가능)
+int checkpoint_sync();
+
+// 남은 기록을 반영하고 매핑 해제
+void checkpoint_close();
+
+#endif
@@ -0,0 +1,132 @@
+#include "clock_source.h"
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <stdio.h>
+
+#define CLOCK_MAX_SLEEPERS 16
+
+static int virtual_mode = 0;
+static double virtual_now = 0.0;
+
+static pthread_mutex_t clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clock_cond = PTHREAD_COND_INITIALIZER;
+
+static int participants = 0; // 등록된 참여 스레드 수
+static int sleepers = 0;     // 현재 가상 대기 중인 스레드 수
+static double deadlines[CLOCK_MAX_SLEEPERS];
+static int slot_used[CLOCK_MAX_SLEEPERS];
+
+static double real_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double real_monotonic() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void real_sleep(double seconds) {
+    struct timespec req, rem;
+    if (seconds <= 0.0) return;
+    req.tv_sec = (time_t)seconds;
+    req.tv_nsec = (long)((seconds - req.tv_sec) * 1e9);
+    // 시그널로 깨어나도 남은 시간만큼 다시 대기
+    while (nanosleep(&req, &rem) == -1 && errno == EINTR) {
+        req = rem;
+    }
+}
+
+// 모든 참여자가 잠들어 있으면 가장 가까운 마감 시각으로 시간을 진행 (clock_mutex 보유 상태에서 호출)
+static void advance_if_idle() {
+    if (sleepers < participants) return;
+
+    double next = -1.0;
+    for (int i = 0; i < CLOCK_MAX_SLEEPERS; i++) {
+        if (slot_used[i] && (next < 0.0 || deadlines[i] < next)) next = deadlines[i];
+    }
+    // 이미 마감된 스레드가 아직 깨어나지 않았다면 시간을 진행하지 않음
+    if (next > virtual_now) {
+        virtual_now = next;
+        pthread_cond_broadcast(&clock_cond);
+    }
+}
+
+static void virtual_sleep(double seconds) {
+    pthread_mutex_lock(&clock_mutex);
+
+    int slot = -1;
+    for (int i = 0; i < CLOCK_MAX_SLEEPERS; i++) {
+        if (!slot_used[i]) { slot = i; break; }
+    }
+    if (slot < 0) {
+        // 슬롯이 부족한 경우 시간만 진행 (발생하지 않아야 함)
+        fprintf(stderr, "[Clock] Too many virtual sleepers.\n");
+        virtual_now += seconds;
+        pthread_cond_broadcast(&clock_cond);
+        pthread_mutex_unlock(&clock_mutex);
+        return;
+    }
+
+    double deadline = virtual_now + (seconds > 0.0 ? seconds : 0.0);
+    slot_used[slot] = 1;
+    deadlines[slot] = deadline;
+    sleepers++;
+
+    while (virtual_now < deadline) {
+        advance_if_idle();
+        if (virtual_now >= deadline) break;
+        pthread_cond_wait(&clock_cond, &clock_mutex);
+    }
+
+    slot_used[slot] = 0;
+    sleepers--;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+double clock_now() {
+    if (!virtual_mode) return real_now();
+
+    pthread_mutex_lock(&clock_mutex);
+    double now = virtual_now;
+    pthread_mutex_unlock(&clock_mutex);
+    return now;
+}
+
+double clock_monotonic() {
+    if (!virtual_mode) return real_monotonic();
+    return clock_now();
+}
+
+void clock_sleep(double seconds) {
+    if (virtual_mode) virtual_sleep(seconds);
+    else real_sleep(seconds);
+}
+
+void clock_use_virtual(double start_time) {
+    pthread_mutex_lock(&clock_mutex);
+    virtual_now = start_time;
+    virtual_mode = 1;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+int clock_is_virtual() {
+    return virtual_mode;
+}
+
+void clock_register_thread() {
+    pthread_mutex_lock(&clock_mutex);
+    participants++;
+    pthread_mutex_unlock(&clock_mutex);
+}
+
+void clock_unregister_thread() {
+    pthread_mutex_lock(&clock_mutex);
+    if (participants > 0) participants--;
+    // 남은 참여자가 모두 대기 중일 수 있으므로 다시 확인하도록 깨움
+    pthread_cond_broadcast(&clock_cond);
+    pthread_mutex_unlock(&clock_mutex);
+}
@@ -0,0 +1,21 @@
+#ifndef CLOCK_SOURCE_H
+#define CLOCK_SOURCE_H
+
+// 모든 시간 측정/대기는 이 인터페이스를 거친다.
+// 실제 모드: 타임스탬프/달력 계산은 벽시계(CLOCK_REALTIME), 대기 기한과 경과 시간은
+//           CLOCK_MONOTONIC, 대기는 nanosleep 사용 (NTP가 벽시계를 되돌려도 루프가 멈추지 않음)
+// 가상 모드: 대기 중인 모든 참여 스레드가 잠들면 다음 마감 시각으로 즉시 점프
+//           (기록된 센서 데이터로 하루치 제어 루프를 1초 이내에 시뮬레이션)
+
+double clock_now(); // 현재 시각(초, epoch 기준)
+double clock_monotonic(); // 대기 기한/경과 시간용 시각 (초, 기준점 임의, 가상 모드에서는 clock_now와 같음)
+void clock_sleep(double seconds); // 지정한 시간만큼 대기
+void clock_use_virtual(double start_time); // 가상 시계로 전환 (start_time부터 시작)
+int clock_is_virtual(); // 가상 시계 사용 여부
+
+// 가상 모드에서 시간을 진행시키려면 clock_sleep을 호출하는 모든 스레드가 참여자로 등록되어야 함
+// (등록된 참여자가 없으면 clock_sleep을 호출한 스레드가 곧바로 시간을 진행시킴)
+void clock_register_thread();
+void clock_unregister_thread();
+
+#endif
@@ -1,237 +1,1036 @@
+#define _GNU_SOURCE // ppoll
 #include "control_logic.h"
-#include "gui.h"
+#include "shared_data.h"
 #include "dht11_driver.h"
 #include "motor_driver.h"
 #include "lcd_driver.h"
 #include "buzzer_driver.h"
+#include "clock_source.h"
+#include "history_archive.h"
+#include "telemetry.h"
+#include "status_snapshot.h"
+#include "rt_sched.h"
+#include "psychrometrics.h"
+#include "trend.h"
+#include "schedule.h"
+#include "alarm_rules.h"
+#include "logger.h"
+#include "energy.h"
+#include "pipeline.h"
+#include "fan_policy.h"
+#include "runtime_config.h"
+#include "checkpoint.h"
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
-#include <sys/select.h>
+#include <string.h>
+#include <stddef.h>
+#include <math.h>
+#include <poll.h>
+#include <time.h>
 
 #define FIFO_PATH "/tmp/smart_vent_fifo" // Flask와 통신할 파이프 경로
 #define STATUS_FILE_PATH "/tmp/smart_vent_status.json" // 웹 통신용 상태 파일
+#define PIPELINE_STATS_PATH "/tmp/smart_vent_pipeline.json" // 단계별 처리 시간 (주기 보고 때만 갱신)
+#define HISTORY_ARCHIVE_PATH "/var/lib/smart_vent/history.sva" // 센서 이력 압축 아카이브
+#define SCHEDULE_FILE_PATH "/var/lib/smart_vent/schedule.conf" // 시간대별 운전 스케줄
+#define SCHEDULE_ZONE 0 // 이 제어기가 담당하는 스케줄 구역
+#define ALARM_RULES_PATH "/etc/smart_vent/alarms.conf" // LCD/버저 경고 규칙
+#define ENERGY_LEDGER_PATH "/var/lib/smart_vent/energy.ledger" // 팬 가동 시간/전력량 집계
+#define CHECKPOINT_FILE_PATH "/var/lib/smart_vent/state.ckpt" // 재시작 시 이어갈 제어 상태
+#define CHECKPOINT_MAX_READING_AGE 600 // 이보다 오래된 판독값은 재시작 후 쓰지 않음(초)
 
-// 새롭게 정의된 임계값
-#define TEMPERATURE_THRESHOLD 28.0f
-#define HUMIDITY_THRESHOLD    70.0f
+// PWM 팬 속도 제어: 임계값을 넘은 정도에 비례해 최저 속도에서 최대 속도까지
+#define FAN_DUTY_MIN          0.30f // 이보다 낮으면 팬이 멈출 수 있음 (선행 가동/강제 환기도 이 속도)
+#define FAN_FULL_TEMP_EXCESS  4.0f  // 온도 임계값보다 이만큼(C) 높으면 최대 속도
+#define FAN_FULL_HUMI_EXCESS  15.0f // 습도 임계값보다 이만큼(%) 높으면 최대 속도
+#define FAN_FULL_DEW_EXCESS   4.0f  // 이슬점 임계값보다 이만큼(C) 높으면 최대 속도
+#define FAN_RAMP_PER_SECOND   0.02f // 초당 최대 듀티 변화 (최저->최대 약 35초)
 
-// LCD 및 버저 경고 임계값
-#define WARNING_TEMP_THRESHOLD 28.0f
-#define WARNING_HUMI_THRESHOLD 70.0f
+// 판독값 검증/필터 (센서가 낼 수 없는 값은 버리고, 한 주기에 이보다 크게 튀면 다음 판독으로 확인)
+#define SENSOR_TEMP_MIN       -40.0f
+#define SENSOR_TEMP_MAX       80.0f
+#define FILTER_MAX_TEMP_STEP  5.0f
+#define FILTER_MAX_HUMI_STEP  20.0f
 
-#define READ_INTERVAL_SECONDS 3
+#define TIMING_REPORT_INTERVAL 600 // 타이밍/센서 통계 출력 주기(초)
+#define BUZZER_ALERT_SECONDS   5.0 // 경고 시 버저를 울리는 시간(초)
 
-// 현재 상태를 JSON 파일로 쓰는 함수
-static void write_status_to_file(SharedData *data) {
-    FILE *fp = fopen(STATUS_FILE_PATH, "w");
+// 게시 대상 (SampleRecord.publish)
+#define PUBLISH_LCD       0x01
+#define PUBLISH_STATUS    0x02
+#define PUBLISH_ARCHIVE   0x04
+#define PUBLISH_TELEMETRY 0x08
+#define PUBLISH_CHECKPOINT 0x10
+
+// 파이프라인 레코드: 루프 한 번(판독, 스케줄/경고 변화) 또는 원격 명령 한 건의 처리 결과
+// 제어 단계가 차례로 채우고, 게시 단계는 링에 복사된 레코드만 보고 출력한다.
+typedef struct {
+    double time;               // 처리 시작 시각 (clock_now)
+    bool has_sample;           // 새 판독값 (검증/필터에서 버려지면 false)
+    bool schedule_changed;     // 스케줄 구간 또는 설정 변경 (판독이 없어도 팬 판단)
+    float temperature;
+    float humidity;
+    PsychroValues derived;
+    float threshold_eta;
+    bool prestart;
+    // decide
+    SystemMode mode;           // 판단 시점의 모드 (구동 전에 바뀌었으면 판단을 버림)
+    bool fan_decided;          // 자동 팬 판단 결과가 있음
+    bool fan_on;
+    float fan_duty;
+    bool alert;
+    bool alarm_changed;
+    bool buzzer;
+    bool checkpoint_changed;   // 모드/팬/경고 상태 체크포인트가 바뀜 (게시 스레드에서 디스크에 반영)
+    char lcd_text[ALARM_LCD_TEXT_LEN]; // 빈 문자열이면 기본 화면
+    // publish
+    unsigned publish;          // PUBLISH_* 조합
+    bool schedule_vent;
+    bool quiet;
+    uint32_t samples;
+    uint32_t remote_commands;
+    char alarms[ALARM_ACTIVE_JSON_LEN]; // 활성 경고 규칙 JSON 배열 (이후 필드는 루프마다 초기화하지 않음)
+    char energy[1536];         // 팬 전력량 집계 JSON 객체
+} SampleRecord;
+
+// 원격 제어 FIFO 및 상태 파일 경로 (NULL이면 해당 기능 비활성화)
+static const char *g_fifo_path = FIFO_PATH;
+static const char *g_status_path = STATUS_FILE_PATH;
+static const char *g_pipeline_stats_path = PIPELINE_STATS_PATH;
+static const char *g_archive_path = HISTORY_ARCHIVE_PATH;
+static const char *g_schedule_path = SCHEDULE_FILE_PATH;
+static const char *g_alarm_rules_path = ALARM_RULES_PATH;
+static const char *g_energy_path = ENERGY_LEDGER_PATH;
+static double g_fan_watts = FAN_RATED_WATTS;
+
+// 현재 구역의 스케줄 효과 (워커 스레드에서 갱신)
+static ScheduleEffect g_schedule;
+
+// 센서 이력 기록기 (워커 스레드에서만 사용)
+static ArchiveWriter *g_archive = NULL;
+
+// 텔레메트리 전송 대상 (NULL이면 전송하지 않음)
+static const char *g_telemetry_host = TELEMETRY_DEFAULT_GROUP;
+static int g_telemetry_port = TELEMETRY_DEFAULT_PORT;
+
+// 텔레메트리로 보고하는 제어 카운터
+static uint32_t g_sample_count = 0;
+static uint32_t g_remote_command_count = 0;
+
+// 마지막 센서 값 처리 시각 (스냅샷 게시용)
+static double g_last_reading_time = 0.0;
+
+// 시작 시 체크포인트에서 복원한 상태 (워커 시작 시 경고/필터 상태를 이어감)
+static CheckpointState g_restored;
+static bool g_state_restored = false;
+
+// 워커 시작 시각 (통계용)
+static double g_worker_start_time = 0.0;
+
+// 마지막 타이밍 보고 시각과 그때까지의 판독 수 (종료 시 같은 보고를 반복하지 않도록)
+static double g_last_report_time = 0.0;
+static uint32_t g_last_report_samples = 0;
+
+// 적용 중인 설정 (판독 주기, 자동 팬 판단), 워커 루프의 안전한 지점에서만 교체
+static const RuntimeConfig *g_config = NULL;
+
+// 마지막 팬 듀티 갱신 시각 (속도 변화율 제한용)
+static double g_duty_updated = 0.0;
+
+// 샘플 처리 파이프라인 (제어 단계는 워커 스레드, 게시 단계는 게시 스레드)
+static SharedData *g_data = NULL;
+static Pipeline g_control_pipeline;
+static Pipeline g_publish_pipeline;
+static PipelineRing g_publish_ring;
+static SampleRecord g_publish_slots[PIPELINE_RING_SIZE];
+static SampleRecord g_record; // 제어 단계가 채우는 레코드 (루프마다 재사용)
+
+// 울리고 있는 버저를 끌 시각 (clock_monotonic 기준, 0이면 꺼져 있음, 워커 루프의 대기 기한에 포함)
+static double g_buzzer_off_at = 0.0;
+
+// 검증/필터/파생 단계가 판독마다 갱신하는 상태 (워커 스레드에서만 사용)
+// 한 구조체에 모아 두어 단계별 벤치마크가 복사해 두었다가 되돌릴 수 있다
+typedef struct {
+    bool filter_primed;
+    bool filter_held;
+    float filter_temperature;
+    float filter_humidity;
+    float held_temperature;       // 보류 중인 급변 판독값
+    float held_humidity;
+    uint32_t rejected_samples;
+    TrendEstimator temp_trend;    // 자동 모드 선행 가동용 온도/습도 추세
+    TrendEstimator humi_trend;
+    FanPolicyState policy_state;  // 자동 팬 판단 상태 (설정이 바뀌어도 유지)
+} StageState;
+
+static StageState g_stage;
+
+// 텔레메트리 프레임 (게시 스레드에서만 사용)
+static TelemetryFrame g_frame;
+static uint32_t g_telemetry_seq = 0;
+static bool g_telemetry_enabled = false;
+
+// deadline(clock_monotonic 기준)까지 FIFO 명령, 센서 판독 완료 또는 설정 파일 변경을 기다림
+// 시간 초과로 깨어난 경우 예정 시각보다 얼마나 늦었는지 기록
+static void wait_for_events(int fifo_fd, int sensor_fd, int config_fd, double deadline,
+                            bool *fifo_ready, bool *sensor_ready, bool *config_ready) {
+    struct pollfd fds[3] = { { fifo_fd, POLLIN, 0 }, { sensor_fd, POLLIN, 0 }, { config_fd, POLLIN, 0 } }; // fd가 -1이면 무시됨
+    struct timespec timeout = { 0, 0 };
+    double now = clock_monotonic();
+
+    *fifo_ready = false;
+    *sensor_ready = false;
+    *config_ready = false;
+
+    // 가상 시계에서는 실제로 기다리지 않고 준비된 이벤트만 확인
+    if (!clock_is_virtual() && deadline > now) {
+        double wait = deadline - now;
+        timeout.tv_sec = (time_t)wait;
+        timeout.tv_nsec = (long)((wait - timeout.tv_sec) * 1e9);
+    }
+
+    int ret = ppoll(fds, 3, &timeout, NULL);
+    if (ret > 0) {
+        *fifo_ready = (fds[0].revents & (POLLIN | POLLHUP)) != 0;
+        *sensor_ready = (fds[1].revents & POLLIN) != 0;
+        *config_ready = (fds[2].revents & POLLIN) != 0;
+        return;
+    }
+    if (ret < 0) return; // 시그널 등으로 중단된 경우 다음 루프에서 다시 대기
+
+    if (clock_is_virtual() && deadline > now) clock_sleep(deadline - now);
+    rt_stats_record_wakeup(clock_monotonic() - deadline);
+}
+
+// 단계별 실행 횟수/처리 시간을 별도 파일로 게시
+// (상태 파일에 넣으면 판독마다 내용이 바뀌어 웹 서버의 ETag/long-poll이 매번 변경으로 응답함)
+static void write_pipeline_stats() {
+    if (g_pipeline_stats_path == NULL) return;
+    FILE *fp = fopen(g_pipeline_stats_path, "w");
+    if (fp == NULL) {
+        log_error("[Error] Failed to open pipeline stats file: %s", strerror(errno));
+        return;
+    }
+    char control_stages[768], publish_stages[512];
+    pipeline_format_json(&g_control_pipeline, control_stages, sizeof(control_stages));
+    pipeline_format_json(&g_publish_pipeline, publish_stages, sizeof(publish_stages));
+    fprintf(fp, "{\"control\": {%s}, \"publish\": {%s}, \"rejected\": %u, \"dropped\": %llu, \"max_backlog\": %llu}",
+            control_stages, publish_stages, g_stage.rejected_samples,
+            (unsigned long long)g_publish_ring.dropped, (unsigned long long)g_publish_ring.max_depth);
+    fclose(fp);
+}
+
+static void print_timing_report() {
+    unsigned int counts[4];
+    dht11_get_status_counts(counts);
+    rt_stats_report(stdout, counts, clock_monotonic() - g_worker_start_time);
+    pipeline_report(&g_control_pipeline, stdout);
+    pipeline_report(&g_publish_pipeline, stdout);
+    printf("[Pipeline] Rejected readings: %u, publish backlog max %llu, dropped %llu\n", g_stage.rejected_samples,
+           (unsigned long long)g_publish_ring.max_depth, (unsigned long long)g_publish_ring.dropped);
+    write_pipeline_stats();
+    g_last_report_time = clock_monotonic();
+    g_last_report_samples = g_sample_count;
+}
+
+// 외부 인터페이스용 상태 스냅샷 게시 (data->mutex 보유 상태에서 호출)
+static void publish_snapshot(SharedData *data) {
+    StatusSnapshot snapshot;
+    snapshot.temperature = data->temperature;
+    snapshot.humidity = data->humidity;
+    snapshot.fan_on = data->is_running ? 1 : 0;
+    snapshot.fan_duty = (uint8_t)(data->fan_duty * 100.0f + 0.5f);
+    snapshot.mode = (uint8_t)data->mode;
+    snapshot.alert = data->is_alert_active ? 1 : 0;
+    snapshot.reading_time = g_last_reading_time;
+    EnergyBucket today;
+    energy_get(ENERGY_DAY, 0, &today);
+    snapshot.fan_on_today_s = (uint32_t)(today.on_seconds[0] + today.on_seconds[1]);
+    snapshot.energy_today_wh = (float)(today.energy_wh[0] + today.energy_wh[1]);
+    snapshot_publish(&snapshot);
+}
+
+// 재시작용 상태 체크포인트 갱신 (data->mutex 보유 상태에서 호출, 바뀐 경우에만 기록)
+static int save_checkpoint(const SharedData *data) {
+    CheckpointState state;
+    memset(&state, 0, sizeof(state)); // 변경 비교가 바이트 단위이므로 문자열 뒤까지 초기화
+    state.saved_at = clock_now();
+    state.reading_time = g_last_reading_time;
+    state.temperature = data->temperature;
+    state.humidity = data->humidity;
+    state.fan_duty = data->is_running ? data->fan_duty : 0.0f;
+    state.mode = (uint8_t)data->mode;
+    state.fan_on = data->is_running ? 1 : 0;
+    state.alert = data->is_alert_active ? 1 : 0;
+    alarm_rules_save_active(state.alarms, sizeof(state.alarms));
+    return checkpoint_save(&state);
+}
+
+int control_restore_state(SharedData *data) {
+    if (checkpoint_open(CHECKPOINT_FILE_PATH) != 0) return 0;
+    CheckpointState state;
+    if (checkpoint_load(&state) != 0) {
+        printf("[Checkpoint] No saved state in %s, starting fresh.\n", CHECKPOINT_FILE_PATH);
+        return 0;
+    }
+
+    double now = clock_now();
+    data->mode = state.mode == MANUAL ? MANUAL : AUTOMATIC;
+    data->is_running = state.fan_on != 0;
+    data->fan_duty = data->is_running ? state.fan_duty : 0.0f;
+    data->is_alert_active = state.alert != 0;
+    // 새 판독이 올 때까지 마지막 판독값으로 표시/판단 (너무 오래됐으면 버림)
+    if (state.reading_time > 0.0 && now - state.reading_time <= CHECKPOINT_MAX_READING_AGE) {
+        data->temperature = state.temperature;
+        data->humidity = state.humidity;
+        psychro_compute(state.temperature, state.humidity, &data->derived);
+        g_last_reading_time = state.reading_time;
+    } else {
+        state.reading_time = 0.0;
+    }
+    g_restored = state;
+    g_state_restored = true;
+    printf("[Checkpoint] Restored %s mode, fan %s, saved %.0f s ago%s\n",
+           data->mode == AUTOMATIC ? "auto" : "manual", data->is_running ? "ON" : "OFF", now - state.saved_at,
+           state.reading_time > 0.0 ? "" : " (reading too old, waiting for sensor)");
+    return 1;
+}
+
+// 복원한 체크포인트로 경고 규칙과 판독 필터 상태를 이어감 (워커 시작 시, 경고 규칙을 불러온 뒤)
+static void resume_from_checkpoint(SharedData *data, double now) {
+    if (g_restored.reading_time > 0.0) {
+        pthread_mutex_lock(&data->mutex);
+        AlarmSample sample = {
+            .temperature = data->temperature,
+            .humidity = data->humidity,
+            .dew_point = data->derived.dew_point,
+            .abs_humidity = data->derived.abs_humidity,
+            .heat_index = data->derived.heat_index,
+            .fan_on = data->is_running ? 1 : 0,
+        };
+        pthread_mutex_unlock(&data->mutex);
+        alarm_rules_sample(&sample, g_restored.reading_time);
+        g_stage.filter_primed = true;
+        g_stage.filter_temperature = sample.temperature;
+        g_stage.filter_humidity = sample.humidity;
+    }
+    alarm_rules_restore_active(g_restored.alarms, now);
+}
+
+void control_set_io_paths(const char *fifo_path, const char *status_path) {
+    g_fifo_path = fifo_path;
+    g_status_path = status_path;
+}
+
+void control_set_pipeline_stats_path(const char *stats_path) {
+    g_pipeline_stats_path = stats_path;
+}
+
+void control_set_archive_path(const char *archive_path) {
+    g_archive_path = archive_path;
+}
+
+void control_set_schedule_path(const char *schedule_path) {
+    g_schedule_path = schedule_path;
+}
+
+void control_set_alarm_rules_path(const char *rules_path) {
+    g_alarm_rules_path = rules_path;
+}
+
+// 자동 팬 판단 설정 (스케줄의 구간별 임계값이 있으면 우선)
+static FanPolicy auto_policy() {
+    FanPolicy policy = g_config->policy;
+    if (g_schedule.has_thresholds) {
+        policy.temperature_threshold = g_schedule.temperature_threshold;
+        policy.humidity_threshold = g_schedule.humidity_threshold;
+    }
+    return policy;
+}
+
+void control_set_energy_path(const char *ledger_path) {
+    g_energy_path = ledger_path;
+}
+
+void control_set_fan_watts(double fan_watts) {
+    g_fan_watts = fan_watts;
+}
+
+void control_set_telemetry(const char *host, int port) {
+    g_telemetry_host = host;
+    g_telemetry_port = port;
+}
+
+// 아카이브에 남은 샘플을 기록하고 닫음 (워커 스레드 종료 후 호출)
+void control_logic_cleanup() {
+    // 주기 보고 이후 새 판독이 없으면 직전 보고와 같으므로 생략
+    if (g_worker_start_time > 0.0 &&
+        (g_last_report_time == g_worker_start_time || g_sample_count != g_last_report_samples)) {
+        print_timing_report();
+    }
+    if (energy_close(clock_now()) == 0) {
+        EnergyBucket total;
+        energy_get(ENERGY_TOTAL, 0, &total);
+        printf("[Energy] Fan on %.1f h, %u toggles, %.1f Wh (auto %.1f Wh, manual %.1f Wh)\n",
+               (total.on_seconds[0] + total.on_seconds[1]) / 3600.0, total.toggles[0] + total.toggles[1],
+               total.energy_wh[0] + total.energy_wh[1], total.energy_wh[0], total.energy_wh[1]);
+    }
+    if (g_archive) {
+        archive_writer_close(g_archive);
+        g_archive = NULL;
+        printf("[Logic] History archive closed.\n");
+    }
+    telemetry_sender_close();
+    schedule_cleanup();
+    checkpoint_close();
+}
+
+// 추세로부터 온도/습도 임계값 도달 예상 시간과 선행 가동 여부를 계산
+static void update_prediction(SampleRecord *rec) {
+    FanPolicyInput in;
+    in.time = rec->time;
+    in.trend_valid = 0;
+    trend_add(&g_stage.temp_trend, in.time, rec->temperature);
+    trend_add(&g_stage.humi_trend, in.time, rec->humidity);
+    if (trend_fit(&g_stage.temp_trend, in.time, &in.temp_slope, &in.temp_value) == 0) in.trend_valid |= 1;
+    if (trend_fit(&g_stage.humi_trend, in.time, &in.humi_slope, &in.humi_value) == 0) in.trend_valid |= 2;
+
+    FanPolicy policy = auto_policy();
+    double eta;
+    rec->prestart = fan_policy_predict(&policy, &g_stage.policy_state, &in, &eta) != 0;
+    rec->threshold_eta = (float)eta;
+}
+
+// 게시 단계용 상태 필드 채우기 및 스냅샷 게시 (data->mutex 보유 상태에서 호출)
+static void fill_status(SharedData *data, SampleRecord *rec) {
+    rec->temperature = data->temperature;
+    rec->humidity = data->humidity;
+    rec->derived = data->derived;
+    rec->threshold_eta = data->threshold_eta;
+    rec->prestart = data->fan_prestart;
+    rec->mode = data->mode;
+    rec->fan_on = data->is_running;
+    rec->fan_duty = data->fan_duty;
+    rec->alert = data->is_alert_active;
+    rec->schedule_vent = g_schedule.force_vent;
+    rec->quiet = g_schedule.quiet;
+    rec->samples = g_sample_count;
+    rec->remote_commands = g_remote_command_count;
+    alarm_rules_format_active(rec->alarms, sizeof(rec->alarms));
+    energy_format_json(rec->energy, sizeof(rec->energy));
+    publish_snapshot(data);
+}
+
+// 현재 상태를 JSON 파일로 쓰는 함수 (게시 스레드)
+static void write_status_to_file(const SampleRecord *rec) {
+    FILE *fp = fopen(g_status_path, "w");
     if (fp == NULL) {
         perror("[Error] Failed to open status file");
         return;
     }
     // "auto" 또는 "manual" 문자열 결정
-    const char* mode_str = (data->mode == AUTOMATIC) ? "auto" : "manual";
-    // JSON 형식으로 파일에 씀
-    fprintf(fp, "{\"temperature\": %.1f, \"humidity\": %.1f, \"fan_on\": %s, \"mode\": \"%s\"}",
-            data->temperature,
-            data->humidity,
-            data->is_running ? "true" : "false",
-            mode_str);
+    const char* mode_str = (rec->mode == AUTOMATIC) ? "auto" : "manual";
+    // JSON 형식으로 파일에 씀 (판독값/제어 상태가 같으면 내용도 같아야 웹 서버의 ETag가 유지됨)
+    fprintf(fp, "{\"temperature\": %.1f, \"humidity\": %.1f, \"dew_point\": %.1f, "
+                "\"abs_humidity\": %.1f, \"heat_index\": %.1f, \"threshold_eta\": %.0f, \"prestart\": %s, "
+                "\"schedule_vent\": %s, \"quiet_hours\": %s, \"alarms\": %s, \"fan_on\": %s, \"fan_duty\": %.0f, \"mode\": \"%s\", "
+                "\"remote_commands\": %u, \"energy\": %s}",
+            rec->temperature,
+            rec->humidity,
+            rec->derived.dew_point,
+            rec->derived.abs_humidity,
+            rec->derived.heat_index,
+            rec->threshold_eta,
+            rec->prestart ? "true" : "false",
+            rec->schedule_vent ? "true" : "false",
+            rec->quiet ? "true" : "false",
+            rec->alarms,
+            rec->fan_on ? "true" : "false",
+            rec->fan_duty * 100.0f,
+            mode_str,
+            rec->remote_commands,
+            rec->energy);
     fclose(fp);
 }
 
-// GUI 업데이트를 수행할 콜백 (메인 GTK 스레드에서 안전하게 실행됨)
-static gboolean update_gui_callback(gpointer user_data) {
-    SharedData *data = (SharedData*)user_data;
-    if (!data || !data->widgets || !data->widgets->lbl_temp) {
-        return G_SOURCE_REMOVE;
+// 원격 제어 명령 처리 (FIFO 또는 시뮬레이션 입력)
+void control_handle_remote_command(SharedData *data, const char *command) {
+    log_info("[Remote] Command received: %s", command);
+    SampleRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.time = clock_now();
+    // 웹 클라이언트(long-poll)가 다음 판독을 기다리지 않고 결과를 받도록 상태 파일도 바로 게시
+    rec.publish = PUBLISH_STATUS | PUBLISH_TELEMETRY;
+
+    pthread_mutex_lock(&data->mutex);
+    g_remote_command_count++;
+    if (strncmp(command, "REMOTE_ON", 9) == 0) {
+        data->mode = MANUAL;
+        data->is_running = true;
+        ventilation_on();
+        data->fan_duty = get_fan_duty();
+    } else if (strncmp(command, "REMOTE_OFF", 10) == 0) {
+        data->mode = MANUAL;
+        data->is_running = false;
+        ventilation_off();
+        data->fan_duty = 0.0f;
+    } else if (strncmp(command, "REMOTE_AUTO", 11) == 0) {
+        data->mode = AUTOMATIC;
     }
+    energy_record(rec.time, data->fan_duty, data->mode);
+    if (save_checkpoint(data) == CHECKPOINT_CONTROL) rec.publish |= PUBLISH_CHECKPOINT;
+    fill_status(data, &rec);
+    pthread_mutex_unlock(&data->mutex);
+    if (g_data != NULL) pipeline_ring_push(&g_publish_ring, &rec); // 게시 단계는 워커 시작 시 구성
 
-    g_mutex_lock(&data->mutex);
-    
-    // 1. 라벨 업데이트
-    char temp_str[32], hum_str[32];
-    sprintf(temp_str, "Temperature: %.1f C", data->temperature);
-    sprintf(hum_str, "Humidity: %.1f %%", data->humidity);
-    gtk_label_set_text(GTK_LABEL(data->widgets->lbl_temp), temp_str);
-    gtk_label_set_text(GTK_LABEL(data->widgets->lbl_humidity), hum_str);
+    // 스케줄 명령 (SCHED_ADD <rule> / SCHED_DEL <id> / SCHED_CLEAR / SCHED_LIST)
+    // 효과는 워커 루프의 다음 schedule_advance에서 반영됨
+    if (strncmp(command, "SCHED_", 6) == 0) {
+        int modified = 0;
+        if (strncmp(command, "SCHED_ADD ", 10) == 0) {
+            int id = schedule_add(command + 10, (time_t)clock_now());
+            if (id > 0) log_info("[Schedule] Added rule %d", id);
+            modified = id > 0;
+        } else if (strncmp(command, "SCHED_DEL ", 10) == 0) {
+            int id = atoi(command + 10);
+            modified = schedule_remove(id) == 0;
+            if (!modified) log_warn("[Schedule] No rule %d", id);
+        } else if (strncmp(command, "SCHED_CLEAR", 11) == 0) {
+            schedule_clear();
+            modified = 1;
+        } else if (strncmp(command, "SCHED_LIST", 10) == 0) {
+            schedule_log_rules();
+        }
+        if (modified && g_schedule_path) schedule_save(g_schedule_path);
+    }
+}
 
-    // 2. 상태 라벨 및 스위치 상태 업데이트
-    GtkSwitch *mode_switch = GTK_SWITCH(data->widgets->switch_mode);
-    gboolean is_manual_mode = (data->mode == MANUAL);
+// PWM 목표 속도: 온도/습도/이슬점 중 임계값을 가장 많이 넘은 비율에 비례
+static float fan_target_duty(const SharedData *data) {
+    FanPolicy policy = auto_policy();
+    float excess = (data->temperature - policy.temperature_threshold) / FAN_FULL_TEMP_EXCESS;
+    float humi = (data->humidity - policy.humidity_threshold) / FAN_FULL_HUMI_EXCESS;
+    if (humi > excess) excess = humi;
+    if (!isnan(policy.dew_point_threshold)) { // 이슬점 조건을 켠 경우만
+        float dew = (data->derived.dew_point - policy.dew_point_threshold) / FAN_FULL_DEW_EXCESS;
+        if (dew > excess) excess = dew;
+    }
+    if (excess < 0.0f) excess = 0.0f;
+    if (excess > 1.0f) excess = 1.0f;
+    return FAN_DUTY_MIN + (1.0f - FAN_DUTY_MIN) * excess;
+}
+
+// 목표 속도로 변화율 제한을 둔 다음 듀티 (정지 상태에서는 최저 속도로 바로 기동)
+static float ramp_fan_duty(float duty, float target, double now) {
+    if (duty < FAN_DUTY_MIN) return FAN_DUTY_MIN;
+    float step = FAN_RAMP_PER_SECOND * (float)(now - g_duty_updated);
+    if (target > duty + step) return duty + step;
+    if (target < duty - step) return duty - step;
+    return target;
+}
 
-    if (data->mode == AUTOMATIC) {
-        gtk_label_set_text(GTK_LABEL(data->widgets->lbl_status),
-            data->is_running ? "Fan ON (Auto)" : "Fan OFF (Auto)");
-    } else { // MANUAL
-        gtk_label_set_text(GTK_LABEL(data->widgets->lbl_status),
-            data->is_running ? "Fan ON (Manual)" : "Fan OFF (Manual)");
+// 자동 모드 팬 판단: 임계값(스케줄 구간별 값 우선)과 히스테리시스/최소 가동 시간, 도달 예측, 강제 환기 구간
+// PWM 모드에서는 켜져 있는 동안 초과 정도에 따라 속도를 정함 (data->mutex 보유 상태에서 호출)
+static void decide_auto_fan(const SharedData *data, SampleRecord *rec) {
+    FanPolicy policy = auto_policy();
+    FanPolicyInput in = {
+        .time = rec->time,
+        .temperature = data->temperature,
+        .humidity = data->humidity,
+        .dew_point = data->derived.dew_point,
+    };
+    int threshold_condition;
+    rec->fan_on = fan_policy_decide(&policy, &g_stage.policy_state, &in, data->is_running,
+                                    g_schedule.force_vent, &threshold_condition) != 0;
+    if (rec->fan_on && !data->is_running) {
+        if (!threshold_condition && g_schedule.force_vent) {
+            log_info("[Logic] Scheduled ventilation window, starting fan");
+        } else if (!threshold_condition) {
+            log_info("[Logic] Pre-starting fan: threshold predicted in %.0f s", data->threshold_eta);
+        }
+    }
+    if (!rec->fan_on) {
+        rec->fan_duty = 0.0f;
+    } else if (fan_pwm_enabled()) {
+        rec->fan_duty = ramp_fan_duty(data->fan_duty, fan_target_duty(data), rec->time);
+    } else {
+        rec->fan_duty = 1.0f;
     }
+}
+
+/* --- 제어 파이프라인 단계 (워커 스레드) --- */
 
-    // 3. GUI 스위치의 현재 상태와 데이터의 모드 상태가 다를 때만 업데이트
-    // 이렇게 하여 무한 시그널 루프를 방지하고, 원격 제어 상태를 GUI에 정확히 반영
-    if (gtk_switch_get_active(mode_switch) != is_manual_mode) {
-        // 콜백이 또 호출되는 것을 막기 위해 잠시 시그널 핸들러를 비활성화
-        g_signal_handlers_block_by_func(mode_switch, G_CALLBACK(on_mode_switch_state_set), data);
-        gtk_switch_set_active(mode_switch, is_manual_mode);
-        // 다시 시그널 핸들러 활성화
-        g_signal_handlers_unblock_by_func(mode_switch, G_CALLBACK(on_mode_switch_state_set), data);
+// acquire: 센서 콜백이 남긴 새 판독값과 스케줄 변화를 레코드로 가져옴
+static int stage_acquire(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    pthread_mutex_lock(&g_data->mutex);
+    rec->has_sample = g_data->new_data_available;
+    if (rec->has_sample) {
+        rec->temperature = g_data->raw_temperature;
+        rec->humidity = g_data->raw_humidity;
+        g_data->new_data_available = false;
+    }
+    pthread_mutex_unlock(&g_data->mutex);
+    if (rec->has_sample) {
+        // 디버그 메시지
+        log_debug("[Debug Logic] New data processed -> Temp: %.1f C, Humi: %.1f %%",
+                  rec->temperature, rec->humidity);
+    }
+    return rec->has_sample ? PIPELINE_NEXT : PIPELINE_SKIP;
+}
+
+// validate: 센서가 낼 수 없는 값 제외 (DHT_BAD_DATA 판독도 콜백에서 전달됨)
+static int stage_validate(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!rec->has_sample) return PIPELINE_SKIP;
+    if (!isfinite(rec->temperature) || !isfinite(rec->humidity) ||
+        rec->temperature < SENSOR_TEMP_MIN || rec->temperature > SENSOR_TEMP_MAX ||
+        rec->humidity < 0.0f || rec->humidity > 100.0f) {
+        g_stage.rejected_samples++;
+        log_warn("[Logic] Rejected implausible reading: %.1f C, %.1f %%", rec->temperature, rec->humidity);
+        rec->has_sample = false;
+    }
+    return PIPELINE_NEXT;
+}
+
+// filter: 직전 값에서 갑자기 튄 판독은 한 번 보류하고, 다음 판독이 보류한 값 근처이면 실제 변화로 받아들임
+static bool filter_jump(float temperature, float humidity, float ref_temperature, float ref_humidity) {
+    return fabsf(temperature - ref_temperature) > FILTER_MAX_TEMP_STEP ||
+           fabsf(humidity - ref_humidity) > FILTER_MAX_HUMI_STEP;
+}
+
+static int stage_filter(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!rec->has_sample) return PIPELINE_SKIP;
+    if (g_stage.filter_primed &&
+        filter_jump(rec->temperature, rec->humidity, g_stage.filter_temperature, g_stage.filter_humidity)) {
+        bool confirmed = g_stage.filter_held &&
+                         !filter_jump(rec->temperature, rec->humidity, g_stage.held_temperature, g_stage.held_humidity);
+        if (!confirmed) {
+            g_stage.filter_held = true;
+            g_stage.held_temperature = rec->temperature;
+            g_stage.held_humidity = rec->humidity;
+            g_stage.rejected_samples++;
+            log_warn("[Logic] Holding sudden jump to %.1f C, %.1f %% until confirmed", rec->temperature, rec->humidity);
+            rec->has_sample = false;
+            return PIPELINE_NEXT;
+        }
+    }
+    g_stage.filter_held = false;
+    g_stage.filter_primed = true;
+    g_stage.filter_temperature = rec->temperature;
+    g_stage.filter_humidity = rec->humidity;
+    return PIPELINE_NEXT;
+}
+
+// derive: 파생 지표 (이슬점, 절대습도, 체감온도)와 임계값 도달 예측
+static int stage_derive(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!rec->has_sample) return PIPELINE_SKIP;
+    psychro_compute(rec->temperature, rec->humidity, &rec->derived);
+    update_prediction(rec);
+    return PIPELINE_NEXT;
+}
+
+// decide: 처리된 값을 공유 상태에 반영하고 경고 규칙과 자동 팬 동작을 결정
+static int stage_decide(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    AlarmOutput out;
+
+    pthread_mutex_lock(&g_data->mutex);
+    if (rec->has_sample) {
+        g_data->temperature = rec->temperature;
+        g_data->humidity = rec->humidity;
+        g_data->derived = rec->derived;
+        g_data->threshold_eta = rec->threshold_eta;
+        g_data->fan_prestart = rec->prestart;
+
+        AlarmSample sample = {
+            .temperature = rec->temperature,
+            .humidity = rec->humidity,
+            .dew_point = rec->derived.dew_point,
+            .abs_humidity = rec->derived.abs_humidity,
+            .heat_index = rec->derived.heat_index,
+            .fan_on = g_data->is_running ? 1 : 0,
+        };
+        alarm_rules_sample(&sample, rec->time);
+    }
+    // 새 판독이 없을 때도 평가하여 stale 및 지속 시간 조건을 갱신
+    alarm_rules_evaluate(rec->time, &out);
+    rec->alert = out.active_count > 0;
+    rec->alarm_changed = out.changed != 0;
+    rec->buzzer = out.buzzer != 0;
+    snprintf(rec->lcd_text, sizeof(rec->lcd_text), "%s", out.lcd_text ? out.lcd_text : "");
+
+    // 자동 팬 제어 (강제 환기 구간이나 구간별 임계값은 다음 판독을 기다리지 않고 바로 적용)
+    rec->mode = g_data->mode;
+    rec->fan_decided = (rec->has_sample || rec->schedule_changed) && rec->mode == AUTOMATIC;
+    if (rec->fan_decided) decide_auto_fan(g_data, rec);
+    pthread_mutex_unlock(&g_data->mutex);
+    return PIPELINE_NEXT;
+}
+
+// actuate: 팬과 버저 구동, 팬 가동 시간/전력량 집계
+static int stage_actuate(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!rec->has_sample && !rec->schedule_changed && !rec->alarm_changed && !rec->buzzer) return PIPELINE_SKIP;
+
+    pthread_mutex_lock(&g_data->mutex);
+    g_data->is_alert_active = rec->alert;
+    // 판단 후 원격 명령으로 모드가 바뀌었으면 자동 판단은 버림
+    if (rec->fan_decided && g_data->mode == rec->mode) {
+        if (rec->fan_on) {
+            if (!g_data->is_running) {
+                g_data->is_running = true;
+                if (!fan_pwm_enabled()) {
+                    ventilation_on();
+                    g_data->fan_duty = get_fan_duty();
+                }
+            }
+            if (fan_pwm_enabled()) {
+                g_duty_updated = rec->time;
+                if (rec->fan_duty != g_data->fan_duty) {
+                    ventilation_set_duty(rec->fan_duty);
+                    g_data->fan_duty = get_fan_duty();
+                }
+            }
+        } else if (g_data->is_running) {
+            g_data->is_running = false;
+            ventilation_off();
+            g_data->fan_duty = 0.0f;
+        }
+    }
+    if (rec->has_sample || rec->schedule_changed) {
+        energy_record(clock_now(), g_data->fan_duty, g_data->mode);
+    }
+    if (rec->has_sample) {
+        g_sample_count++;
+        g_last_reading_time = clock_now();
+    }
+    // 바뀐 제어 상태를 체크포인트에 남김 (디스크 반영은 게시 스레드에서)
+    rec->checkpoint_changed = save_checkpoint(g_data) == CHECKPOINT_CONTROL;
+    pthread_mutex_unlock(&g_data->mutex);
+
+    // 버저 규칙이 활성화되는 '순간'에만 울림 (끄는 것은 워커 루프가 기한에 맞춰 처리하므로 기다리지 않음)
+    if (rec->buzzer && g_schedule.quiet) {
+        log_info("[Alert] Warning condition met during quiet hours, buzzer suppressed.");
+    } else if (rec->buzzer) {
+        log_warn("[Alert] Warning condition met. Sounding buzzer for %.0f seconds...", BUZZER_ALERT_SECONDS);
+        buzzer_on();
+        g_buzzer_off_at = clock_monotonic() + BUZZER_ALERT_SECONDS;
+    }
+    return PIPELINE_NEXT;
+}
+
+// 울리는 시간이 지났으면 (force면 바로) 버저를 끔
+static void stop_buzzer(double now, bool force) {
+    if (g_buzzer_off_at <= 0.0 || (!force && now < g_buzzer_off_at)) return;
+    buzzer_off();
+    g_buzzer_off_at = 0.0;
+    log_info("[Alert] Buzzer stopped.");
+}
+
+// publish: 스냅샷을 바로 게시하고, 느린 출력(LCD, 파일, 아카이브, 네트워크)은 게시 링으로 넘김
+static int stage_publish(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    rec->publish = 0;
+    if (rec->has_sample) rec->publish |= PUBLISH_LCD | PUBLISH_ARCHIVE;
+    if (rec->alarm_changed) rec->publish |= PUBLISH_LCD;
+    if (rec->has_sample || rec->schedule_changed || rec->alarm_changed) {
+        rec->publish |= PUBLISH_STATUS | PUBLISH_TELEMETRY;
+    }
+    if (rec->checkpoint_changed) rec->publish |= PUBLISH_CHECKPOINT;
+    if (rec->publish == 0) return PIPELINE_SKIP;
+
+    pthread_mutex_lock(&g_data->mutex);
+    fill_status(g_data, rec);
+    pthread_mutex_unlock(&g_data->mutex);
+    pipeline_ring_push(&g_publish_ring, rec);
+    return PIPELINE_NEXT;
+}
+
+/* --- 게시 단계 (게시 스레드, 가상 시계에서는 워커 스레드) --- */
+
+// Text LCD 업데이트 (새 판독이 있거나 경고 문구가 바뀔 때)
+static int sink_lcd(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!(rec->publish & PUBLISH_LCD)) return PIPELINE_SKIP;
+    lcd_display_update(rec->lcd_text[0] ? rec->lcd_text : NULL, rec->temperature, rec->humidity);
+    return PIPELINE_NEXT;
+}
+
+static int sink_status(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!(rec->publish & PUBLISH_STATUS) || g_status_path == NULL) return PIPELINE_SKIP;
+    write_status_to_file(rec);
+    return PIPELINE_NEXT;
+}
+
+static int sink_archive(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!(rec->publish & PUBLISH_ARCHIVE) || g_archive == NULL) return PIPELINE_SKIP;
+    ArchiveSample sample;
+    sample.timestamp = (int64_t)rec->time;
+    sample.temperature = rec->temperature;
+    sample.humidity = rec->humidity;
+    sample.fan_on = rec->fan_on ? 1 : 0;
+    sample.mode = (uint8_t)rec->mode;
+    archive_writer_append(g_archive, &sample);
+    return PIPELINE_NEXT;
+}
+
+// 체크포인트 디스크 반영 (전원 차단 대비, 제어 스레드가 저장 장치를 기다리지 않도록 게시 스레드에서)
+static int sink_checkpoint(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!(rec->publish & PUBLISH_CHECKPOINT)) return PIPELINE_SKIP;
+    return checkpoint_sync() ? PIPELINE_NEXT : PIPELINE_SKIP;
+}
+
+static int sink_telemetry(void *record) {
+    SampleRecord *rec = (SampleRecord *)record;
+    if (!(rec->publish & PUBLISH_TELEMETRY) || !g_telemetry_enabled) return PIPELINE_SKIP;
+    double now = clock_now();
+    g_frame.flags = (rec->fan_on ? TELEMETRY_FLAG_FAN_ON : 0) |
+                    (rec->mode == MANUAL ? TELEMETRY_FLAG_MANUAL : 0) |
+                    (rec->alert ? TELEMETRY_FLAG_ALERT : 0);
+    g_frame.seq = g_telemetry_seq++;
+    g_frame.timestamp_ms = (uint64_t)(now * 1000.0);
+    g_frame.temperature = rec->temperature;
+    g_frame.humidity = rec->humidity;
+    g_frame.uptime_s = (uint32_t)(clock_monotonic() - g_worker_start_time);
+    g_frame.samples = rec->samples;
+    g_frame.remote_commands = rec->remote_commands;
+    g_frame.fan_toggles = get_fan_toggle_count();
+    g_frame.sensor_errors = dht11_get_error_count();
+    telemetry_send(&g_frame);
+    return PIPELINE_NEXT;
+}
+
+// 설정 파일 변경 반영 (판독 판단 사이의 워커 루프 지점에서 호출, 적용했으면 true)
+// 새 핀을 하드웨어에 적용하지 못하면 바꾼 핀을 되돌리고 이전 설정으로 계속 동작
+static bool apply_config_change(double *next_read) {
+    const RuntimeConfig *old = g_config;
+    if (config_reload() <= 0) return false;
+    const RuntimeConfig *cfg = config_current();
+
+    // 릴레이 출력은 원격 명령(Modbus 스레드)과 겹치지 않도록 뮤텍스 안에서 옮김
+    // 센서는 콜백이 같은 뮤텍스를 잡으므로 밖에서 다시 엶
+    int failed = 0;
+    if (cfg->relay_pin != old->relay_pin) {
+        pthread_mutex_lock(&g_data->mutex);
+        failed = motor_set_relay_pin(cfg->relay_pin) != 0;
+        pthread_mutex_unlock(&g_data->mutex);
+    }
+    if (!failed && cfg->dht_gpio != old->dht_gpio && dht11_set_gpio(cfg->dht_gpio) != 0) {
+        failed = 1;
+        if (cfg->relay_pin != old->relay_pin) {
+            pthread_mutex_lock(&g_data->mutex);
+            motor_set_relay_pin(old->relay_pin);
+            pthread_mutex_unlock(&g_data->mutex);
+        }
+    }
+    if (failed) {
+        config_rollback(old);
+        return false;
+    }
+
+    g_config = cfg;
+    // 판독 주기가 짧아졌으면 다음 판독을 새 주기에 맞춤
+    double limit = clock_monotonic() + cfg->read_interval;
+    if (*next_read > limit) *next_read = limit;
+    log_info("[Config] Configuration #%u active: relay GPIO %d, DHT GPIO %d, read every %d s",
+             cfg->generation, cfg->relay_pin, cfg->dht_gpio, cfg->read_interval);
+    if (isnan(cfg->policy.dew_point_threshold)) {
+        log_info("[Config] Thresholds %.1f C / %.1f %% / dew off", cfg->policy.temperature_threshold,
+                 cfg->policy.humidity_threshold);
+    } else {
+        log_info("[Config] Thresholds %.1f C / %.1f %% / dew %.1f C", cfg->policy.temperature_threshold,
+                 cfg->policy.humidity_threshold, cfg->policy.dew_point_threshold);
+    }
+    return true;
+}
+
+static void build_pipelines() {
+    pipeline_init(&g_control_pipeline, "control");
+    pipeline_add_stage(&g_control_pipeline, "acquire", stage_acquire, 0);
+    pipeline_add_stateful_stage(&g_control_pipeline, "validate", stage_validate, &g_stage, sizeof(g_stage));
+    pipeline_add_stateful_stage(&g_control_pipeline, "filter", stage_filter, &g_stage, sizeof(g_stage));
+    pipeline_add_stateful_stage(&g_control_pipeline, "derive", stage_derive, &g_stage, sizeof(g_stage));
+    pipeline_add_stage(&g_control_pipeline, "decide", stage_decide, 0);
+    pipeline_add_stage(&g_control_pipeline, "actuate", stage_actuate, 0);
+    pipeline_add_stage(&g_control_pipeline, "publish", stage_publish, 0);
+
+    pipeline_init(&g_publish_pipeline, "publish");
+    pipeline_add_stage(&g_publish_pipeline, "lcd", sink_lcd, 0);
+    pipeline_add_stage(&g_publish_pipeline, "status", sink_status, 0);
+    pipeline_add_stage(&g_publish_pipeline, "archive", sink_archive, 0);
+    pipeline_add_stage(&g_publish_pipeline, "telemetry", sink_telemetry, 0);
+    pipeline_add_stage(&g_publish_pipeline, "checkpoint", sink_checkpoint, 0);
+    pipeline_ring_init(&g_publish_ring, &g_publish_pipeline, g_publish_slots, sizeof(SampleRecord));
+}
+
+void control_pipeline_bench(int iterations) {
+    // 마지막으로 처리한 판독값 기준 (없으면 전형적인 실내 값)
+    SampleRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.time = clock_now();
+    rec.has_sample = true;
+    rec.temperature = g_stage.filter_primed ? g_stage.filter_temperature : 24.0f;
+    rec.humidity = g_stage.filter_primed ? g_stage.filter_humidity : 55.0f;
+
+    printf("[Pipeline] Isolated stage cost over %d iterations:\n", iterations);
+    for (int i = 0; i < g_control_pipeline.count; i++) {
+        double ns = pipeline_bench_stage(&g_control_pipeline, i, &rec, sizeof(rec), iterations);
+        if (ns >= 0.0) printf("[Pipeline]   %-10s %.1f ns/op\n", g_control_pipeline.stages[i].name, ns);
     }
-    
-    g_mutex_unlock(&data->mutex);
-    return G_SOURCE_REMOVE;
 }
 
 // 백그라운드 워커 스레드
 void* worker_thread_func(void* user_data) {
     SharedData *data = (SharedData*)user_data;
     int fifo_fd;
-    char command_buf[64];
+    char command_buf[256];
 
     // FIFO 파이프 생성 (모든 사용자가 쓸 수 있도록 0777 권한)
-    if (mkfifo(FIFO_PATH, 0777) == -1 && errno != EEXIST) {
-        perror("[Error] mkfifo failed");
+    if (g_fifo_path != NULL) {
+        if (mkfifo(g_fifo_path, 0777) == -1 && errno != EEXIST) {
+            perror("[Error] mkfifo failed");
+        }
+        if (chmod(g_fifo_path, 0777) == -1) {
+            perror("[Error] chmod for FIFO failed");
+        }
+
+        printf("[Logic] Opening FIFO for reading. Waiting for writer...\n");
+        fifo_fd = open(g_fifo_path, O_RDONLY | O_NONBLOCK);
+        if (fifo_fd == -1) {
+            perror("[Error] Failed to open FIFO permanently");
+            return NULL; // 스레드 종료
+        }
+        printf("[Logic] FIFO opened successfully.\n");
+    } else {
+        fifo_fd = -1;
+        printf("[Logic] Remote control FIFO disabled.\n");
     }
-    if (chmod(FIFO_PATH, 0777) == -1) {
-        perror("[Error] chmod for FIFO failed");
+
+    // 센서 이력 아카이브 열기 (실패해도 제어는 계속)
+    if (g_archive_path != NULL && g_archive == NULL) {
+        g_archive = archive_writer_open(g_archive_path);
+        if (g_archive) printf("[Logic] Recording history to %s\n", g_archive_path);
     }
 
-    printf("[Logic] Opening FIFO for reading. Waiting for writer...\n");
-    fifo_fd = open(FIFO_PATH, O_RDONLY | O_NONBLOCK);
-    if (fifo_fd == -1) {
-        perror("[Error] Failed to open FIFO permanently");
-        return NULL; // 스레드 종료
+    double start_time = clock_now();
+    g_worker_start_time = clock_monotonic();
+    g_last_report_time = g_worker_start_time;
+    g_last_report_samples = 0;
+    trend_init(&g_stage.temp_trend);
+    trend_init(&g_stage.humi_trend);
+    g_config = config_current();
+    fan_policy_reset(&g_stage.policy_state);
+
+    // 스케줄 (파일에 저장된 규칙 복원)
+    schedule_init((time_t)start_time);
+    if (g_schedule_path) schedule_load(g_schedule_path, (time_t)start_time);
+
+    // 경고 규칙 컴파일 (파일이 없으면 기본 규칙)
+    alarm_rules_load(g_alarm_rules_path, start_time);
+    if (g_state_restored) resume_from_checkpoint(data, start_time);
+
+    // 팬 가동 시간/전력량 집계 (저장된 집계가 있으면 이어서)
+    energy_init(g_energy_path, g_fan_watts, start_time);
+
+    // 텔레메트리 송신기 준비 (노드 이름은 호스트 이름 사용)
+    memset(&g_frame, 0, sizeof(g_frame));
+    g_telemetry_seq = 0;
+    g_telemetry_enabled = false;
+    if (g_telemetry_host != NULL && telemetry_sender_open(g_telemetry_host, g_telemetry_port) == 0) {
+        char hostname[64] = "smartvent";
+        gethostname(hostname, sizeof(hostname) - 1);
+        memcpy(g_frame.node, hostname, strnlen(hostname, TELEMETRY_NAME_LEN));
+        g_telemetry_enabled = true;
     }
-    printf("[Logic] FIFO opened successfully.\n");
+
+    // 게시 단계는 별도 스레드에서 실행 (가상 시계에서는 결과가 재현되도록 워커 스레드에서 바로 실행)
+    build_pipelines();
+    g_data = data;
+    if (!clock_is_virtual()) pipeline_ring_start(&g_publish_ring);
+
+    int sensor_fd = dht11_get_fd();
+    int config_fd = config_watch_fd();
+    double next_read = clock_monotonic(); // 대기 기한은 모두 clock_monotonic 기준
+    bool config_changed = false;
+    SampleRecord *rec = &g_record;
 
     while (1) {
-        fd_set fds;
-        struct timeval tv;
-        int ret;
-
-        FD_ZERO(&fds);
-        FD_SET(fifo_fd, &fds);
-        
-        tv.tv_sec = 0;
-        tv.tv_usec = 10000; // 0.01초만 기다림
-
-        ret = select(fifo_fd + 1, &fds, NULL, NULL, &tv);
-        
-        if (ret > 0 && FD_ISSET(fifo_fd, &fds)) {
-            int bytes_read = read(fifo_fd, command_buf, sizeof(command_buf) - 1);
-            if (bytes_read > 0) {
-                command_buf[bytes_read] = '\0';
-                printf("[Remote] Command received: %s\n", command_buf);
-                g_mutex_lock(&data->mutex);
-                // 모든 gtk_switch_set_active 호출을 제거
-                if (strncmp(command_buf, "REMOTE_ON", 9) == 0) {
-                    data->mode = MANUAL;
-                    data->is_running = TRUE;
-                    ventilation_on();
-                } else if (strncmp(command_buf, "REMOTE_OFF", 10) == 0) {
-                    data->mode = MANUAL;
-                    data->is_running = FALSE;
-                    ventilation_off();
-                } else if (strncmp(command_buf, "REMOTE_AUTO", 11) == 0) {
-                    data->mode = AUTOMATIC;
-                }
-                g_mutex_unlock(&data->mutex);
+        pthread_mutex_lock(&data->mutex);
+        bool stop = data->shutdown_requested;
+        pthread_mutex_unlock(&data->mutex);
+        if (stop) break;
+
+        // 판독 주기가 되면 비동기 판독 시작 (결과는 콜백과 fd로 전달되므로 기다리지 않음)
+        double now = clock_monotonic();
+        stop_buzzer(now, false);
+        if (now >= next_read) {
+            if (dht11_start_read() != 0) {
+                log_warn("[Logic] Previous sensor read still pending, skipping trigger.");
             }
+            next_read += g_config->read_interval;
+            if (next_read <= now) next_read = now + g_config->read_interval;
         }
 
-        // // 원격 제어 명령 확인
-        // fifo_fd = open(FIFO_PATH, O_RDONLY | O_NONBLOCK);
-        // if (fifo_fd != -1) {
-        //     int bytes_read = read(fifo_fd, command_buf, sizeof(command_buf) - 1);
-        //     if (bytes_read > 0) {
-        //         command_buf[bytes_read] = '\0';
-        //         printf("[Remote] Command received: %s\n", command_buf);
-        //         g_mutex_lock(&data->mutex);
-        //         if (strncmp(command_buf, "REMOTE_ON", 9) == 0) {
-        //             data->mode = MANUAL;
-        //             data->is_running = TRUE;
-        //             ventilation_on();
-        //             gtk_switch_set_active(GTK_SWITCH(data->widgets->switch_mode), TRUE);
-        //         } else if (strncmp(command_buf, "REMOTE_OFF", 10) == 0) {
-        //             data->mode = MANUAL;
-        //             data->is_running = FALSE;
-        //             ventilation_off();
-        //             gtk_switch_set_active(GTK_SWITCH(data->widgets->switch_mode), TRUE);
-        //         } else if (strncmp(command_buf, "REMOTE_AUTO", 11) == 0) {
-        //             data->mode = AUTOMATIC;
-        //             gtk_switch_set_active(GTK_SWITCH(data->widgets->switch_mode), FALSE);
-        //         }
-        //         g_mutex_unlock(&data->mutex);
-        //     }
-        //     close(fifo_fd);
-        // }
-
-        dht11_trigger_read();
-        sleep(1); 
-
-        g_mutex_lock(&data->mutex);
-        if (data->new_data_available) {
-            // 디버그 메시지
-            printf("[Debug Logic] New data processed -> Temp: %.1f C, Humi: %.1f %%\n", 
-                   data->temperature, data->humidity);
-            
-            // 1. Text LCD 업데이트
-            lcd_display_update(data->temperature, data->humidity);
-            write_status_to_file(data);
-
-            // 2. 버저 제어 로직
-            // 현재 센서 값 기준으로 경고 상태인지 판단
-            bool current_warning_state = (data->temperature >= WARNING_TEMP_THRESHOLD || data->humidity >= WARNING_HUMI_THRESHOLD);
-
-            // 상태가 OFF에서 ON으로 바뀌는 '순간'을 감지
-            // 현재는 경고 상태이지만, 직전까지는 경고 상태가 아니었을 때
-            if (current_warning_state && !data->is_alert_active) {
-                
-                // 뮤텍스를 잠시 풀고 버저를 제어
-                g_mutex_unlock(&data->mutex);
-                
-                printf("[Alert] Warning condition met. Sounding buzzer for 5 seconds...\n");
-                buzzer_on();
-                sleep(5); // 5초 동안 대기
-                buzzer_off();
-                printf("[Alert] Buzzer stopped.\n");
-
-                // 다시 뮤텍스를 잠그고 루프를 계속 진행
-                g_mutex_lock(&data->mutex);
-            }
+        // 스케줄 경계 처리 (규칙 수와 무관하게 틱당 O(1))
+        bool schedule_changed = schedule_advance((time_t)clock_now());
+        if (schedule_changed) schedule_get_effect(SCHEDULE_ZONE, &g_schedule);
 
-            // 다음 루프를 위해 현재 상태를 저장
-            data->is_alert_active = current_warning_state;
-
-
-            // 자동 팬 제어 (기존 로직)
-            if (data->mode == AUTOMATIC) {
-                bool fan_on_condition = (data->temperature >= TEMPERATURE_THRESHOLD || data->humidity >= HUMIDITY_THRESHOLD);
-                if (fan_on_condition) {
-                    if (!data->is_running) {
-                        data->is_running = TRUE;
-                        ventilation_on();
-                    }
-                } else {
-                    if (data->is_running) {
-                        data->is_running = FALSE;
-                        ventilation_off();
-                    }
-                }
-            }
-            data->new_data_available = FALSE;
+        // acquire -> validate -> filter -> derive -> decide -> actuate -> publish
+        memset(rec, 0, offsetof(SampleRecord, alarms)); // 문자열 버퍼는 게시 단계에서 채움
+        rec->time = clock_now();
+        rec->schedule_changed = schedule_changed || config_changed; // 새 임계값은 다음 판독 전에 바로 적용
+        config_changed = false;
+        pipeline_run(&g_control_pipeline, rec);
+
+        if (clock_monotonic() - g_last_report_time >= TIMING_REPORT_INTERVAL) print_timing_report();
+
+        // 다음 판독 시각까지 원격 명령 또는 센서 판독 완료를 기다림
+        bool fifo_ready, sensor_ready, config_ready;
+        double deadline = next_read;
+        time_t schedule_wakeup = schedule_next_wakeup();
+        if (schedule_wakeup >= 0) {
+            // 스케줄 경계는 벽시계 시각이므로 남은 시간으로 바꿔 비교
+            double schedule_deadline = clock_monotonic() + ((double)schedule_wakeup - clock_now());
+            if (schedule_deadline < deadline) deadline = schedule_deadline;
         }
-        g_mutex_unlock(&data->mutex);
+        if (g_buzzer_off_at > 0.0 && g_buzzer_off_at < deadline) deadline = g_buzzer_off_at;
+        wait_for_events(fifo_fd, sensor_fd, config_fd, deadline, &fifo_ready, &sensor_ready, &config_ready);
 
-        g_idle_add(update_gui_callback, data);
+        if (fifo_ready) {
+            int bytes_read = read(fifo_fd, command_buf, sizeof(command_buf) - 1);
+            if (bytes_read > 0) {
+                command_buf[bytes_read] = '\0';
+                control_handle_remote_command(data, command_buf);
+            } else if (bytes_read == 0) {
+                // 쓰는 쪽이 닫히면 POLLHUP이 계속 발생하므로 FIFO를 다시 엶
+                close(fifo_fd);
+                fifo_fd = open(g_fifo_path, O_RDONLY | O_NONBLOCK);
+                if (fifo_fd == -1) log_error("[Error] Failed to reopen FIFO: %s", strerror(errno));
+            }
+        }
+        if (sensor_ready) dht11_complete_read();
 
-        // 여기서의 sleep 시간은 버저 작동 시간에 영향을 받지 않음
-        sleep(READ_INTERVAL_SECONDS - 1);
+        // 설정 교체는 한 루프의 처리가 끝난 이 지점에서만 (센서를 다시 열면 완료 fd도 바뀜)
+        if (config_ready && apply_config_change(&next_read)) {
+            config_changed = true;
+            sensor_fd = dht11_get_fd();
+        }
     }
-    close(fifo_fd);
+    stop_buzzer(clock_monotonic(), true);
+    // 남은 게시 레코드 처리 (이후 게시는 호출 스레드에서 바로 처리됨)
+    pipeline_ring_stop(&g_publish_ring);
+    if (fifo_fd != -1) close(fifo_fd);
     return NULL;
-}
\ No newline at end of file
+}
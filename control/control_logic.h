@@ -1,7 +1,47 @@
 #ifndef CONTROL_LOGIC_H
 #define CONTROL_LOGIC_H
 
+#include "shared_data.h" // SharedData 구조체를 사용하기 위함
+
 // 워커 스레드 함수 프로토타입
 void* worker_thread_func(void* user_data);
 
-#endif
\ No newline at end of file
+// 원격 제어 명령(REMOTE_ON / REMOTE_OFF / REMOTE_AUTO, SCHED_ADD / SCHED_DEL / SCHED_CLEAR / SCHED_LIST) 처리
+void control_handle_remote_command(SharedData *data, const char *command);
+
+// FIFO 및 상태 파일 경로 변경 (NULL이면 비활성화, 워커 스레드 시작 전에 호출)
+void control_set_io_paths(const char *fifo_path, const char *status_path);
+
+// 파이프라인 단계별 처리 시간 파일 경로 변경 (NULL이면 기록하지 않음, 주기 타이밍 보고 때 갱신)
+void control_set_pipeline_stats_path(const char *stats_path);
+
+// 센서 이력 아카이브 경로 변경 (NULL이면 기록하지 않음)
+void control_set_archive_path(const char *archive_path);
+
+// 스케줄 파일 경로 변경 (NULL이면 저장/복원하지 않음)
+void control_set_schedule_path(const char *schedule_path);
+
+// 경고 규칙 파일 경로 변경 (NULL이면 기본 규칙 사용)
+void control_set_alarm_rules_path(const char *rules_path);
+
+// 팬 가동 시간/전력량 집계 파일 경로 변경 (NULL이면 저장하지 않음)
+void control_set_energy_path(const char *ledger_path);
+
+// 전력량 추정에 쓰는 팬 정격 전력(W) 변경
+void control_set_fan_watts(double fan_watts);
+
+// 텔레메트리 전송 대상 변경 (host가 NULL이면 전송하지 않음)
+void control_set_telemetry(const char *host, int port);
+
+// 제어 파이프라인 중 단독 실행 가능한 단계(validate, filter, derive)의 1회당 비용 측정
+// (마지막 판독값 기준, 워커 스레드 종료 후 호출)
+void control_pipeline_bench(int iterations);
+
+// 재시작 전 체크포인트에서 모드, 팬 상태, 마지막 판독값, 경고 상태 복원 (하드웨어/워커 시작 전에 호출)
+// 복원했으면 1이며, 이후 상태가 바뀔 때마다 체크포인트에 기록됨 (호출하지 않으면 기록하지 않음)
+int control_restore_state(SharedData *data);
+
+// 제어 로직 리소스 정리 (아카이브 기록 마무리, 워커 스레드 종료 후 호출)
+void control_logic_cleanup();
+
+#endif
@@ -1,27 +1,48 @@
 #include "dht11_driver.h"
 #include "motor_driver.h" // get_pi_handle() 사용
 #include "DHTXXD.h"
+#include "logger.h"
 #include <stdio.h>
 
-#define DHT_SENSOR_GPIO 27
 #define DHT_SENSOR_MODEL DHT11
+#define DHT_READ_TIMEOUT 0.25 // 비동기 읽기 타임아웃(초)
 
 static DHTXXD_t *dht_sensor_handle = NULL;
+static int dht_sensor_gpio = 27; // 설정 파일의 dht_gpio (dht11_set_gpio)
+static int dht_decoder = DHT_DECODER_ADAPTIVE; // 비트 분류 방식 (dht11_set_decoder)
+static const char *edge_trace_path = NULL; // 에지 길이 기록 파일 (NULL이면 기록 안 함)
+static FILE *edge_trace_fp = NULL;
 static SharedData *g_shared_data_for_callback = NULL;
+// 상태별 누적 횟수: DHT_GOOD, DHT_BAD_CHECKSUM, DHT_BAD_DATA, DHT_TIMEOUT
+static unsigned int sensor_status_counts[4] = {0};
 
 // 센서 데이터 수신 콜백 함수
 void dht_sensor_callback(DHTXXD_data_t data) {
     // 콜백이 호출될 때마다 센서 상태를 출력
     // DHT_GOOD=0, DHT_BAD_CHECKSUM=1, DHT_BAD_DATA=2, DHT_TIMEOUT=3
-    printf("[Debug Sensor] Callback received! status = %d\n", data.status);
+    log_debug("[Debug Sensor] Callback received! status = %d", data.status);
+
+    if (data.status >= DHT_GOOD && data.status <= DHT_TIMEOUT) sensor_status_counts[data.status]++;
 
     if (g_shared_data_for_callback && (data.status == DHT_GOOD || data.status == DHT_BAD_DATA)) {
-        g_mutex_lock(&g_shared_data_for_callback->mutex);
-        g_shared_data_for_callback->temperature = data.temperature;
-        g_shared_data_for_callback->humidity = data.humidity;
-        g_shared_data_for_callback->new_data_available = TRUE; // 새 데이터 플래그 설정
-        g_mutex_unlock(&g_shared_data_for_callback->mutex);
+        pthread_mutex_lock(&g_shared_data_for_callback->mutex);
+        g_shared_data_for_callback->raw_temperature = data.temperature;
+        g_shared_data_for_callback->raw_humidity = data.humidity;
+        g_shared_data_for_callback->new_data_available = true; // 새 데이터 플래그 설정
+        pthread_mutex_unlock(&g_shared_data_for_callback->mutex);
+    }
+}
+
+static DHTXXD_t *open_sensor(int pi, int gpio) {
+    DHTXXD_t *handle = DHTXXD(pi, gpio, DHT_SENSOR_MODEL, dht_sensor_callback);
+    if (handle == NULL) {
+        fprintf(stderr, "Failed to initialize DHT sensor on GPIO %d.\n", gpio);
+        return NULL;
     }
+    // 기본은 펄스 폭이 밀려도 프레임별로 0/1 경계를 찾는 적응형 분류기
+    DHTXXD_set_decoder(handle, dht_decoder);
+    if (edge_trace_fp) DHTXXD_set_edge_trace(handle, edge_trace_fp);
+    return handle;
 }
 
 int dht11_init(SharedData *data) {
@@ -29,21 +50,73 @@ int dht11_init(SharedData *data) {
     int pi = get_pi_handle();
     if (pi < 0) return -1;
 
-    dht_sensor_handle = DHTXXD(pi, DHT_SENSOR_GPIO, DHT_SENSOR_MODEL, dht_sensor_callback);
-    if (dht_sensor_handle == NULL) {
-        fprintf(stderr, "Failed to initialize DHT sensor on GPIO %d.\n", DHT_SENSOR_GPIO);
-        return -1;
+    if (edge_trace_path) {
+        edge_trace_fp = fopen(edge_trace_path, "a");
+        if (edge_trace_fp == NULL) perror("[Sensor] Failed to open edge trace file");
     }
+    dht_sensor_handle = open_sensor(pi, dht_sensor_gpio);
+    return dht_sensor_handle ? 0 : -1;
+}
+
+int dht11_set_gpio(int gpio) {
+    if (dht_sensor_handle == NULL || gpio == dht_sensor_gpio) {
+        dht_sensor_gpio = gpio;
+        return 0;
+    }
+    // 새 핀에서 먼저 열고 성공한 경우에만 기존 핀을 해제 (진행 중인 판독은 취소됨)
+    DHTXXD_t *handle = open_sensor(get_pi_handle(), gpio);
+    if (handle == NULL) return -1;
+    DHTXXD_cancel(dht_sensor_handle);
+    dht_sensor_handle = handle;
+    printf("[Sensor] DHT sensor moved from GPIO %d to GPIO %d\n", dht_sensor_gpio, gpio);
+    dht_sensor_gpio = gpio;
     return 0;
 }
 
+void dht11_set_decoder(int decoder) {
+    dht_decoder = decoder;
+}
+
+void dht11_set_edge_trace(const char *path) {
+    edge_trace_path = path;
+}
+
 void dht11_trigger_read() {
     if (dht_sensor_handle) DHTXXD_manual_read(dht_sensor_handle);
 }
 
+unsigned int dht11_get_error_count() {
+    return sensor_status_counts[DHT_BAD_CHECKSUM] + sensor_status_counts[DHT_TIMEOUT];
+}
+
+void dht11_get_status_counts(unsigned int counts[4]) {
+    for (int i = 0; i < 4; i++) counts[i] = sensor_status_counts[i];
+}
+
+int dht11_start_read() {
+    if (!dht_sensor_handle) return -1;
+    return DHTXXD_read_async(dht_sensor_handle, DHT_READ_TIMEOUT, NULL, NULL);
+}
+
+int dht11_get_fd() {
+    return dht_sensor_handle ? DHTXXD_read_fd(dht_sensor_handle) : -1;
+}
+
+void dht11_complete_read() {
+    if (dht_sensor_handle) DHTXXD_read_result(dht_sensor_handle, NULL);
+}
+
 void dht11_cleanup() {
     if (dht_sensor_handle) {
+        DHTBitCalib calib;
+        DHTXXD_decoder_stats(dht_sensor_handle, &calib);
+        printf("[Sensor] Bit split %.1fus (frame=%u running=%u rejected=%u)\n",
+               calib.split, calib.by_frame, calib.by_running, calib.rejected);
         DHTXXD_cancel(dht_sensor_handle);
         dht_sensor_handle = NULL;
     }
+    if (edge_trace_fp) {
+        fclose(edge_trace_fp);
+        edge_trace_fp = NULL;
+    }
 }
\ No newline at end of file
@@ -1,10 +1,18 @@
 #ifndef DHT11_DRIVER_H
 #define DHT11_DRIVER_H
 
-#include "gui.h" // SharedData 구조체를 사용하기 위함
+#include "shared_data.h" // SharedData 구조체를 사용하기 위함
 
 int dht11_init(SharedData *data); // 센서 초기화
-void dht11_trigger_read(); // 센서 값 읽기 요청
+void dht11_set_edge_trace(const char *path); // 프레임 에지 길이 기록 파일 지정 (dht11_init 전에 호출)
+void dht11_set_decoder(int decoder); // 비트 분류 방식 DHT_DECODER_FIXED/ADAPTIVE (dht11_init 전에 호출, 기본: ADAPTIVE)
+int dht11_set_gpio(int gpio); // 센서 데이터 핀 지정 (초기화 후에는 새 핀으로 다시 열고, 실패 시 -1로 기존 핀 유지, 완료 fd도 바뀜)
+void dht11_trigger_read(); // 센서 값 읽기 요청 (완료 또는 타임아웃까지 대기)
+int dht11_start_read(); // 비동기 읽기 시작 (즉시 반환, 진행 중이면 -1)
+int dht11_get_fd(); // 비동기 읽기 완료 시 읽기 가능해지는 fd (없으면 -1)
+void dht11_complete_read(); // 완료 알림 소비 (결과는 콜백으로 SharedData에 이미 반영됨)
 void dht11_cleanup(); // 센서 리소스 정리
+unsigned int dht11_get_error_count(); // 체크섬 오류/타임아웃 누적 횟수
+void dht11_get_status_counts(unsigned int counts[4]); // 상태(DHT_GOOD..DHT_TIMEOUT)별 누적 횟수
 
 #endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "dht_bits.h"
+
+// 적응형 분류에서 허용하는 상승 에지 간격(us). 이 밖이면 잡음이나 누락된 에지로 본다.
+#define EDGE_MIN_US 30
+#define EDGE_MAX_US 250
+// 프레임 안에서 '0'과 '1' 그룹 평균이 이만큼은 떨어져야 프레임 자체 경계를 신뢰한다
+#define MIN_SEPARATION_US 20.0f
+// 누적 추정 경계의 초기값 (고정 창의 경계와 동일)
+#define DEFAULT_SPLIT_US 100.0f
+// 누적 추정 갱신 가중치 (1/8 지수 이동 평균)
+#define SPLIT_WEIGHT 0.125f
+
+void dht_bits_calib_init(DHTBitCalib *cal) {
+    cal->split = DEFAULT_SPLIT_US;
+    cal->frames = 0;
+    cal->by_frame = 0;
+    cal->by_running = 0;
+    cal->rejected = 0;
+}
+
+int dht_bits_checksum_ok(uint64_t code) {
+    uint8_t sum = (uint8_t)((code >> 8) + (code >> 16) + (code >> 24) + (code >> 32));
+    return sum == (uint8_t)code;
+}
+
+int dht_bits_fixed(const uint16_t edges[DHT_FRAME_BITS], uint64_t *code) {
+    uint64_t c = 0;
+    for (int i = 0; i < DHT_FRAME_BITS; i++) {
+        c <<= 1;
+        if (edges[i] >= 60 && edges[i] <= 100) {
+            // 0 비트
+        } else if (edges[i] > 100 && edges[i] <= 150) {
+            c |= 1; // 1 비트
+        } else {
+            return -1; // 잘못된 비트, 프레임 폐기
+        }
+    }
+    *code = c;
+    return 0;
+}
+
+static uint64_t classify(const uint16_t edges[DHT_FRAME_BITS], float split) {
+    uint64_t c = 0;
+    for (int i = 0; i < DHT_FRAME_BITS; i++) c = (c << 1) | (edges[i] > split);
+    return c;
+}
+
+// 프레임 내 에지 길이를 두 그룹으로 나누는 경계 (그룹 간 분산 최대화).
+// 모든 비트가 같은 값이라 두 그룹이 구분되지 않으면 -1
+static float frame_split(const uint16_t edges[DHT_FRAME_BITS]) {
+    uint16_t sorted[DHT_FRAME_BITS];
+    uint32_t prefix[DHT_FRAME_BITS + 1];
+
+    // 40개뿐이므로 삽입 정렬
+    for (int i = 0; i < DHT_FRAME_BITS; i++) {
+        uint16_t v = edges[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    prefix[0] = 0;
+    for (int i = 0; i < DHT_FRAME_BITS; i++) prefix[i + 1] = prefix[i] + sorted[i];
+
+    float best_score = -1.0f, best_split = -1.0f, best_gap = 0.0f;
+    for (int k = 1; k < DHT_FRAME_BITS; k++) {
+        if (sorted[k] == sorted[k - 1]) continue;
+        float m0 = (float)prefix[k] / k;
+        float m1 = (float)(prefix[DHT_FRAME_BITS] - prefix[k]) / (DHT_FRAME_BITS - k);
+        float d = m1 - m0;
+        float score = (float)k * (DHT_FRAME_BITS - k) * d * d;
+        if (score > best_score) {
+            best_score = score;
+            best_split = (sorted[k - 1] + sorted[k]) * 0.5f;
+            best_gap = d;
+        }
+    }
+    return (best_gap >= MIN_SEPARATION_US) ? best_split : -1.0f;
+}
+
+int dht_bits_adaptive(const uint16_t edges[DHT_FRAME_BITS], DHTBitCalib *cal, uint64_t *code) {
+    for (int i = 0; i < DHT_FRAME_BITS; i++) {
+        if (edges[i] < EDGE_MIN_US || edges[i] > EDGE_MAX_US) {
+            cal->rejected++;
+            return -1;
+        }
+    }
+
+    // 1) 프레임 자체 경계
+    float split = frame_split(edges);
+    if (split > 0.0f) {
+        uint64_t c = classify(edges, split);
+        if (dht_bits_checksum_ok(c)) {
+            // 체크섬이 맞은 프레임의 경계만 누적 추정에 반영
+            cal->split = (cal->frames == 0) ? split : cal->split + SPLIT_WEIGHT * (split - cal->split);
+            cal->frames++;
+            cal->by_frame++;
+            *code = c;
+            return 0;
+        }
+    }
+
+    // 2) 누적 추정 경계로 재시도 (한쪽 비트만 있는 프레임, 경계 근처 비트가 흔들린 프레임)
+    uint64_t c = classify(edges, cal->split);
+    if (dht_bits_checksum_ok(c)) cal->by_running++;
+    // 실패해도 결과를 돌려주어 _decode_dhtxx가 체크섬 오류로 보고하게 한다
+    *code = c;
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef DHT_BITS_H
+#define DHT_BITS_H
+
+#include <stdint.h>
+
+// DHT 프레임 비트 분류기
+//
+// 한 프레임은 응답 펄스 뒤 40개의 데이터 비트로 이루어지며, 각 비트는 상승 에지 간격
+// (50us LOW + 26~28us HIGH = '0', 50us LOW + 70us HIGH = '1')으로 구분된다.
+// 고정 창 분류기는 기존 DHTXXD 동작(60~100us='0', 100~150us='1')을 그대로 재현하고,
+// 적응형 분류기는 프레임마다 에지 길이 분포에서 0/1 경계를 찾고 실패 시 이전 프레임들로부터
+// 추정한 경계로 재시도한다. 센서 노화나 긴 배선으로 펄스 폭이 밀려도 체크섬이 맞는 한
+// 프레임을 살릴 수 있다.
+// 분류 결과는 DHTXXD의 _code와 같은 배치(첫 비트가 MSB, 하위 8비트가 체크섬)이다.
+
+#define DHT_FRAME_BITS 40
+
+#define DHT_DECODER_FIXED    0 // 고정 창 (기존 동작)
+#define DHT_DECODER_ADAPTIVE 1 // 프레임별 경계 + 누적 추정 경계
+
+typedef struct {
+    float split;            // 누적 추정 0/1 경계(us)
+    unsigned int frames;    // 경계 추정에 반영된 프레임 수
+    unsigned int by_frame;  // 프레임 자체 경계로 체크섬이 맞은 횟수
+    unsigned int by_running;// 누적 추정 경계로 체크섬이 맞은 횟수
+    unsigned int rejected;  // 에지 길이가 허용 범위를 벗어나 버린 프레임 수
+} DHTBitCalib;
+
+void dht_bits_calib_init(DHTBitCalib *cal);
+
+// 40개 에지 길이(us)를 분류해 *code에 기록. 분류 불가 프레임이면 -1
+int dht_bits_fixed(const uint16_t edges[DHT_FRAME_BITS], uint64_t *code);
+int dht_bits_adaptive(const uint16_t edges[DHT_FRAME_BITS], DHTBitCalib *cal, uint64_t *code);
+
+// 체크섬 일치 여부 (바이트 4..1의 합 == 바이트 0)
+int dht_bits_checksum_ok(uint64_t code);
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dht_bits.h"
+
+// DHT 에지 기록 재생 도구 (pigpio 불필요)
+//   dht_replay <trace|->                          : 고정/적응형 분류기의 유효 프레임 비율 비교
+//   dht_replay synth [frames] [stretch] [jitter]  : 합성 기록 생성 (펄스 폭 배율, 에지 지터 us)
+//
+// 기록 형식은 smart_ventilation --dht-trace 출력과 같다.
+// 한 줄에 한 프레임: <timestamp> <edge1> ... <edge40> (상승 에지 간격, us)
+
+static int parse_frame(char *line, uint16_t edges[DHT_FRAME_BITS]) {
+    char *p = line, *end;
+    strtod(p, &end); // 타임스탬프
+    if (end == p) return -1;
+    p = end;
+    for (int i = 0; i < DHT_FRAME_BITS; i++) {
+        long v = strtol(p, &end, 10);
+        if (end == p || v < 0 || v > 0xFFFF) return -1;
+        edges[i] = (uint16_t)v;
+        p = end;
+    }
+    return 0;
+}
+
+static int replay(const char *path) {
+    FILE *fp = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (fp == NULL) {
+        perror("[Replay] Failed to open trace");
+        return 1;
+    }
+
+    DHTBitCalib calib;
+    dht_bits_calib_init(&calib);
+    unsigned long frames = 0, skipped = 0, fixed_good = 0, adaptive_good = 0;
+    char line[512];
+    uint16_t edges[DHT_FRAME_BITS];
+    uint64_t code;
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        if (parse_frame(line, edges) != 0) {
+            skipped++;
+            continue;
+        }
+        frames++;
+        if (dht_bits_fixed(edges, &code) == 0 && dht_bits_checksum_ok(code)) fixed_good++;
+        if (dht_bits_adaptive(edges, &calib, &code) == 0 && dht_bits_checksum_ok(code)) adaptive_good++;
+    }
+    if (fp != stdin) fclose(fp);
+
+    printf("frames: %lu (skipped %lu malformed lines)\n", frames, skipped);
+    printf("%-10s %10s %8s\n", "decoder", "valid", "rate");
+    printf("%-10s %10lu %7.1f%%\n", "fixed", fixed_good, frames ? 100.0 * fixed_good / frames : 0.0);
+    printf("%-10s %10lu %7.1f%%\n", "adaptive", adaptive_good, frames ? 100.0 * adaptive_good / frames : 0.0);
+    printf("adaptive: split=%.1fus frame=%u running=%u rejected=%u\n",
+           calib.split, calib.by_frame, calib.by_running, calib.rejected);
+    return 0;
+}
+
+static double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (RAND_MAX + 1.0));
+}
+
+// DHT11 프레임 합성: LOW 50us + HIGH 26us('0') / 70us('1'), 배율과 지터 적용
+static int synth(long frames, double stretch, double jitter) {
+    srand(1);
+    for (long f = 0; f < frames; f++) {
+        uint8_t humi = (uint8_t)uniform(30, 80);
+        uint8_t temp = (uint8_t)uniform(15, 35);
+        uint8_t bytes[5] = {humi, 0, temp, 0, (uint8_t)(humi + temp)};
+        double s = stretch * uniform(0.97, 1.03); // 프레임마다 조금씩 다른 펄스 폭
+
+        printf("%.3f", f * 3.0);
+        for (int i = 0; i < DHT_FRAME_BITS; i++) {
+            int bit = (bytes[i / 8] >> (7 - i % 8)) & 1;
+            double edge = (50.0 + (bit ? 70.0 : 26.0)) * s + uniform(-jitter, jitter);
+            printf(" %d", edge < 0 ? 0 : (int)(edge + 0.5));
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "synth") == 0) {
+        long frames = argc >= 3 ? atol(argv[2]) : 1000;
+        double stretch = argc >= 4 ? atof(argv[3]) : 1.0;
+        double jitter = argc >= 5 ? atof(argv[4]) : 5.0;
+        if (frames <= 0 || stretch <= 0.0 || jitter < 0.0) {
+            fprintf(stderr, "Invalid synth parameters.\n");
+            return 1;
+        }
+        return synth(frames, stretch, jitter);
+    }
+    if (argc == 2) return replay(argv[1]);
+
+    fprintf(stderr, "Usage: %s <trace|->\n", argv[0]);
+    fprintf(stderr, "       %s synth [frames] [stretch] [jitter_us]\n", argv[0]);
+    return 1;
+}
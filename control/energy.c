@@ -0,0 +1,231 @@
+#include "energy.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static const char *period_names[ENERGY_PERIODS] = { "hour", "day", "month", "total" };
+
+static EnergyBucket current[ENERGY_PERIODS];
+static EnergyBucket previous[ENERGY_TOTAL];
+static int64_t next_boundary[ENERGY_TOTAL]; // 각 구간이 끝나는 시각
+
+static const char *g_path = NULL;
+static double g_watts = FAN_RATED_WATTS;
+static double g_last = 0.0;       // 마지막으로 집계에 반영한 시각
+static double g_last_save = 0.0;
+static float g_duty = 0.0f;       // 마지막 상태
+static int g_mode = 0;
+static int g_started = 0;
+
+// t가 속한 구간의 시작 (offset이 1이면 다음 구간의 시작), 현지 시각 기준
+static int64_t period_start(int period, int64_t t, int offset) {
+    time_t tt = (time_t)t;
+    struct tm tm;
+    localtime_r(&tt, &tm);
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    if (period == ENERGY_HOUR) {
+        tm.tm_hour += offset;
+    } else {
+        tm.tm_hour = 0;
+        if (period == ENERGY_DAY) {
+            tm.tm_mday += offset;
+        } else {
+            tm.tm_mday = 1;
+            tm.tm_mon += offset;
+        }
+    }
+    tm.tm_isdst = -1; // DST 전환은 mktime에 맡김
+    return (int64_t)mktime(&tm);
+}
+
+static void reset_bucket(int period, int64_t start) {
+    memset(&current[period], 0, sizeof(EnergyBucket));
+    current[period].start = start;
+    if (period < ENERGY_TOTAL) next_boundary[period] = period_start(period, start, 1);
+}
+
+// 마지막 상태로 [from, to) 구간을 모든 집계 구간에 더함
+static void accumulate(double from, double to) {
+    double dt = to - from;
+    if (dt <= 0.0 || g_duty <= 0.0f) return;
+    double wh = g_watts * g_duty * g_duty * g_duty * dt / 3600.0;
+    for (int p = 0; p < ENERGY_PERIODS; p++) {
+        current[p].on_seconds[g_mode] += dt;
+        current[p].energy_wh[g_mode] += wh;
+    }
+}
+
+static int save_ledger();
+
+// now까지 집계를 진행하며 지나간 시간/일/월 구간을 마감
+// 평소에는 경계를 넘지 않으므로 O(1), 오래 중단되었다가 재시작하면 지나간 시간 수만큼 반복
+static void advance(double now) {
+    if (now < g_last) { // 시계가 뒤로 조정된 경우 그 시점부터 다시 집계
+        g_last = now;
+        return;
+    }
+    int rolled = 0;
+    while (now >= next_boundary[ENERGY_HOUR]) {
+        int64_t boundary = next_boundary[ENERGY_HOUR];
+        accumulate(g_last, (double)boundary);
+        g_last = (double)boundary;
+        for (int p = ENERGY_HOUR; p < ENERGY_TOTAL; p++) {
+            if (boundary < next_boundary[p]) continue;
+            previous[p] = current[p];
+            reset_bucket(p, boundary);
+        }
+        rolled = 1;
+    }
+    accumulate(g_last, now);
+    g_last = now;
+    if (rolled || now - g_last_save >= ENERGY_SAVE_INTERVAL) save_ledger();
+}
+
+/* --- 저장/복원 --- */
+
+static void write_bucket(FILE *fp, const char *name, const EnergyBucket *b) {
+    fprintf(fp, "%s %lld %.1f %.3f %u %.1f %.3f %u\n", name, (long long)b->start,
+            b->on_seconds[0], b->energy_wh[0], b->toggles[0],
+            b->on_seconds[1], b->energy_wh[1], b->toggles[1]);
+}
+
+static int save_ledger() {
+    g_last_save = g_last;
+    if (g_path == NULL) return 0;
+
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", g_path);
+    FILE *fp = fopen(tmp_path, "w");
+    if (fp == NULL) {
+        perror("[Energy] Failed to write energy ledger");
+        return -1;
+    }
+    fprintf(fp, "# <period> <start> <auto on_s> <auto Wh> <auto toggles> <manual on_s> <manual Wh> <manual toggles>\n");
+    fprintf(fp, "last %.0f\n", g_last);
+    char name[32];
+    for (int p = 0; p < ENERGY_PERIODS; p++) write_bucket(fp, period_names[p], &current[p]);
+    for (int p = 0; p < ENERGY_TOTAL; p++) {
+        snprintf(name, sizeof(name), "prev_%s", period_names[p]);
+        write_bucket(fp, name, &previous[p]);
+    }
+    if (fclose(fp) != 0 || rename(tmp_path, g_path) != 0) {
+        perror("[Energy] Failed to replace energy ledger");
+        return -1;
+    }
+    return 0;
+}
+
+static EnergyBucket *bucket_by_name(const char *name) {
+    for (int p = 0; p < ENERGY_PERIODS; p++) {
+        if (strcmp(name, period_names[p]) == 0) return &current[p];
+        if (p < ENERGY_TOTAL && strncmp(name, "prev_", 5) == 0 && strcmp(name + 5, period_names[p]) == 0) {
+            return &previous[p];
+        }
+    }
+    return NULL;
+}
+
+static int load_ledger(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) return -1;
+
+    char line[256], name[32];
+    double last = 0.0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') continue;
+        if (sscanf(line, "last %lf", &last) == 1) continue;
+
+        EnergyBucket b;
+        long long start;
+        memset(&b, 0, sizeof(b));
+        if (sscanf(line, "%31s %lld %lf %lf %u %lf %lf %u", name, &start,
+                   &b.on_seconds[0], &b.energy_wh[0], &b.toggles[0],
+                   &b.on_seconds[1], &b.energy_wh[1], &b.toggles[1]) != 8) continue;
+        b.start = start;
+        EnergyBucket *dest = bucket_by_name(name);
+        if (dest) *dest = b;
+    }
+    fclose(fp);
+    if (last <= 0.0) return -1;
+
+    g_last = last;
+    for (int p = 0; p < ENERGY_TOTAL; p++) next_boundary[p] = period_start(p, current[p].start, 1);
+    return 0;
+}
+
+void energy_init(const char *path, double fan_watts, double now) {
+    g_path = path;
+    g_watts = fan_watts > 0.0 ? fan_watts : FAN_RATED_WATTS;
+    g_duty = 0.0f;
+    g_mode = 0;
+    memset(current, 0, sizeof(current));
+    memset(previous, 0, sizeof(previous));
+
+    if (path != NULL && load_ledger(path) == 0) {
+        printf("[Energy] Restored fan energy ledger from %s\n", path);
+        g_last_save = now;
+        advance(now); // 중단된 동안 지나간 구간 마감 (팬은 꺼져 있던 것으로 처리)
+        g_started = 1;
+        return;
+    }
+    for (int p = 0; p < ENERGY_PERIODS; p++) {
+        reset_bucket(p, p == ENERGY_TOTAL ? (int64_t)now : period_start(p, (int64_t)now, 0));
+    }
+    g_last = now;
+    g_last_save = now;
+    g_started = 1;
+}
+
+void energy_record(double now, float duty, int mode) {
+    if (!g_started) return; // 워커 스레드가 집계를 시작하기 전 (예: Modbus 명령)
+    advance(now);
+    int was_on = g_duty > 0.0f;
+    int is_on = duty > 0.0f;
+    g_duty = duty;
+    g_mode = mode ? 1 : 0;
+    if (was_on != is_on) {
+        for (int p = 0; p < ENERGY_PERIODS; p++) current[p].toggles[g_mode]++;
+    }
+}
+
+void energy_get(int period, int previous_period, EnergyBucket *out) {
+    if (period < 0 || period >= ENERGY_PERIODS) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    *out = (previous_period && period < ENERGY_TOTAL) ? previous[period] : current[period];
+}
+
+static int format_bucket(char *buf, size_t len, const char *name, const EnergyBucket *b) {
+    return snprintf(buf, len,
+        ", \"%s\": {\"on_s\": %.0f, \"wh\": %.1f, \"toggles\": %u, "
+        "\"auto\": {\"on_s\": %.0f, \"wh\": %.1f}, \"manual\": {\"on_s\": %.0f, \"wh\": %.1f}}",
+        name, b->on_seconds[0] + b->on_seconds[1], b->energy_wh[0] + b->energy_wh[1],
+        b->toggles[0] + b->toggles[1], b->on_seconds[0], b->energy_wh[0], b->on_seconds[1], b->energy_wh[1]);
+}
+
+void energy_format_json(char *buf, size_t len) {
+    size_t used = (size_t)snprintf(buf, len, "{\"watts\": %.0f", g_watts);
+    char name[32];
+    for (int p = 0; p < ENERGY_PERIODS && used < len; p++) {
+        used += format_bucket(buf + used, len - used, period_names[p], &current[p]);
+    }
+    for (int p = 0; p < ENERGY_TOTAL && used < len; p++) {
+        snprintf(name, sizeof(name), "prev_%s", period_names[p]);
+        used += format_bucket(buf + used, len - used, name, &previous[p]);
+    }
+    if (used + 2 > len) { // 버퍼 부족: 유효한 JSON이 되도록 빈 객체로 대체
+        snprintf(buf, len, "{}");
+        return;
+    }
+    snprintf(buf + used, len - used, "}");
+}
+
+int energy_close(double now) {
+    if (!g_started) return -1;
+    advance(now);
+    save_ledger();
+    g_started = 0;
+    return 0;
+}
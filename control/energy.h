@@ -0,0 +1,42 @@
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 팬 가동 시간/전환 횟수/추정 전력량 집계
+//
+// 시간, 일, 월(현지 시각 기준) 구간과 누적 합계를 모드별(AUTOMATIC/MANUAL)로 유지한다.
+// 팬 상태나 모드가 바뀔 때, 그리고 판독마다 energy_record를 호출하면 직전 상태로 지난 시간만큼을
+// 현재 구간들에 더하므로 갱신 비용은 구간 길이와 무관하게 O(1)이다.
+// 추정 전력: 정격 전력 x 듀티^3 (팬 상사 법칙, 릴레이 ON/OFF는 듀티 1)
+// 집계는 텍스트 파일에 주기적으로 저장되어 재시작 후에도 이어진다 (중단된 동안은 팬이 꺼져 있던 것으로 처리).
+
+#define FAN_RATED_WATTS      24.0  // 기본 팬 정격 전력(W)
+#define ENERGY_SAVE_INTERVAL 600   // 집계 파일 저장 주기(초), 구간이 바뀔 때도 저장
+
+enum { ENERGY_HOUR, ENERGY_DAY, ENERGY_MONTH, ENERGY_TOTAL, ENERGY_PERIODS };
+
+typedef struct {
+    int64_t start;          // 구간 시작 시각 (epoch)
+    double on_seconds[2];   // 모드별 팬 가동 시간 (0: AUTOMATIC, 1: MANUAL)
+    double energy_wh[2];    // 모드별 추정 전력량
+    uint32_t toggles[2];    // 모드별 팬 켜짐/꺼짐 전환 횟수
+} EnergyBucket;
+
+// 집계 시작 (path가 NULL이면 저장하지 않음, 저장된 집계가 있으면 이어서)
+void energy_init(const char *path, double fan_watts, double now);
+
+// 현재 팬 듀티(0이면 꺼짐)와 모드를 반영 (상태 변화 시와 판독마다 호출)
+void energy_record(double now, float duty, int mode);
+
+// period 구간의 현재 값 (previous가 1이면 직전에 끝난 구간, ENERGY_TOTAL은 현재만)
+void energy_get(int period, int previous, EnergyBucket *out);
+
+// 상태 JSON용 객체: {"watts": .., "hour": {...}, "day": {...}, "month": {...}, "total": {...}, "prev_day": {...}, ...}
+void energy_format_json(char *buf, size_t len);
+
+// 마지막 상태까지 집계하고 저장 (종료 시, 집계를 시작하지 않았으면 -1)
+int energy_close(double now);
+
+#endif
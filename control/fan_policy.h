@@ -0,0 +1,126 @@
+#ifndef FAN_POLICY_H
+#define FAN_POLICY_H
+
+#include <math.h>
+
+// 자동 모드 팬 켜기/끄기 판단 (제어 데몬과 policy_sweep 도구가 공유)
+//
+// 판독값 하나마다 (1) 추세로 임계값 도달 예상 시간을 구해 선행 가동 여부를 정하고
+// (fan_policy_predict), (2) 임계값, 히스테리시스, 최소 가동/정지 시간으로 팬 상태를 정한다
+// (fan_policy_decide). 상태는 FanPolicyState에만 있으므로 후보 설정마다 상태를 따로 두면
+// 같은 이력으로 여러 설정을 동시에 평가할 수 있다. 도구의 후보별 루프에서 인라인되도록 헤더에 정의한다.
+// 히스테리시스와 최소 가동/정지 시간이 0이면 임계값 이상일 때만 켜는 기존 동작과 같다.
+// 이슬점 조건은 선택 사항이며 기본값은 꺼짐(FAN_POLICY_OFF)이다.
+
+// 기본 임계값
+#define TEMPERATURE_THRESHOLD 28.0f
+#define HUMIDITY_THRESHOLD    70.0f
+#define FAN_POLICY_OFF        NAN   // 이슬점 임계값을 이 값으로 두면 이슬점 조건을 쓰지 않음 (비교가 항상 거짓)
+#define PRESTART_HORIZON      120.0 // 임계값 도달이 이 시간(초) 안으로 예측되면 팬을 미리 가동
+
+typedef struct {
+    float temperature_threshold;
+    float humidity_threshold;
+    float dew_point_threshold;    // 이슬점이 이 이상이면 결로 방지를 위해 환기 (FAN_POLICY_OFF: 사용 안 함)
+    float temperature_hysteresis; // 켜진 뒤에는 온도가 임계값보다 이만큼(C) 낮아져야 꺼짐
+    float humidity_hysteresis;    // 켜진 뒤에는 습도가 임계값보다 이만큼(%) 낮아져야 꺼짐
+    float dew_point_hysteresis;   // 켜진 뒤에는 이슬점이 임계값보다 이만큼(C) 낮아져야 꺼짐
+    float min_on_seconds;         // 켜진 뒤 최소 가동 시간
+    float min_off_seconds;        // 꺼진 뒤 최소 정지 시간
+    float prestart_horizon;       // 선행 가동 예측 구간(초, 0이면 사용 안 함)
+} FanPolicy;
+
+// 판독값 하나 (추세 값은 trend_fit 결과, 적합 불가면 해당 trend_valid 비트가 0)
+typedef struct {
+    double time;
+    float temperature;
+    float humidity;
+    float dew_point;
+    int trend_valid;   // bit 0: 온도 추세, bit 1: 습도 추세
+    double temp_value; // 추세 적합값과 기울기(단위/초)
+    double temp_slope;
+    double humi_value;
+    double humi_slope;
+} FanPolicyInput;
+
+typedef struct {
+    int prestart;          // 예측에 따른 선행 가동 중
+    double prestart_since;
+    double changed_at;     // 마지막 팬 전환 시각 (최소 가동/정지 시간용, 음수면 없음)
+} FanPolicyState;
+
+static inline void fan_policy_defaults(FanPolicy *p) {
+    p->temperature_threshold = TEMPERATURE_THRESHOLD;
+    p->humidity_threshold = HUMIDITY_THRESHOLD;
+    p->dew_point_threshold = FAN_POLICY_OFF;
+    p->temperature_hysteresis = 0.0f;
+    p->humidity_hysteresis = 0.0f;
+    p->dew_point_hysteresis = 0.0f;
+    p->min_on_seconds = 0.0f;
+    p->min_off_seconds = 0.0f;
+    p->prestart_horizon = (float)PRESTART_HORIZON;
+}
+
+static inline void fan_policy_reset(FanPolicyState *s) {
+    s->prestart = 0;
+    s->prestart_since = 0.0;
+    s->changed_at = -1.0;
+}
+
+// 추세 적합값(value, 기울기 slope/초)이 threshold에 도달할 때까지 남은 시간(초)
+// 이미 넘었으면 0, 멀어지고 있으면 -1
+static inline double fan_policy_time_to(double value, double slope, float threshold) {
+    if (value >= threshold) return 0.0;
+    if (slope <= 0.0) return -1.0;
+    return (threshold - value) / slope;
+}
+
+// 온도/습도 중 먼저 임계값에 도달할 예상 시간 (추정 불가면 -1)
+static inline double fan_policy_eta(const FanPolicy *p, const FanPolicyInput *in) {
+    double eta = (in->trend_valid & 1) ? fan_policy_time_to(in->temp_value, in->temp_slope, p->temperature_threshold) : -1.0;
+    double eta_humi = (in->trend_valid & 2) ? fan_policy_time_to(in->humi_value, in->humi_slope, p->humidity_threshold) : -1.0;
+    if (eta < 0.0 || (eta_humi >= 0.0 && eta_humi < eta)) eta = eta_humi;
+    return eta;
+}
+
+// 새 판독값으로 선행 가동 여부 갱신 (eta_out: 임계값 도달 예상 시간)
+// 추세가 정체 구간에서 흔들려 팬이 깜빡이지 않도록, 선행 가동은 예측 구간만큼 유지하고
+// 이후에는 느슨한 조건(두 배 구간)으로 해제
+static inline int fan_policy_predict(const FanPolicy *p, FanPolicyState *s, const FanPolicyInput *in, double *eta_out) {
+    double horizon = p->prestart_horizon;
+    double eta = fan_policy_eta(p, in);
+    if (eta_out) *eta_out = eta;
+    if (horizon <= 0.0) {
+        s->prestart = 0;
+    } else if (s->prestart) {
+        s->prestart = (in->time - s->prestart_since < horizon) || (eta >= 0.0 && eta <= 2.0 * horizon);
+    } else if (eta > 0.0 && eta <= horizon) {
+        s->prestart = 1;
+        s->prestart_since = in->time;
+    }
+    return s->prestart;
+}
+
+// 팬을 켜 둘지 판단 (fan_on: 현재 상태, force_vent: 스케줄 강제 환기 구간)
+// threshold_out에는 임계값 조건 자체를 만족하는지 기록 (선행 가동/강제 환기 구분용)
+static inline int fan_policy_decide(const FanPolicy *p, FanPolicyState *s, const FanPolicyInput *in,
+                                    int fan_on, int force_vent, int *threshold_out) {
+    int over = in->temperature >= p->temperature_threshold ||
+               in->humidity >= p->humidity_threshold ||
+               in->dew_point >= p->dew_point_threshold;
+    int hold = fan_on && (in->temperature >= p->temperature_threshold - p->temperature_hysteresis ||
+                          in->humidity >= p->humidity_threshold - p->humidity_hysteresis ||
+                          in->dew_point >= p->dew_point_threshold - p->dew_point_hysteresis);
+    int want = over || hold || s->prestart || force_vent;
+
+    if (want != fan_on && s->changed_at >= 0.0) {
+        double elapsed = in->time - s->changed_at;
+        if (fan_on && elapsed < p->min_on_seconds) want = 1;
+        else if (!fan_on && elapsed < p->min_off_seconds) want = 0;
+    }
+    if (want != fan_on) s->changed_at = in->time;
+    if (threshold_out) *threshold_out = over;
+    return want;
+}
+
+#endif
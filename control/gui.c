@@ -1,58 +1,97 @@
 #include "gui.h"
-#include "motor_driver.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
 
-static SharedData *g_shared_data = NULL;
+#define FIFO_PATH "/tmp/smart_vent_fifo" // 제어 데몬의 원격 제어 파이프
+
+// 제어 데몬에 명령 전송 (데몬이 없으면 기다리지 않고 실패)
+static void send_command(GuiWidgets *widgets, const char *command) {
+    int fd = open(FIFO_PATH, O_WRONLY | O_NONBLOCK);
+    if (fd == -1) {
+        fprintf(stderr, "[GUI] Control daemon not reachable (%s)\n", strerror(errno));
+        gtk_label_set_text(GTK_LABEL(widgets->lbl_status), "Control daemon not running");
+        return;
+    }
+    if (write(fd, command, strlen(command)) == -1) perror("[GUI] Failed to send command");
+    close(fd);
+}
 
 // "수동 환기 시작" 버튼 콜백
 static void on_manual_on_clicked(GtkButton *button, gpointer user_data) {
-    g_mutex_lock(&g_shared_data->mutex);
-    if (g_shared_data->mode == MANUAL) {
-        g_shared_data->is_running = TRUE;
-        ventilation_on();
-        gtk_label_set_text(GTK_LABEL(g_shared_data->widgets->lbl_status), "Fan ON (Manual)");
-    }
-    g_mutex_unlock(&g_shared_data->mutex);
+    send_command((GuiWidgets*)user_data, "REMOTE_ON");
 }
 
 // "수동 환기 정지" 버튼 콜백
 static void on_manual_off_clicked(GtkButton *button, gpointer user_data) {
-    g_mutex_lock(&g_shared_data->mutex);
-    if (g_shared_data->mode == MANUAL) {
-        g_shared_data->is_running = FALSE;
-        ventilation_off();
-        gtk_label_set_text(GTK_LABEL(g_shared_data->widgets->lbl_status), "Fan OFF (Manual)");
-    }
-    g_mutex_unlock(&g_shared_data->mutex);
+    send_command((GuiWidgets*)user_data, "REMOTE_OFF");
 }
 
-// "자동/수동" 스위치 콜백
+// "자동/수동" 스위치 콜백 (실제 상태 반영은 데몬이 게시한 다음 스냅샷에서)
 void on_mode_switch_state_set(GtkSwitch *sw, gboolean state, gpointer user_data) {
-    SharedData *data = (SharedData*)user_data;
-
-    g_mutex_lock(&data->mutex);
-    if (state) { // TRUE: 수동 모드
-        data->mode = MANUAL;
-        gtk_widget_set_sensitive(data->widgets->btn_manual_on, TRUE);
-        gtk_widget_set_sensitive(data->widgets->btn_manual_off, TRUE);
-        if (data->is_running) {
-            data->is_running = FALSE;
-            ventilation_off();
-        }
-        gtk_label_set_text(GTK_LABEL(data->widgets->lbl_status), "Fan OFF (Manual)");
+    GuiWidgets *widgets = (GuiWidgets*)user_data;
+
+    if (state) { // TRUE: 수동 모드 (팬 정지 상태로 전환)
+        send_command(widgets, "REMOTE_OFF");
     } else { // FALSE: 자동 모드
-        data->mode = AUTOMATIC;
-        gtk_widget_set_sensitive(data->widgets->btn_manual_on, FALSE);
-        gtk_widget_set_sensitive(data->widgets->btn_manual_off, FALSE);
+        send_command(widgets, "REMOTE_AUTO");
+    }
+    gtk_widget_set_sensitive(widgets->btn_manual_on, state);
+    gtk_widget_set_sensitive(widgets->btn_manual_off, state);
+}
+
+void gui_refresh(GuiWidgets *widgets, const StatusSnapshot *snapshot, gboolean connected) {
+    if (!widgets || !widgets->lbl_temp) return;
+
+    if (!connected) {
+        gtk_label_set_text(GTK_LABEL(widgets->lbl_status), "Waiting for control daemon...");
+        return;
+    }
+
+    // 1. 라벨 업데이트
+    char temp_str[32], hum_str[32];
+    snprintf(temp_str, sizeof(temp_str), "Temperature: %.1f C", snapshot->temperature);
+    snprintf(hum_str, sizeof(hum_str), "Humidity: %.1f %%", snapshot->humidity);
+    gtk_label_set_text(GTK_LABEL(widgets->lbl_temp), temp_str);
+    gtk_label_set_text(GTK_LABEL(widgets->lbl_humidity), hum_str);
+
+    // 2. 상태 라벨 및 스위치 상태 업데이트 (mode 1: MANUAL)
+    GtkSwitch *mode_switch = GTK_SWITCH(widgets->switch_mode);
+    gboolean is_manual_mode = (snapshot->mode == 1);
+
+    char status_str[48];
+    const char *mode_str = is_manual_mode ? "Manual" : "Auto";
+    if (snapshot->fan_on && snapshot->fan_duty < 100) {
+        snprintf(status_str, sizeof(status_str), "Fan ON %d%% (%s)", snapshot->fan_duty, mode_str);
+    } else {
+        snprintf(status_str, sizeof(status_str), "Fan %s (%s)", snapshot->fan_on ? "ON" : "OFF", mode_str);
+    }
+    gtk_label_set_text(GTK_LABEL(widgets->lbl_status), status_str);
+
+    // 오늘 팬 가동 시간과 추정 전력량
+    char energy_str[64];
+    snprintf(energy_str, sizeof(energy_str), "Fan today: %.1f h, %.0f Wh",
+             snapshot->fan_on_today_s / 3600.0, snapshot->energy_today_wh);
+    gtk_label_set_text(GTK_LABEL(widgets->lbl_energy), energy_str);
+
+    // 3. GUI 스위치의 현재 상태와 데몬의 모드 상태가 다를 때만 업데이트
+    // 이렇게 하여 무한 시그널 루프를 방지하고, 원격 제어 상태를 GUI에 정확히 반영
+    if (gtk_switch_get_active(mode_switch) != is_manual_mode) {
+        // 콜백이 또 호출되는 것을 막기 위해 잠시 시그널 핸들러를 비활성화
+        g_signal_handlers_block_by_func(mode_switch, G_CALLBACK(on_mode_switch_state_set), widgets);
+        gtk_switch_set_active(mode_switch, is_manual_mode);
+        // 다시 시그널 핸들러 활성화
+        g_signal_handlers_unblock_by_func(mode_switch, G_CALLBACK(on_mode_switch_state_set), widgets);
+        gtk_widget_set_sensitive(widgets->btn_manual_on, is_manual_mode);
+        gtk_widget_set_sensitive(widgets->btn_manual_off, is_manual_mode);
     }
-    g_mutex_unlock(&data->mutex);
 }
 
 // GUI를 생성하고 표시하는 메인 함수
 void create_gui(GtkApplication *app, gpointer user_data) {
-    // 전역 포인터와 지역 포인터를 모두 설정
-    g_shared_data = (SharedData*)user_data;
-    SharedData *data = (SharedData*)user_data;
-    GuiWidgets *widgets = data->widgets;
+    GuiWidgets *widgets = (GuiWidgets*)user_data;
 
     widgets->window = gtk_application_window_new(app);
     gtk_window_set_title(GTK_WINDOW(widgets->window), "Smart Ventilation System");
@@ -74,6 +113,7 @@ void create_gui(GtkApplication *app, gpointer user_data) {
     widgets->lbl_temp = gtk_label_new("temperature: --.- °C");
     widgets->lbl_humidity = gtk_label_new("humidity: --.- %");
     widgets->lbl_status = gtk_label_new("status: reseting...");
+    widgets->lbl_energy = gtk_label_new("Fan today: -- h, -- Wh");
     widgets->switch_mode = gtk_switch_new();
     GtkWidget *lbl_mode_auto = gtk_label_new("auto");
     GtkWidget *lbl_mode_manual = gtk_label_new("manual");
@@ -89,15 +129,16 @@ void create_gui(GtkApplication *app, gpointer user_data) {
     gtk_grid_attach(GTK_GRID(grid), lbl_mode_manual, 2, 3, 1, 1);
     gtk_grid_attach(GTK_GRID(grid), widgets->btn_manual_on, 0, 4, 2, 1);
     gtk_grid_attach(GTK_GRID(grid), widgets->btn_manual_off, 2, 4, 2, 1);
+    gtk_grid_attach(GTK_GRID(grid), widgets->lbl_energy, 0, 5, 4, 1);
 
-    // 모든 시그널 연결 시 세 번째 인자로 NULL 대신 'data' 포인터를 전달
-    g_signal_connect(widgets->switch_mode, "state-set", G_CALLBACK(on_mode_switch_state_set), data);
-    g_signal_connect(widgets->btn_manual_on, "clicked", G_CALLBACK(on_manual_on_clicked), data);
-    g_signal_connect(widgets->btn_manual_off, "clicked", G_CALLBACK(on_manual_off_clicked), data);
+    // 모든 시그널 연결 시 세 번째 인자로 위젯 구조체 포인터를 전달
+    g_signal_connect(widgets->switch_mode, "state-set", G_CALLBACK(on_mode_switch_state_set), widgets);
+    g_signal_connect(widgets->btn_manual_on, "clicked", G_CALLBACK(on_manual_on_clicked), widgets);
+    g_signal_connect(widgets->btn_manual_off, "clicked", G_CALLBACK(on_manual_off_clicked), widgets);
 
     gtk_switch_set_active(GTK_SWITCH(widgets->switch_mode), FALSE);
     gtk_widget_set_sensitive(widgets->btn_manual_on, FALSE);
     gtk_widget_set_sensitive(widgets->btn_manual_off, FALSE);
 
     gtk_widget_show_all(widgets->window);
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define GUI_H
 
 #include <gtk/gtk.h>
+#include "status_snapshot.h"
 
 // GUI 위젯들의 포인터를 담을 구조체
 typedef struct {
@@ -9,30 +10,22 @@ typedef struct {
     GtkWidget *lbl_temp;
     GtkWidget *lbl_humidity;
     GtkWidget *lbl_status;
+    GtkWidget *lbl_energy;
     GtkWidget *switch_mode;
     GtkWidget *btn_manual_on;
     GtkWidget *btn_manual_off;
 } GuiWidgets;
 
-// 시스템의 작동 모드
-typedef enum { AUTOMATIC, MANUAL } SystemMode;
+// GUI 클라이언트는 제어 데몬과 별도 프로세스로 실행된다.
+// 상태는 데몬이 공유 메모리에 게시한 스냅샷을 읽고, 조작은 원격 제어 FIFO로 명령을 보낸다.
 
-// 스레드 간에 공유될 데이터 구조체
-typedef struct {
-    float temperature;
-    float humidity;
-    SystemMode mode;
-    gboolean is_running;          // 팬 작동 여부
-    gboolean is_alert_active;     // 경고 활성화 상태
-    gboolean new_data_available;  // 새 센서 데이터 수신 플래그
-    GuiWidgets *widgets;          // GUI 위젯 포인터
-    GMutex mutex;                 // 데이터 보호를 위한 뮤텍스
-} SharedData;
-
-// GUI 생성 함수 프로토타입
+// GUI 생성 함수 프로토타입 (user_data: GuiWidgets*)
 void create_gui(GtkApplication *app, gpointer user_data);
 
+// 스냅샷으로 위젯 갱신 (connected가 FALSE면 데몬 연결 끊김 표시)
+void gui_refresh(GuiWidgets *widgets, const StatusSnapshot *snapshot, gboolean connected);
+
 // gui.c에 정의된 콜백 함수를 다른 파일에서도 알 수 있도록 공개적으로 선언
 void on_mode_switch_state_set(GtkSwitch *sw, gboolean state, gpointer user_data);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include "gui.h"
+#include "status_snapshot.h"
+#include "proc_stats.h"
+
+// 제어 데몬과 분리된 GUI 클라이언트
+// 데몬이 공유 메모리에 게시한 상태 스냅샷을 주기적으로 읽어 화면을 갱신하고,
+// 버튼/스위치 조작은 원격 제어 FIFO로 데몬에 전달한다. GUI가 종료되거나 비정상 종료되어도
+// 환기 제어는 데몬에서 계속된다.
+
+#define REFRESH_INTERVAL_MS 500
+#define STALE_REFRESHES     30 // 이 횟수(15초) 동안 스냅샷이 바뀌지 않으면 데몬 재시작 여부 확인
+
+static GuiWidgets g_widgets;
+static gboolean g_attached = FALSE;
+static uint32_t g_last_version = 0;
+static int g_unchanged = 0;
+
+// 주기적으로 스냅샷을 확인 (버전이 바뀐 경우에만 위젯 갱신)
+static gboolean poll_status(gpointer user_data) {
+    StatusSnapshot snapshot;
+
+    if (!g_attached || g_unchanged >= STALE_REFRESHES) {
+        // 데몬이 아직 없거나 재시작되어 공유 메모리가 새로 만들어졌을 수 있으므로 다시 연결
+        g_attached = snapshot_attach(SNAPSHOT_SHM_NAME) == 0;
+        g_unchanged = 0;
+        g_last_version = 0;
+        if (!g_attached) {
+            gui_refresh(&g_widgets, NULL, FALSE);
+            return G_SOURCE_CONTINUE;
+        }
+    }
+
+    snapshot_read(&snapshot);
+    if (snapshot.version != g_last_version) {
+        g_last_version = snapshot.version;
+        g_unchanged = 0;
+        gui_refresh(&g_widgets, &snapshot, TRUE);
+    } else {
+        g_unchanged++;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_activate(GtkApplication *app, gpointer user_data) {
+    create_gui(app, &g_widgets);
+    poll_status(NULL);
+    g_timeout_add(REFRESH_INTERVAL_MS, poll_status, NULL);
+    proc_report_startup("GUI");
+}
+
+int main(int argc, char *argv[]) {
+    GtkApplication *app = gtk_application_new("com.rpi.smartvent", G_APPLICATION_FLAGS_NONE);
+    g_signal_connect(app, "activate", G_CALLBACK(on_activate), NULL);
+
+    int status = g_application_run(G_APPLICATION(app), argc, argv);
+
+    g_object_unref(app);
+    snapshot_detach();
+    return status;
+}
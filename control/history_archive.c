@@ -0,0 +1,735 @@
+#include "history_archive.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define ARCHIVE_MAGIC   0x31415653u // "SVA1"
+#define ARCHIVE_VERSION 1
+
+enum { COL_TIMESTAMP, COL_TEMPERATURE, COL_HUMIDITY, COL_STATE, COL_COUNT };
+
+/* --- 비트 스트림 --- */
+
+typedef struct {
+    uint8_t *buf;
+    size_t cap;
+    size_t bitpos;
+    int overflow;
+} BitWriter;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t size;
+    size_t bitpos;
+    int overflow;
+} BitReader;
+
+// value의 하위 nbits 비트를 MSB부터 기록
+static void bw_put(BitWriter *w, uint64_t value, int nbits) {
+    while (nbits > 0) {
+        size_t byte = w->bitpos >> 3;
+        int used = w->bitpos & 7;
+        int room = 8 - used;
+        int take = nbits < room ? nbits : room;
+
+        if (byte >= w->cap) {
+            w->overflow = 1;
+            return;
+        }
+        if (used == 0) w->buf[byte] = 0;
+
+        uint8_t chunk = (uint8_t)((value >> (nbits - take)) & ((1u << take) - 1));
+        w->buf[byte] |= (uint8_t)(chunk << (room - take));
+        w->bitpos += take;
+        nbits -= take;
+    }
+}
+
+static uint64_t br_get(BitReader *r, int nbits) {
+    uint64_t value = 0;
+    while (nbits > 0) {
+        size_t byte = r->bitpos >> 3;
+        int used = r->bitpos & 7;
+        int room = 8 - used;
+        int take = nbits < room ? nbits : room;
+
+        if (byte >= r->size) {
+            r->overflow = 1;
+            return 0;
+        }
+
+        uint8_t chunk = (uint8_t)((r->buf[byte] >> (room - take)) & ((1u << take) - 1));
+        value = (value << take) | chunk;
+        r->bitpos += take;
+        nbits -= take;
+    }
+    return value;
+}
+
+static size_t bw_bytes(const BitWriter *w) {
+    return (w->bitpos + 7) >> 3;
+}
+
+/* --- 리틀 엔디언 직렬화 --- */
+
+static void put_u16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put_u32(uint8_t *p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = v >> (8 * i); }
+static void put_u64(uint8_t *p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = v >> (8 * i); }
+static uint16_t get_u16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint32_t crc32(const uint8_t *data, size_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+/* --- 타임스탬프 컬럼: delta-of-delta --- */
+
+static void encode_timestamps(BitWriter *w, const ArchiveSample *s, int count) {
+    // 첫 값은 헤더에 저장되므로 두 번째 샘플부터 기록
+    int64_t prev = s[0].timestamp;
+    int64_t prev_delta = 0;
+    for (int i = 1; i < count; i++) {
+        int64_t delta = s[i].timestamp - prev;
+        int64_t dod = delta - prev_delta;
+
+        if (dod == 0) {
+            bw_put(w, 0x0, 1);
+        } else if (dod >= -63 && dod <= 64) {
+            bw_put(w, 0x2, 2);
+            bw_put(w, (uint64_t)(dod + 63), 7);
+        } else if (dod >= -255 && dod <= 256) {
+            bw_put(w, 0x6, 3);
+            bw_put(w, (uint64_t)(dod + 255), 9);
+        } else if (dod >= -2047 && dod <= 2048) {
+            bw_put(w, 0xE, 4);
+            bw_put(w, (uint64_t)(dod + 2047), 12);
+        } else {
+            bw_put(w, 0xF, 4);
+            bw_put(w, (uint64_t)dod, 64);
+        }
+        prev = s[i].timestamp;
+        prev_delta = delta;
+    }
+}
+
+static void decode_timestamps(BitReader *r, int64_t first, ArchiveSample *out, int count) {
+    int64_t prev = first;
+    int64_t prev_delta = 0;
+    out[0].timestamp = first;
+    for (int i = 1; i < count; i++) {
+        int64_t dod;
+        if (br_get(r, 1) == 0) {
+            dod = 0;
+        } else if (br_get(r, 1) == 0) {
+            dod = (int64_t)br_get(r, 7) - 63;
+        } else if (br_get(r, 1) == 0) {
+            dod = (int64_t)br_get(r, 9) - 255;
+        } else if (br_get(r, 1) == 0) {
+            dod = (int64_t)br_get(r, 12) - 2047;
+        } else {
+            dod = (int64_t)br_get(r, 64);
+        }
+        prev_delta += dod;
+        prev += prev_delta;
+        out[i].timestamp = prev;
+    }
+}
+
+/* --- 실수 컬럼: XOR 압축 --- */
+
+static uint32_t float_bits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bits_float(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// offset: ArchiveSample 안에서 해당 float 필드의 위치
+static void encode_floats(BitWriter *w, const ArchiveSample *s, int count, size_t offset) {
+    uint32_t prev = float_bits(*(const float *)((const uint8_t *)&s[0] + offset));
+    int prev_lead = -1, prev_trail = 0;
+
+    bw_put(w, prev, 32);
+    for (int i = 1; i < count; i++) {
+        uint32_t cur = float_bits(*(const float *)((const uint8_t *)&s[i] + offset));
+        uint32_t x = cur ^ prev;
+
+        if (x == 0) {
+            bw_put(w, 0x0, 1);
+        } else {
+            int lead = __builtin_clz(x);
+            int trail = __builtin_ctz(x);
+            if (lead > 31) lead = 31;
+
+            if (prev_lead >= 0 && lead >= prev_lead && trail >= prev_trail) {
+                // 이전 유효 비트 구간 안에 들어가면 구간 정보 재사용
+                int len = 32 - prev_lead - prev_trail;
+                bw_put(w, 0x2, 2);
+                bw_put(w, x >> prev_trail, len);
+            } else {
+                int len = 32 - lead - trail;
+                bw_put(w, 0x3, 2);
+                bw_put(w, lead, 5);
+                bw_put(w, len - 1, 5);
+                bw_put(w, x >> trail, len);
+                prev_lead = lead;
+                prev_trail = trail;
+            }
+        }
+        prev = cur;
+    }
+}
+
+static void decode_floats(BitReader *r, ArchiveSample *out, int count, size_t offset) {
+    uint32_t prev = (uint32_t)br_get(r, 32);
+    int prev_lead = 0, prev_trail = 0;
+
+    *(float *)((uint8_t *)&out[0] + offset) = bits_float(prev);
+    for (int i = 1; i < count; i++) {
+        if (br_get(r, 1) != 0) {
+            if (br_get(r, 1) != 0) {
+                prev_lead = (int)br_get(r, 5);
+                int len = (int)br_get(r, 5) + 1;
+                prev_trail = 32 - prev_lead - len;
+                if (prev_trail < 0) {
+                    r->overflow = 1;
+                    return;
+                }
+            }
+            int len = 32 - prev_lead - prev_trail;
+            prev ^= (uint32_t)br_get(r, len) << prev_trail;
+        }
+        *(float *)((uint8_t *)&out[i] + offset) = bits_float(prev);
+    }
+}
+
+/* --- 상태 컬럼: 런 렝스 인코딩 --- */
+
+static void put_varint(BitWriter *w, uint32_t v) {
+    while (v >= 0x80) {
+        bw_put(w, (v & 0x7F) | 0x80, 8);
+        v >>= 7;
+    }
+    bw_put(w, v, 8);
+}
+
+static uint32_t get_varint(BitReader *r) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint32_t b = (uint32_t)br_get(r, 8);
+        v |= (b & 0x7F) << shift;
+        if (!(b & 0x80)) return v;
+    }
+    r->overflow = 1;
+    return 0;
+}
+
+static uint8_t pack_state(const ArchiveSample *s) {
+    return (uint8_t)((s->fan_on ? 1 : 0) | (s->mode << 1));
+}
+
+static void encode_states(BitWriter *w, const ArchiveSample *s, int count) {
+    int i = 0;
+    while (i < count) {
+        uint8_t state = pack_state(&s[i]);
+        int run = 1;
+        while (i + run < count && pack_state(&s[i + run]) == state) run++;
+        bw_put(w, state, 8);
+        put_varint(w, run);
+        i += run;
+    }
+}
+
+static void decode_states(BitReader *r, ArchiveSample *out, int count) {
+    int i = 0;
+    while (i < count && !r->overflow) {
+        uint8_t state = (uint8_t)br_get(r, 8);
+        uint32_t run = get_varint(r);
+        if (run == 0 || run > (uint32_t)(count - i)) {
+            r->overflow = 1;
+            return;
+        }
+        for (uint32_t k = 0; k < run; k++, i++) {
+            out[i].fan_on = state & 1;
+            out[i].mode = state >> 1;
+        }
+    }
+}
+
+/* --- 블록 --- */
+
+size_t archive_encode_block(const ArchiveSample *samples, int count, uint8_t *out, size_t out_size) {
+    if (count <= 0 || count > ARCHIVE_BLOCK_SAMPLES || out_size < ARCHIVE_HEADER_SIZE) return 0;
+
+    uint8_t *payload = out + ARCHIVE_HEADER_SIZE;
+    size_t remaining = out_size - ARCHIVE_HEADER_SIZE;
+    uint32_t column_bytes[COL_COUNT];
+
+    for (int col = 0; col < COL_COUNT; col++) {
+        BitWriter w = { payload, remaining, 0, 0 };
+        switch (col) {
+        case COL_TIMESTAMP:   encode_timestamps(&w, samples, count); break;
+        case COL_TEMPERATURE: encode_floats(&w, samples, count, offsetof(ArchiveSample, temperature)); break;
+        case COL_HUMIDITY:    encode_floats(&w, samples, count, offsetof(ArchiveSample, humidity)); break;
+        case COL_STATE:       encode_states(&w, samples, count); break;
+        }
+        if (w.overflow) return 0;
+        column_bytes[col] = (uint32_t)bw_bytes(&w);
+        payload += column_bytes[col];
+        remaining -= column_bytes[col];
+    }
+
+    size_t payload_size = payload - (out + ARCHIVE_HEADER_SIZE);
+
+    put_u32(out, ARCHIVE_MAGIC);
+    out[4] = ARCHIVE_VERSION;
+    out[5] = 0; // 예약
+    put_u16(out + 6, (uint16_t)count);
+    put_u64(out + 8, (uint64_t)samples[0].timestamp);
+    put_u64(out + 16, (uint64_t)samples[count - 1].timestamp);
+    for (int col = 0; col < COL_COUNT; col++) put_u32(out + 24 + 4 * col, column_bytes[col]);
+    put_u32(out + 40, crc32(out + ARCHIVE_HEADER_SIZE, payload_size));
+
+    return ARCHIVE_HEADER_SIZE + payload_size;
+}
+
+int archive_parse_header(const uint8_t *buf, size_t size, ArchiveBlockHeader *header) {
+    if (size < ARCHIVE_HEADER_SIZE) return -1;
+    if (get_u32(buf) != ARCHIVE_MAGIC || buf[4] != ARCHIVE_VERSION) return -1;
+
+    header->count = get_u16(buf + 6);
+    header->first_timestamp = (int64_t)get_u64(buf + 8);
+    header->last_timestamp = (int64_t)get_u64(buf + 16);
+    for (int col = 0; col < COL_COUNT; col++) header->column_bytes[col] = get_u32(buf + 24 + 4 * col);
+    header->crc = get_u32(buf + 40);
+
+    if (header->count == 0 || header->count > ARCHIVE_BLOCK_SAMPLES) return -1;
+    return 0;
+}
+
+static size_t payload_size_of(const ArchiveBlockHeader *header) {
+    size_t total = 0;
+    for (int col = 0; col < COL_COUNT; col++) total += header->column_bytes[col];
+    return total;
+}
+
+// buf에서 시작하는 블록의 전체 크기 (헤더가 잘못됐거나 size 안에 다 들어 있지 않으면 0)
+// check_crc가 아니면 헤더만 확인하므로, 기록 도중 중단된 블록도 통과할 수 있다.
+static size_t block_extent(const uint8_t *buf, size_t size, ArchiveBlockHeader *header, int check_crc) {
+    if (archive_parse_header(buf, size, header) != 0) return 0;
+    size_t block_size = ARCHIVE_HEADER_SIZE + payload_size_of(header);
+    if (block_size > ARCHIVE_BLOCK_MAX_BYTES || block_size > size) return 0;
+    if (check_crc && crc32(buf + ARCHIVE_HEADER_SIZE, block_size - ARCHIVE_HEADER_SIZE) != header->crc) return 0;
+    return block_size;
+}
+
+// buf[0..size)에서 블록 시작 표시(magic)가 처음 나오는 위치 (없으면 size)
+static size_t find_magic(const uint8_t *buf, size_t size) {
+    for (size_t i = 0; i + 4 <= size; i++) {
+        if (buf[i] == (ARCHIVE_MAGIC & 0xFF) && get_u32(buf + i) == ARCHIVE_MAGIC) return i;
+    }
+    return size;
+}
+
+// start 이후 처음으로 헤더와 CRC가 모두 맞는 블록 위치 (없으면 size)
+// 손상된 구간 뒤에 이어 기록된 블록을 다시 찾는 데 사용
+static size_t next_valid_block(const uint8_t *base, size_t size, size_t start) {
+    ArchiveBlockHeader header;
+    while (start < size) {
+        start += find_magic(base + start, size - start);
+        if (start >= size) break;
+        if (block_extent(base + start, size - start, &header, 1) > 0) return start;
+        start++;
+    }
+    return size;
+}
+
+int archive_decode_block(const uint8_t *block, size_t size, ArchiveSample *out, int max_samples) {
+    ArchiveBlockHeader header;
+    if (archive_parse_header(block, size, &header) != 0) return -1;
+    if (header.count > max_samples) return -1;
+
+    size_t payload_size = payload_size_of(&header);
+    if (ARCHIVE_HEADER_SIZE + payload_size > size) return -1;
+
+    const uint8_t *payload = block + ARCHIVE_HEADER_SIZE;
+    if (crc32(payload, payload_size) != header.crc) return -1;
+
+    int count = header.count;
+    for (int col = 0; col < COL_COUNT; col++) {
+        BitReader r = { payload, header.column_bytes[col], 0, 0 };
+        switch (col) {
+        case COL_TIMESTAMP:   decode_timestamps(&r, header.first_timestamp, out, count); break;
+        case COL_TEMPERATURE: decode_floats(&r, out, count, offsetof(ArchiveSample, temperature)); break;
+        case COL_HUMIDITY:    decode_floats(&r, out, count, offsetof(ArchiveSample, humidity)); break;
+        case COL_STATE:       decode_states(&r, out, count); break;
+        }
+        if (r.overflow) return -1;
+        payload += header.column_bytes[col];
+    }
+    return count;
+}
+
+/* --- 파일 기록 --- */
+
+struct ArchiveWriter {
+    FILE *fp;
+    ArchiveSample samples[ARCHIVE_BLOCK_SAMPLES];
+    int count;
+    uint8_t block[ARCHIVE_BLOCK_MAX_BYTES];
+};
+
+// 마지막 온전한 블록의 끝 위치
+// 헤더를 따라가다 사슬이 끊기면 마지막 블록 안쪽부터 다음 온전한 블록을 찾고,
+// 끝 블록은 내용(CRC)까지 확인한다 (기록 도중 전원이 나가면 끝 블록만 깨짐).
+static size_t valid_end(const uint8_t *base, size_t size) {
+    ArchiveBlockHeader header;
+    size_t offset = 0, end = 0, last = 0;
+    int have_last = 0;
+    while (offset < size) {
+        size_t block_size = block_extent(base + offset, size - offset, &header, 0);
+        if (block_size == 0) {
+            // 직전 블록의 크기 자체가 잘못됐을 수 있으므로 그 블록 안쪽부터 다시 찾음
+            offset = next_valid_block(base, size, (have_last ? last : offset) + 1);
+            if (offset >= size) break;
+            continue;
+        }
+        last = offset;
+        have_last = 1;
+        offset += block_size;
+        end = offset;
+    }
+    if (have_last && block_extent(base + last, size - last, &header, 1) == 0) end = last;
+    return end;
+}
+
+// 기록 도중 중단된 끝 블록을 잘라냄 (그 뒤에 새 블록을 붙이면 읽는 쪽이 건너뛰어야 하므로)
+static int trim_torn_tail(const char *path) {
+    int fd = open(path, O_RDWR);
+    if (fd == -1) return errno == ENOENT ? 0 : -1;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("[Error] mmap failed");
+        close(fd);
+        return -1;
+    }
+    size_t end = valid_end(base, size);
+    munmap(base, size);
+
+    int ret = 0;
+    if (size - end > ARCHIVE_BLOCK_MAX_BYTES) {
+        // 중단된 기록 하나보다 크면 잘라내지 않음 (아카이브가 아닌 파일일 수 있음)
+        fprintf(stderr, "[Archive] %s ends with %zu bytes that are not archive blocks, leaving them in place\n", path,
+                size - end);
+    } else if (end < size) {
+        fprintf(stderr, "[Archive] Removing %zu bytes of incomplete data at the end of %s\n", size - end, path);
+        if (ftruncate(fd, (off_t)end) == -1) {
+            perror("[Error] Failed to truncate history archive");
+            ret = -1;
+        }
+    }
+    close(fd);
+    return ret;
+}
+
+ArchiveWriter *archive_writer_open(const char *path) {
+    ArchiveWriter *writer = malloc(sizeof(ArchiveWriter));
+    if (writer == NULL) return NULL;
+
+    trim_torn_tail(path); // 실패해도 추가 기록은 진행 (읽는 쪽이 손상 구간을 건너뜀)
+    writer->fp = fopen(path, "ab");
+    if (writer->fp == NULL) {
+        perror("[Error] Failed to open history archive");
+        free(writer);
+        return NULL;
+    }
+    writer->count = 0;
+    return writer;
+}
+
+int archive_writer_flush(ArchiveWriter *writer) {
+    if (writer == NULL || writer->count == 0) return 0;
+
+    size_t len = archive_encode_block(writer->samples, writer->count, writer->block, sizeof(writer->block));
+    writer->count = 0;
+    if (len == 0) {
+        fprintf(stderr, "[Archive] Failed to encode block.\n");
+        return -1;
+    }
+    if (fwrite(writer->block, 1, len, writer->fp) != len || fflush(writer->fp) != 0) {
+        perror("[Error] Failed to write history archive");
+        return -1;
+    }
+    return 0;
+}
+
+int archive_writer_append(ArchiveWriter *writer, const ArchiveSample *sample) {
+    if (writer == NULL) return -1;
+
+    // 시간이 되돌아간 경우 새 블록에서 시작 (블록 내부는 단조 증가 유지)
+    if (writer->count > 0 && sample->timestamp < writer->samples[writer->count - 1].timestamp) {
+        if (archive_writer_flush(writer) != 0) return -1;
+    }
+
+    writer->samples[writer->count++] = *sample;
+
+    // 블록이 가득 찼거나 일정 시간이 지나면 디스크에 기록 (비정상 종료 시 손실 최소화)
+    if (writer->count == ARCHIVE_BLOCK_SAMPLES ||
+        sample->timestamp - writer->samples[0].timestamp >= ARCHIVE_BLOCK_MAX_SPAN) {
+        return archive_writer_flush(writer);
+    }
+    return 0;
+}
+
+void archive_writer_close(ArchiveWriter *writer) {
+    if (writer == NULL) return;
+    archive_writer_flush(writer);
+    fclose(writer->fp);
+    free(writer);
+}
+
+/* --- 스트리밍 읽기 --- */
+
+struct ArchiveReader {
+    FILE *fp;
+    ArchiveSample samples[ARCHIVE_BLOCK_SAMPLES];
+    int count;
+    int index;
+    uint8_t buf[ARCHIVE_BLOCK_MAX_BYTES]; // 파일에서 읽은 바이트 중 [start, end)가 아직 처리 전
+    size_t start;
+    size_t end;
+    int eof;
+    size_t skipped;                       // 건너뛴 손상 구간 크기 (다음 블록을 찾으면 보고)
+};
+
+ArchiveReader *archive_reader_open(const char *path) {
+    ArchiveReader *reader = malloc(sizeof(ArchiveReader));
+    if (reader == NULL) return NULL;
+
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL) {
+        perror("[Error] Failed to open history archive");
+        free(reader);
+        return NULL;
+    }
+    reader->count = 0;
+    reader->index = 0;
+    reader->start = reader->end = 0;
+    reader->eof = 0;
+    reader->skipped = 0;
+    return reader;
+}
+
+// 남은 바이트를 버퍼 앞으로 당기고 파일에서 채움 (처리 전 바이트 수 반환)
+static size_t reader_fill(ArchiveReader *reader) {
+    if (reader->start > 0) {
+        memmove(reader->buf, reader->buf + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    if (!reader->eof) {
+        reader->end += fread(reader->buf + reader->end, 1, sizeof(reader->buf) - reader->end, reader->fp);
+        if (reader->end < sizeof(reader->buf)) reader->eof = 1;
+    }
+    return reader->end;
+}
+
+// 다음 온전한 블록을 읽어 디코딩 (1: 성공, 0: 파일 끝, -1: 읽기 오류)
+// 헤더나 CRC가 맞지 않으면 다음 블록 시작 표시를 찾아 이어서 읽는다 (중간에 잘린 블록 뒤에 추가된 블록 포함).
+static int reader_load_block(ArchiveReader *reader) {
+    ArchiveBlockHeader header;
+
+    for (;;) {
+        size_t avail = reader->end - reader->start;
+        if (avail < ARCHIVE_HEADER_SIZE && !reader->eof) avail = reader_fill(reader);
+        if (ferror(reader->fp)) {
+            perror("[Error] Failed to read history archive");
+            return -1;
+        }
+        if (avail == 0) break;
+
+        const uint8_t *block = reader->buf + reader->start;
+        size_t block_size = 0;
+        if (archive_parse_header(block, avail, &header) == 0) {
+            size_t want = ARCHIVE_HEADER_SIZE + payload_size_of(&header);
+            if (want > avail && want <= ARCHIVE_BLOCK_MAX_BYTES && !reader->eof) {
+                avail = reader_fill(reader);
+                block = reader->buf;
+            }
+            block_size = block_extent(block, avail, &header, 1);
+        }
+        if (block_size > 0) {
+            if (reader->skipped > 0) {
+                fprintf(stderr, "[Archive] Skipped %zu bytes of damaged data.\n", reader->skipped);
+                reader->skipped = 0;
+            }
+            reader->count = archive_decode_block(block, block_size, reader->samples, ARCHIVE_BLOCK_SAMPLES);
+            reader->index = 0;
+            reader->start += block_size;
+            if (reader->count < 0) reader->count = 0;
+            return 1;
+        }
+
+        // 다음 시작 표시까지 건너뜀 (버퍼 끝의 3바이트는 표시가 걸쳐 있을 수 있어 남김)
+        size_t next = 1 + find_magic(block + 1, avail - 1);
+        if (next >= avail && !reader->eof && avail > 3) next = avail - 3;
+        reader->skipped += next;
+        reader->start += next;
+        if (next >= avail && reader->eof) break;
+    }
+    if (reader->skipped > 0) {
+        // 기록 중이거나 기록 도중 중단된 마지막 블록
+        fprintf(stderr, "[Archive] Ignoring %zu bytes of incomplete data at the end of the file.\n", reader->skipped);
+        reader->skipped = 0;
+    }
+    return 0;
+}
+
+int archive_reader_next(ArchiveReader *reader, ArchiveSample *sample) {
+    while (reader->index >= reader->count) {
+        int ret = reader_load_block(reader);
+        if (ret <= 0) return ret;
+    }
+    *sample = reader->samples[reader->index++];
+    return 1;
+}
+
+void archive_reader_close(ArchiveReader *reader) {
+    if (reader == NULL) return;
+    fclose(reader->fp);
+    free(reader);
+}
+
+struct ArchiveMap {
+    const uint8_t *base;
+    size_t size;
+    size_t offset;   // 다음 블록 위치
+    size_t resync;   // 다음 헤더가 깨졌을 때 온전한 블록을 다시 찾기 시작할 위치
+    size_t released; // 이미 반납한 앞부분 (페이지 단위)
+    size_t page_size;
+};
+
+ArchiveMap *archive_map_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        perror("[Error] Failed to open history archive");
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        perror("[Error] fstat failed");
+        close(fd);
+        return NULL;
+    }
+
+    ArchiveMap *map = calloc(1, sizeof(ArchiveMap));
+    if (map == NULL) {
+        close(fd);
+        return NULL;
+    }
+    map->size = (size_t)st.st_size;
+    map->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    if (map->size > 0) {
+        void *base = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            perror("[Error] mmap failed");
+            close(fd);
+            free(map);
+            return NULL;
+        }
+        madvise(base, map->size, MADV_SEQUENTIAL);
+        map->base = base;
+    }
+    close(fd); // 매핑은 fd를 닫아도 유지됨
+    return map;
+}
+
+// 이미 지나간 페이지를 반납해 상주 메모리가 파일 크기에 비례해 늘지 않게 함
+static void map_release_consumed(ArchiveMap *map) {
+    size_t end = map->offset & ~(map->page_size - 1);
+    if (end >= map->released + 64 * map->page_size) {
+        madvise((void *)(map->base + map->released), end - map->released, MADV_DONTNEED);
+        map->released = end;
+    }
+}
+
+// 손상된 구간 다음의 온전한 블록으로 이동 (없으면 끝)
+static void map_resync(ArchiveMap *map, size_t from) {
+    size_t next = next_valid_block(map->base, map->size, from);
+    if (next < map->size) {
+        fprintf(stderr, "[Archive] Damaged block at offset %zu, resuming at %zu.\n", from - 1, next);
+    } else if (map->offset < map->size) {
+        // 기록 중이거나 기록 도중 중단된 마지막 블록
+        fprintf(stderr, "[Archive] Ignoring incomplete data at the end of the archive.\n");
+    }
+    map->offset = next;
+    map->resync = next;
+}
+
+int archive_map_next_block(ArchiveMap *map, int64_t from, int64_t to, ArchiveSample *out) {
+    ArchiveBlockHeader header;
+
+    while (map->offset < map->size) {
+        map_release_consumed(map);
+        const uint8_t *block = map->base + map->offset;
+        size_t block_size = block_extent(block, map->size - map->offset, &header, 0);
+        if (block_size == 0) {
+            map_resync(map, map->resync == map->offset ? map->offset + 1 : map->resync);
+            continue;
+        }
+
+        // 구간과 겹치지 않는 블록은 헤더만 보고 건너뜀
+        // (CRC를 보지 않았으므로 크기가 틀렸다면 이 블록 안쪽부터 다시 찾아야 함)
+        if (header.last_timestamp < from || header.first_timestamp > to) {
+            map->resync = map->offset + 1;
+            map->offset += block_size;
+            continue;
+        }
+
+        int count = archive_decode_block(block, block_size, out, ARCHIVE_BLOCK_SAMPLES);
+        if (count < 0) {
+            map_resync(map, map->offset + 1);
+            continue;
+        }
+        map->offset += block_size;
+        map->resync = map->offset;
+        return count;
+    }
+    return 0;
+}
+
+void archive_map_close(ArchiveMap *map) {
+    if (map == NULL) return;
+    if (map->base != NULL) munmap((void *)map->base, map->size);
+    free(map);
+}
@@ -0,0 +1,82 @@
+#ifndef HISTORY_ARCHIVE_H
+#define HISTORY_ARCHIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 센서 이력 장기 보관용 압축 컬럼 아카이브
+//
+// 파일은 독립적으로 디코딩 가능한 블록들의 연속이며, 각 블록은 고정 크기 헤더
+// (시간 범위, 컬럼별 길이, CRC)와 다음 컬럼들로 구성된다.
+//   - 타임스탬프(초): delta-of-delta 가변 길이 비트 인코딩
+//   - 온도/습도(float): 이전 값과의 XOR 압축
+//   - 팬/모드 상태: 런 렝스 인코딩
+// 헤더만 읽고 블록을 건너뛸 수 있으므로 스트리밍 및 시간 범위 탐색이 가능하다.
+// 읽는 쪽은 헤더나 CRC가 맞지 않는 구간을 만나면 다음 블록 시작 표시(magic)와 CRC가 맞는 블록을
+// 찾아 이어서 읽으므로, 손상된 블록 하나 때문에 그 뒤의 기록을 잃지 않는다.
+
+#define ARCHIVE_BLOCK_SAMPLES    1024 // 블록당 최대 샘플 수
+#define ARCHIVE_BLOCK_MAX_SPAN   600  // 블록이 포함할 최대 시간(초), 이후 디스크에 기록
+#define ARCHIVE_HEADER_SIZE      44
+#define ARCHIVE_BLOCK_MAX_BYTES  (ARCHIVE_HEADER_SIZE + ARCHIVE_BLOCK_SAMPLES * 40)
+
+typedef struct {
+    int64_t timestamp;  // epoch 기준 초
+    float temperature;
+    float humidity;
+    uint8_t fan_on;     // 팬 작동 여부 (0/1)
+    uint8_t mode;       // SystemMode 값
+} ArchiveSample;
+
+// 블록 헤더 (디스크에는 리틀 엔디언으로 직렬화)
+typedef struct {
+    uint16_t count;
+    int64_t first_timestamp;
+    int64_t last_timestamp;
+    uint32_t column_bytes[4]; // 타임스탬프, 온도, 습도, 상태
+    uint32_t crc;
+} ArchiveBlockHeader;
+
+/* --- 블록 단위 인코딩/디코딩 --- */
+
+// 샘플 배열을 하나의 블록으로 인코딩. 기록된 바이트 수 반환 (실패 시 0)
+size_t archive_encode_block(const ArchiveSample *samples, int count, uint8_t *out, size_t out_size);
+
+// 헤더 파싱 (성공 시 0)
+int archive_parse_header(const uint8_t *buf, size_t size, ArchiveBlockHeader *header);
+
+// 블록 디코딩. 디코딩된 샘플 수 반환 (실패 시 -1)
+int archive_decode_block(const uint8_t *block, size_t size, ArchiveSample *out, int max_samples);
+
+/* --- 파일 기록 (제어 프로세스) --- */
+
+typedef struct ArchiveWriter ArchiveWriter;
+
+// 추가 모드로 열기 (기록 도중 중단되어 잘린 끝 블록은 먼저 잘라냄)
+ArchiveWriter *archive_writer_open(const char *path);
+int archive_writer_append(ArchiveWriter *writer, const ArchiveSample *sample);
+int archive_writer_flush(ArchiveWriter *writer); // 현재 블록을 디스크에 기록
+void archive_writer_close(ArchiveWriter *writer); // 남은 샘플 기록 후 닫기
+
+/* --- 스트리밍 읽기 --- */
+
+typedef struct ArchiveReader ArchiveReader;
+
+ArchiveReader *archive_reader_open(const char *path);
+int archive_reader_next(ArchiveReader *reader, ArchiveSample *sample); // 1: 샘플, 0: 끝, -1: 오류
+void archive_reader_close(ArchiveReader *reader);
+
+/* --- 메모리 매핑 구간 읽기 (내보내기용) --- */
+
+// 파일 전체를 mmap하고 블록 헤더의 시간 범위로 구간 밖 블록은 디코딩 없이 건너뛴다.
+// 한 번에 한 블록만 디코딩하고 지나간 페이지는 반납하므로, 1년치 파일도 일정한 메모리로 읽는다.
+// 열 때의 파일 크기까지만 보며, 기록 중인 마지막 블록이 잘려 있으면 파일 끝으로 취급한다.
+typedef struct ArchiveMap ArchiveMap;
+
+ArchiveMap *archive_map_open(const char *path);
+// [from, to] 구간과 겹치는 다음 블록을 out에 디코딩 (ARCHIVE_BLOCK_SAMPLES개 공간 필요)
+// 디코딩된 샘플 수 반환 (0: 끝, -1: 오류). 블록 안의 구간 밖 샘플은 호출자가 걸러야 한다.
+int archive_map_next_block(ArchiveMap *map, int64_t from, int64_t to, ArchiveSample *out);
+void archive_map_close(ArchiveMap *map);
+
+#endif
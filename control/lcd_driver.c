@@ -4,7 +4,7 @@
 #include <string.h>
 #include "lcd_driver.h" 
 
-void lcd_display_update(float temp, float humi)
+void lcd_display_update(const char *headline, float temp, float humi)
 {
    // Text LCD 디바이스 파일을 염
    int fd = open("/dev/fpga_text_lcd", O_WRONLY);
@@ -17,8 +17,8 @@ void lcd_display_update(float temp, float humi)
 
    char line1[17], line2[17], lcd_data[33] = {0};
 
-   if (temp >= 28.0 || humi >= 70.0) {
-      snprintf(line1, sizeof(line1), "FAN ON NOW!"); 
+   if (headline != NULL) {
+      snprintf(line1, sizeof(line1), "%s", headline);
       snprintf(line2, sizeof(line2), "T:%.1fC H:%.0f%%", temp, humi);  
    } else {
       snprintf(line1, sizeof(line1), "Temp: %.1f C", temp);
@@ -2,6 +2,7 @@
 #define LCD_DRIVER_H
 
 // 온도와 습도 값을 받아 Text LCD에 출력하는 함수
-void lcd_display_update(float temp, float humi);
+// headline이 있으면(경고 규칙의 LCD 문구) 첫 줄에 표시하고 둘째 줄에 온습도를 요약
+void lcd_display_update(const char *headline, float temp, float humi);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,413 @@
+#include "logger.h"
+#include "clock_source.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <signal.h>
+#include <syslog.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RING_MASK        (LOG_RING_SIZE - 1)
+#define DRAIN_INTERVAL_NS 20000000L // 20ms
+#define RATE_SLOTS       64
+#define LINE_LEN         256
+
+// 링 칸 (Vyukov 방식 다중 생산자 큐: 칸마다 순서 번호로 소유권 판단)
+typedef struct {
+    uint64_t seq;      // 칸 인덱스를 뺀 값으로 저장 (0으로 초기화된 상태가 "첫 바퀴 빈 칸")
+    double timestamp;
+    const char *fmt;
+    uint8_t level;
+    uint8_t nargs;
+    uint8_t types[LOG_MAX_ARGS];
+    union {
+        long long i;
+        double d;
+        const void *p;
+    } args[LOG_MAX_ARGS]; // 문자열 인자는 str 안의 오프셋
+    char str[LOG_STR_SPACE];
+} LogEntry;
+
+typedef struct {
+    const char *fmt;
+    double window_start;
+    int count;
+    int suppressed;
+} RateSlot;
+
+volatile int g_log_level = LOG_LEVEL_INFO;
+
+static LogEntry ring[LOG_RING_SIZE];
+static uint64_t enqueue_pos = 0;
+static uint64_t dequeue_pos = 0; // 드레인 스레드 전용
+static uint64_t dropped = 0;
+
+static int running = 0;
+static pthread_t drain_thread;
+static FILE *out_fp = NULL;   // 파일 또는 표준출력
+static int out_is_file = 0;
+static int use_syslog = 0;
+
+static RateSlot rate_slots[RATE_SLOTS]; // 드레인 스레드 전용
+
+static const char *level_names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+
+static uint64_t load_seq(size_t idx) {
+    return __atomic_load_n(&ring[idx].seq, __ATOMIC_ACQUIRE) + idx;
+}
+
+static void store_seq(size_t idx, uint64_t seq) {
+    __atomic_store_n(&ring[idx].seq, seq - idx, __ATOMIC_RELEASE);
+}
+
+static void fill_entry(LogEntry *e, int level, const char *fmt, const LogArg *args, int nargs) {
+    size_t str_used = 0;
+    if (nargs > LOG_MAX_ARGS) nargs = LOG_MAX_ARGS;
+
+    e->timestamp = clock_now();
+    e->fmt = fmt;
+    e->level = (uint8_t)level;
+    e->nargs = (uint8_t)nargs;
+    for (int k = 0; k < nargs; k++) {
+        e->types[k] = args[k].type;
+        switch (args[k].type) {
+        case LOG_ARG_DOUBLE: e->args[k].d = args[k].v.d; break;
+        case LOG_ARG_PTR:    e->args[k].p = args[k].v.p; break;
+        case LOG_ARG_STR: {
+            // 호출자의 버퍼는 곧 사라질 수 있으므로 남은 공간만큼 복사 (넘치면 잘림)
+            const char *s = args[k].v.s ? args[k].v.s : "(null)";
+            size_t room = sizeof(e->str) - str_used;
+            size_t n = strnlen(s, room ? room - 1 : 0);
+            e->args[k].i = (long long)str_used;
+            if (room > 0) {
+                memcpy(e->str + str_used, s, n);
+                e->str[str_used + n] = '\0';
+                str_used += n + 1;
+            } else {
+                e->args[k].i = -1;
+            }
+            break;
+        }
+        default:             e->args[k].i = args[k].v.i; break;
+        }
+    }
+}
+
+// 저장된 인자로 형식 문자열을 해석 (정수 변환은 long long, 실수는 double로 통일해 타입 불일치에도 안전)
+static int format_entry(const LogEntry *e, char *buf, size_t len) {
+    size_t used = 0;
+    int k = 0;
+    const char *f = e->fmt;
+
+    while (*f && used + 1 < len) {
+        if (*f != '%') {
+            buf[used++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            buf[used++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // 변환 명세: 플래그, 폭, 정밀도는 그대로 두고 길이 수정자는 버림
+        char spec[24];
+        size_t s = 0;
+        spec[s++] = *f++;
+        while (*f && strchr("-+ #0123456789.", *f) && s < sizeof(spec) - 4) spec[s++] = *f++;
+        while (*f && strchr("hlLqjzt", *f)) f++;
+        char conv = *f ? *f++ : 'd';
+
+        char piece[LINE_LEN];
+        int n;
+        int type = k < e->nargs ? e->types[k] : -1;
+        if (type < 0) {
+            n = snprintf(piece, sizeof(piece), "?");
+        } else if (strchr("diuxXoc", conv)) {
+            long long v = type == LOG_ARG_DOUBLE ? (long long)e->args[k].d : e->args[k].i;
+            if (conv == 'c') {
+                spec[s++] = 'c';
+                spec[s] = '\0';
+                n = snprintf(piece, sizeof(piece), spec, (int)v);
+            } else {
+                spec[s++] = 'l';
+                spec[s++] = 'l';
+                spec[s++] = conv;
+                spec[s] = '\0';
+                if (conv == 'd' || conv == 'i') n = snprintf(piece, sizeof(piece), spec, v);
+                else n = snprintf(piece, sizeof(piece), spec, (unsigned long long)v);
+            }
+        } else if (strchr("fFeEgGaA", conv)) {
+            double v = type == LOG_ARG_DOUBLE ? e->args[k].d : (double)e->args[k].i;
+            spec[s++] = conv;
+            spec[s] = '\0';
+            n = snprintf(piece, sizeof(piece), spec, v);
+        } else if (conv == 's') {
+            const char *v = (type == LOG_ARG_STR && e->args[k].i >= 0) ? e->str + e->args[k].i : "?";
+            spec[s++] = 's';
+            spec[s] = '\0';
+            n = snprintf(piece, sizeof(piece), spec, v);
+        } else {
+            n = snprintf(piece, sizeof(piece), "%p", type == LOG_ARG_PTR ? e->args[k].p : NULL);
+        }
+        k++;
+
+        if (n < 0) continue;
+        if ((size_t)n >= sizeof(piece)) n = sizeof(piece) - 1;
+        if (used + n >= len) n = len - used - 1;
+        memcpy(buf + used, piece, n);
+        used += n;
+    }
+    buf[used] = '\0';
+    return (int)used;
+}
+
+static void format_time(double timestamp, char *buf, size_t len) {
+    time_t sec = (time_t)timestamp;
+    struct tm tm;
+    localtime_r(&sec, &tm);
+    size_t n = strftime(buf, len, "%Y-%m-%d %H:%M:%S", &tm);
+    snprintf(buf + n, len - n, ".%03d", (int)((timestamp - sec) * 1000.0));
+}
+
+static void emit_text(int level, double timestamp, const char *text) {
+    if (use_syslog) {
+        static const int priorities[] = { LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERR };
+        syslog(priorities[level], "%s", text);
+    } else if (out_is_file) {
+        char when[40];
+        format_time(timestamp, when, sizeof(when));
+        fprintf(out_fp, "%s %-5s %s\n", when, level_names[level], text);
+    } else {
+        // 콘솔 출력은 기존 printf 출력과 같은 형식 유지
+        fprintf(out_fp ? out_fp : stdout, "%s\n", text);
+    }
+}
+
+static void emit_entry(const LogEntry *e) {
+    char text[LINE_LEN];
+    format_entry(e, text, sizeof(text));
+    // 형식 문자열 끝의 줄바꿈은 출력기가 붙이므로 제거
+    size_t n = strlen(text);
+    while (n > 0 && text[n - 1] == '\n') text[--n] = '\0';
+    emit_text(e->level, e->timestamp, text);
+}
+
+void logger_record(int level, const char *fmt, const LogArg *args, int nargs) {
+    if (!__atomic_load_n(&running, __ATOMIC_ACQUIRE)) {
+        // 로거 시작 전(또는 종료 후)에는 바로 출력
+        LogEntry e;
+        fill_entry(&e, level, fmt, args, nargs);
+        emit_entry(&e);
+        return;
+    }
+
+    uint64_t pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+    size_t idx;
+    for (;;) {
+        idx = pos & RING_MASK;
+        int64_t diff = (int64_t)(load_seq(idx) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&enqueue_pos, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (diff < 0) {
+            // 링이 가득 참: 제어 경로를 막지 않고 버림
+            __atomic_add_fetch(&dropped, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    fill_entry(&ring[idx], level, fmt, args, nargs);
+    store_seq(idx, pos + 1);
+}
+
+static void report_suppressed(RateSlot *slot, double timestamp) {
+    char text[LINE_LEN];
+    snprintf(text, sizeof(text), "[Log] %d similar messages suppressed: %.48s", slot->suppressed, slot->fmt);
+    char *nl = strchr(text, '\n');
+    if (nl) *nl = '\0';
+    emit_text(LOG_LEVEL_WARN, timestamp, text);
+    slot->suppressed = 0;
+}
+
+// 형식 문자열(호출 지점)별 초당 출력 수 제한
+static int rate_allow(const LogEntry *e) {
+    size_t h = ((uintptr_t)e->fmt >> 3) % RATE_SLOTS;
+    RateSlot *slot = NULL;
+    for (int probe = 0; probe < RATE_SLOTS; probe++) {
+        RateSlot *s = &rate_slots[(h + probe) % RATE_SLOTS];
+        if (s->fmt == e->fmt || s->fmt == NULL) {
+            slot = s;
+            break;
+        }
+    }
+    if (slot == NULL) return 1; // 표가 가득 차면 제한하지 않음
+
+    if (slot->fmt == NULL || e->timestamp - slot->window_start >= 1.0 || e->timestamp < slot->window_start) {
+        if (slot->fmt && slot->suppressed) report_suppressed(slot, e->timestamp);
+        slot->fmt = e->fmt;
+        slot->window_start = e->timestamp;
+        slot->count = 0;
+    }
+    if (slot->count < LOG_RATE_LIMIT) {
+        slot->count++;
+        return 1;
+    }
+    slot->suppressed++;
+    return 0;
+}
+
+static void drain_available(int final) {
+    LogEntry e;
+    int emitted = 0;
+
+    for (;;) {
+        uint64_t pos = dequeue_pos;
+        size_t idx = pos & RING_MASK;
+        if (load_seq(idx) != pos + 1) break;
+
+        memcpy(&e, &ring[idx], sizeof(e));
+        store_seq(idx, pos + LOG_RING_SIZE); // 다음 바퀴의 생산자에게 칸 반환
+        dequeue_pos = pos + 1;
+
+        if (rate_allow(&e)) {
+            emit_entry(&e);
+            emitted++;
+        }
+    }
+
+    // 창이 지난 뒤 더 이상 오지 않는 메시지의 억제 개수도 보고 (종료 시에는 모두)
+    double now = clock_now();
+    for (int i = 0; i < RATE_SLOTS; i++) {
+        if (rate_slots[i].suppressed && (final || now - rate_slots[i].window_start >= 1.0)) {
+            report_suppressed(&rate_slots[i], now);
+            emitted++;
+        }
+    }
+
+    uint64_t lost = __atomic_exchange_n(&dropped, 0, __ATOMIC_RELAXED);
+    if (lost) {
+        char text[64];
+        snprintf(text, sizeof(text), "[Log] %llu messages dropped (ring full)", (unsigned long long)lost);
+        emit_text(LOG_LEVEL_WARN, now, text);
+        emitted++;
+    }
+    if (emitted && out_fp) fflush(out_fp);
+}
+
+static void *drain_thread_func(void *arg) {
+    (void)arg;
+    struct timespec interval = { 0, DRAIN_INTERVAL_NS };
+    for (;;) {
+        // 종료 요청을 먼저 읽고 비운 뒤 빠져나가야 마지막 항목까지 출력됨
+        int stop = !__atomic_load_n(&running, __ATOMIC_ACQUIRE);
+        drain_available(stop);
+        if (stop) break;
+        // 가상 시계와 무관하게 실제 시간으로 대기 (시뮬레이터의 시간 진행에 참여하지 않음)
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}
+
+int logger_parse_level(const char *name) {
+    for (int i = 0; i < 4; i++) {
+        if (strcasecmp(name, level_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+void logger_set_level(LogLevel level) {
+    g_log_level = level;
+}
+
+int logger_start(const char *target, LogLevel level) {
+    int ret = 0;
+    g_log_level = level;
+    out_fp = stdout;
+    out_is_file = 0;
+    use_syslog = 0;
+
+    if (target && strcmp(target, "syslog") == 0) {
+        openlog("smart_vent", LOG_PID, LOG_DAEMON);
+        use_syslog = 1;
+    } else if (target && strcmp(target, "-") != 0) {
+        FILE *fp = fopen(target, "a");
+        if (fp) {
+            out_fp = fp;
+            out_is_file = 1;
+        } else {
+            perror("[Log] Failed to open log file, using stdout");
+            ret = -1;
+        }
+    }
+
+    __atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+    if (pthread_create(&drain_thread, NULL, drain_thread_func, NULL) != 0) {
+        perror("[Log] Failed to start drain thread, logging synchronously");
+        __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+    return ret;
+}
+
+void logger_stop() {
+    if (!__atomic_load_n(&running, __ATOMIC_ACQUIRE)) return;
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    pthread_join(drain_thread, NULL);
+
+    if (out_is_file) fclose(out_fp);
+    if (use_syslog) closelog();
+    out_fp = stdout;
+    out_is_file = 0;
+    use_syslog = 0;
+}
+
+void logger_dump_recent(int fd, int count) {
+    uint64_t end = __atomic_load_n(&enqueue_pos, __ATOMIC_ACQUIRE);
+    uint64_t start = end > (uint64_t)count ? end - count : 0;
+    LogEntry e;
+    char text[LINE_LEN], line[LINE_LEN + 48], when[40];
+
+    for (uint64_t pos = start; pos < end; pos++) {
+        size_t idx = pos & RING_MASK;
+        uint64_t seq = load_seq(idx);
+        // 기록 완료(미출력) 또는 출력 후 아직 덮어쓰이지 않은 칸만 사용
+        if (seq != pos + 1 && seq != pos + LOG_RING_SIZE) continue;
+        memcpy(&e, &ring[idx], sizeof(e));
+        format_entry(&e, text, sizeof(text));
+        format_time(e.timestamp, when, sizeof(when));
+        int n = snprintf(line, sizeof(line), "%s %-5s %s", when, level_names[e.level & 3], text);
+        if (n < 0) continue;
+        if (n >= (int)sizeof(line) - 1) n = sizeof(line) - 2;
+        if (n == 0 || line[n - 1] != '\n') line[n++] = '\n';
+        if (write(fd, line, n) < 0) return;
+    }
+}
+
+static void crash_handler(int sig) {
+    char head[96];
+    int n = snprintf(head, sizeof(head), "\n[Log] Fatal signal %d, last %d log entries:\n", sig, LOG_CRASH_ENTRIES);
+    if (write(STDERR_FILENO, head, n) >= 0) logger_dump_recent(STDERR_FILENO, LOG_CRASH_ENTRIES);
+    if (out_is_file) {
+        int fd = fileno(out_fp);
+        if (write(fd, head, n) >= 0) logger_dump_recent(fd, LOG_CRASH_ENTRIES);
+    }
+    // SA_RESETHAND로 기본 동작이 복원되어 있으므로 다시 발생시켜 코어 덤프/종료 코드 유지
+    raise(sig);
+}
+
+void logger_install_crash_handler() {
+    static const int fatal_signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = crash_handler;
+    sa.sa_flags = SA_RESETHAND | SA_NODEFER;
+    sigemptyset(&sa.sa_mask);
+    for (size_t i = 0; i < sizeof(fatal_signals) / sizeof(fatal_signals[0]); i++) {
+        sigaction(fatal_signals[i], &sa, NULL);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+
+// 제어 경로용 비동기 로거
+//
+// log_info("[Logic] Temp %.1f C", t) 호출은 형식 문자열 포인터와 인자 값(타입 태그 포함)만
+// 잠금 없는 링 버퍼 칸에 복사하고 바로 반환한다. 문자열 변환과 출력(파일/표준출력/syslog)은
+// 별도 드레인 스레드가 수행하므로, 콘솔이나 파이프가 느려도 센서 콜백과 제어 루프가 멈추지 않는다.
+//  - 형식 문자열은 문자열 리터럴이어야 한다 (포인터만 저장). %s 인자는 기록 시 복사된다.
+//  - 링이 가득 차면 기다리지 않고 버리며, 버린 개수는 드레인 스레드가 보고한다.
+//  - 같은 형식 문자열의 메시지는 초당 LOG_RATE_LIMIT개까지만 출력하고 나머지는 개수만 보고한다.
+//  - 치명적 시그널(SIGSEGV 등) 수신 시 최근 LOG_CRASH_ENTRIES개 항목을 표준에러(와 로그 파일)에 덤프한다.
+
+#define LOG_RING_SIZE     4096 // 2의 거듭제곱
+#define LOG_MAX_ARGS      6
+#define LOG_STR_SPACE     48   // 항목당 %s 인자 복사 공간
+#define LOG_RATE_LIMIT    20   // 형식 문자열별 초당 최대 출력 수
+#define LOG_CRASH_ENTRIES 64
+
+typedef enum { LOG_LEVEL_DEBUG, LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_ERROR } LogLevel;
+
+enum { LOG_ARG_INT, LOG_ARG_DOUBLE, LOG_ARG_STR, LOG_ARG_PTR };
+
+typedef struct {
+    uint8_t type;
+    union {
+        long long i;
+        double d;
+        const char *s;
+        const void *p;
+    } v;
+} LogArg;
+
+// 이 수준 미만의 메시지는 호출 지점에서 바로 걸러짐
+extern volatile int g_log_level;
+
+// 출력 대상: NULL 또는 "-" 는 표준출력, "syslog"는 syslog(journald), 그 외는 파일 경로(추가 모드)
+int logger_start(const char *target, LogLevel level);
+void logger_stop(); // 남은 항목을 모두 출력하고 드레인 스레드 종료
+void logger_set_level(LogLevel level);
+int logger_parse_level(const char *name); // "debug"/"info"/"warn"/"error", 알 수 없으면 -1
+
+// 치명적 시그널에서 최근 항목 덤프 후 기본 동작(코어 덤프 등) 수행
+void logger_install_crash_handler();
+// 최근 count개 항목을 fd에 기록 (시그널 처리기에서도 사용)
+void logger_dump_recent(int fd, int count);
+
+void logger_record(int level, const char *fmt, const LogArg *args, int nargs);
+
+static inline LogArg log_arg_int(long long v) { LogArg a; a.type = LOG_ARG_INT; a.v.i = v; return a; }
+static inline LogArg log_arg_double(double v) { LogArg a; a.type = LOG_ARG_DOUBLE; a.v.d = v; return a; }
+static inline LogArg log_arg_str(const char *v) { LogArg a; a.type = LOG_ARG_STR; a.v.s = v; return a; }
+static inline LogArg log_arg_ptr(const void *v) { LogArg a; a.type = LOG_ARG_PTR; a.v.p = v; return a; }
+
+#define LOG_ARG(x) _Generic((x), \
+    float: log_arg_double, double: log_arg_double, \
+    char *: log_arg_str, const char *: log_arg_str, \
+    void *: log_arg_ptr, const void *: log_arg_ptr, \
+    default: log_arg_int)(x)
+
+// 인자 개수 세기 및 타입 태그 배열 생성 (형식 문자열 + 최대 LOG_MAX_ARGS개)
+#define LOG_COUNT(...) LOG_COUNT_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0, ~)
+#define LOG_COUNT_(f, a1, a2, a3, a4, a5, a6, n, ...) n
+#define LOG_FIRST(...) LOG_FIRST_(__VA_ARGS__, ~)
+#define LOG_FIRST_(f, ...) f
+#define LOG_CAT(a, b) LOG_CAT_(a, b)
+#define LOG_CAT_(a, b) a##b
+#define LOG_ARGS(...) LOG_CAT(LOG_ARGS_, LOG_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define LOG_ARGS_0(f) log_arg_int(0)
+#define LOG_ARGS_1(f, a) LOG_ARG(a)
+#define LOG_ARGS_2(f, a, b) LOG_ARG(a), LOG_ARG(b)
+#define LOG_ARGS_3(f, a, b, c) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c)
+#define LOG_ARGS_4(f, a, b, c, d) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d)
+#define LOG_ARGS_5(f, a, b, c, d, e) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e)
+#define LOG_ARGS_6(f, a, b, c, d, e, g) LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), LOG_ARG(d), LOG_ARG(e), LOG_ARG(g)
+
+#define LOG_RECORD(level, ...) do { \
+        if ((level) >= g_log_level) { \
+            const LogArg log_args_[] = { LOG_ARGS(__VA_ARGS__) }; \
+            logger_record((level), LOG_FIRST(__VA_ARGS__), log_args_, LOG_COUNT(__VA_ARGS__)); \
+        } \
+    } while (0)
+
+#define log_debug(...) LOG_RECORD(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define log_info(...)  LOG_RECORD(LOG_LEVEL_INFO, __VA_ARGS__)
+#define log_warn(...)  LOG_RECORD(LOG_LEVEL_WARN, __VA_ARGS__)
+#define log_error(...) LOG_RECORD(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif
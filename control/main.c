@@ -2,94 +2,206 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <signal.h>
-#include "gui.h"
+#include "shared_data.h"
 #include "control_logic.h"
 #include "dht11_driver.h"
+#include "dht_bits.h" // DHT_DECODER_FIXED/ADAPTIVE
 #include "motor_driver.h"
 #include "buzzer_driver.h"
+#include "modbus_server.h"
+#include "rt_sched.h"
+#include "status_snapshot.h"
+#include "proc_stats.h"
+#include "runtime_config.h"
+#include "logger.h"
+#include "telemetry.h"
+#include <string.h>
+
+// 헤드리스 제어 데몬 (GTK 의존성 없음)
+// GUI는 별도 프로세스(smart_vent_gui)로 실행되어 공유 메모리 스냅샷과 원격 제어 FIFO로 연결된다.
 
 // 프로그램 종료 시 리소스 정리를 위해 필요한 전역 포인터
 static SharedData *g_main_shared_data_for_cleanup = NULL;
-// GTK 애플리케이션 객체에 접근하기 위한 전역 포인터
-static GtkApplication *g_app = NULL;
 
 // 모든 하드웨어 및 소프트웨어 리소스를 정리하는 함수
 void cleanup_all_resources() {
     printf("\n[Cleanup] Cleaning up all resources...\n");
 
+    // 0. 외부 인터페이스(Modbus/TCP) 종료
+    modbus_server_stop();
+
     // 1. DHT 센서 리소스 정리
     dht11_cleanup();
     printf("[Cleanup] DHT sensor resources cleaned up.\n");
 
-    // 2. pigpio 및 GPIO 리소스 정리 (이 함수에서 팬을 끕니다)
+    // 센서 이력 아카이브에 남은 데이터 기록
+    control_logic_cleanup();
+
+    // 2. pigpio 및 GPIO 리소스 정리 (팬 출력은 그대로 두어 재시작 후 체크포인트에서 이어감, --fan-off-on-exit이면 끔)
     cleanup_pigpio();
     printf("[Cleanup] pigpio and GPIO resources cleaned up.\n");
 
-    // 3. 뮤텍스 정리
+    // 3. GUI 클라이언트용 공유 상태 삭제
+    snapshot_unshare();
+    config_cleanup();
+
+    // 4. 뮤텍스 정리
     if (g_main_shared_data_for_cleanup) {
-        g_mutex_clear(&g_main_shared_data_for_cleanup->mutex);
+        pthread_mutex_destroy(&g_main_shared_data_for_cleanup->mutex);
         printf("[Cleanup] Mutex cleared.\n");
     }
     printf("[Cleanup] Cleanup finished.\n");
-}
 
-// Ctrl+C (SIGINT) 또는 종료 신호(SIGTERM)를 처리하는 핸들러
-void handle_exit_signals(int signum) {
-    printf("\n[Signal] Caught signal %d. Initiating graceful shutdown...\n", signum);
+    // 남은 로그 출력
+    logger_stop();
+}
 
-    // GTK 애플리케이션이 실행 중이라면 종료하도록 요청
-    if (g_app) {
-        g_application_quit(G_APPLICATION(g_app));
-    } else {
-        // GTK가 시작되기 전에 문제가 발생한 경우 직접 정리하고 종료
-        cleanup_all_resources();
-        exit(signum);
-    }
+// 시작에 실패하면 이후 팬을 제어할 프로세스가 없으므로 출력을 끄고 정리
+static void cleanup_failed_start() {
+    motor_fan_off_on_exit(1);
+    cleanup_pigpio();
 }
 
 int main(int argc, char *argv[]) {
-    // 1. 종료 시그널 핸들러 등록
-    signal(SIGINT, handle_exit_signals);
-    signal(SIGTERM, handle_exit_signals);
+    // 1. 종료 시그널은 sigwait로 메인 스레드에서만 받음
+    // (이후 생성되는 워커/Modbus 스레드도 이 마스크를 물려받아 시그널로 중단되지 않음)
+    sigset_t exit_signals;
+    sigemptyset(&exit_signals);
+    sigaddset(&exit_signals, SIGINT);
+    sigaddset(&exit_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &exit_signals, NULL);
+
+    // 옵션 처리
+    //   --realtime          : 실시간 스케줄링
+    //   --pwm               : 4선식 팬 하드웨어 PWM 속도 제어 (기본: 릴레이 ON/OFF)
+    //   --fan-watts <W>     : 팬 정격 전력 (전력량 추정용, 기본: 24)
+    //   --dht-trace <file>  : 센서 프레임 에지 길이 기록 (dht_replay 입력)
+    //   --dht-decoder <fixed|adaptive> : 센서 비트 분류 방식 (기본: adaptive, fixed는 고정 창)
+    //   --log <file|syslog> : 로그 출력 대상 (기본: 표준출력)
+    //   --log-level <level> : debug / info / warn / error (기본: info)
+    //   --config <file>     : 실행 중 교체 가능한 설정 파일 (기본: /etc/smart_vent/smart_vent.conf)
+    //   --fan-off-on-exit   : 종료 시 팬을 끔 (철거/점검용, 기본은 그대로 두고 재시작 후 체크포인트에서 이어서 동작)
+    //   --telemetry <host[:port]> : 텔레메트리 전송 대상 (IPv4 주소 또는 호스트 이름, 멀티캐스트 가능, 기본: 239.255.42.99:5005)
+    //   --no-telemetry      : 텔레메트리를 보내지 않음
+    const char *log_target = NULL;
+    const char *config_path = CONFIG_FILE_PATH;
+    LogLevel log_level = LOG_LEVEL_INFO;
+    bool use_pwm = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--realtime") == 0) {
+            if (rt_enable() != 0) fprintf(stderr, "[Main] Continuing without real-time mode.\n");
+        } else if (strcmp(argv[i], "--pwm") == 0) {
+            use_pwm = true;
+        } else if (strcmp(argv[i], "--fan-watts") == 0 && i + 1 < argc) {
+            double watts = atof(argv[++i]);
+            if (watts > 0.0) control_set_fan_watts(watts);
+            else fprintf(stderr, "[Main] Invalid fan wattage %s\n", argv[i]);
+        } else if (strcmp(argv[i], "--dht-trace") == 0 && i + 1 < argc) {
+            dht11_set_edge_trace(argv[++i]);
+        } else if (strcmp(argv[i], "--dht-decoder") == 0 && i + 1 < argc) {
+            const char *decoder = argv[++i];
+            if (strcmp(decoder, "fixed") == 0) dht11_set_decoder(DHT_DECODER_FIXED);
+            else if (strcmp(decoder, "adaptive") == 0) dht11_set_decoder(DHT_DECODER_ADAPTIVE);
+            else fprintf(stderr, "[Main] Unknown DHT decoder %s, expected fixed or adaptive\n", decoder);
+        } else if (strcmp(argv[i], "--fan-off-on-exit") == 0) {
+            motor_fan_off_on_exit(1);
+        } else if (strcmp(argv[i], "--keep-fan") == 0) {
+            // 이전 버전 옵션 (이제 기본 동작)
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            char *host = argv[++i]; // argv는 종료 시까지 유지되므로 ':'만 잘라 그대로 사용
+            char *colon = strrchr(host, ':');
+            int port = TELEMETRY_DEFAULT_PORT;
+            if (colon) {
+                *colon = '\0';
+                port = atoi(colon + 1);
+            }
+            if (*host != '\0' && port > 0 && port <= 65535) control_set_telemetry(host, port);
+            else fprintf(stderr, "[Main] Invalid telemetry target, expected host[:port]\n");
+        } else if (strcmp(argv[i], "--no-telemetry") == 0) {
+            control_set_telemetry(NULL, 0);
+        } else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            log_target = argv[++i];
+        } else if (strcmp(argv[i], "--log-level") == 0 && i + 1 < argc) {
+            int level = logger_parse_level(argv[++i]);
+            if (level >= 0) log_level = (LogLevel)level;
+            else fprintf(stderr, "[Main] Unknown log level %s\n", argv[i]);
+        } else {
+            fprintf(stderr, "[Main] Ignoring unknown option %s\n", argv[i]);
+        }
+    }
+
+    // 제어 경로 로그는 링 버퍼에 쌓고 별도 스레드에서 출력 (비정상 종료 시 최근 로그 덤프)
+    logger_start(log_target, log_level);
+    logger_install_crash_handler();
+
+    // GPIO 핀/임계값/판독 주기 설정 (잘못된 파일이면 기본값으로 시작, 이후 변경은 워커 루프에서 반영)
+    config_init(config_path);
+    motor_set_relay_pin(config_current()->relay_pin);
+    dht11_set_gpio(config_current()->dht_gpio);
+
+    // 2. 스레드 간 공유 데이터 생성
+    SharedData shared_data;
+    g_main_shared_data_for_cleanup = &shared_data; // 정리 함수에서 사용할 수 있도록 전역 포인터에 할당
+
+    // 공유 데이터 초기화
+    shared_data.temperature = 0.0f;
+    shared_data.humidity = 0.0f;
+    shared_data.raw_temperature = 0.0f;
+    shared_data.raw_humidity = 0.0f;
+    shared_data.derived = (PsychroValues){0.0f, 0.0f, 0.0f};
+    shared_data.threshold_eta = -1.0f;
+    shared_data.fan_prestart = false;
+    shared_data.mode = AUTOMATIC;
+    shared_data.is_running = false;
+    shared_data.fan_duty = 0.0f;
+    shared_data.is_alert_active = false;
+    shared_data.new_data_available = false;
+    shared_data.shutdown_requested = false;
+    pthread_mutex_init(&shared_data.mutex, NULL);
+    printf("[Main] Shared data initialized.\n");
+
+    // 재시작이면 체크포인트의 모드/팬 상태/마지막 판독값을 이어받고, 릴레이는 끄지 않고 그 상태로 초기화
+    bool restored = control_restore_state(&shared_data) == 1;
+    motor_set_initial_state(shared_data.is_running ? shared_data.fan_duty : 0.0f);
 
     printf("[Main] Initializing hardware...\n");
-    // 2. 하드웨어 초기화 (pigpio 연결 및 GPIO 설정)
+    // 3. 하드웨어 초기화 (pigpio 연결 및 GPIO 설정)
     if (init_pigpio() < 0) return 1;
 
     if (setup_gpio() != 0) {
-        cleanup_pigpio();
+        cleanup_failed_start();
         return 1;
     }
 
+    // PWM 설정에 실패하면 릴레이 ON/OFF로 계속 동작
+    if (use_pwm && setup_fan_pwm() != 0) {
+        fprintf(stderr, "[Main] Continuing with relay on/off fan control.\n");
+    }
+
     if (buzzer_init() != 0) {
-        cleanup_pigpio();
+        cleanup_failed_start();
         return 1;
     }
 
-    printf("[Main] Hardware initialized successfully.\n");
-
-    // 3. GTK 애플리케이션 생성
-    g_app = gtk_application_new("com.rpi.smartvent", G_APPLICATION_FLAGS_NONE);
+    // 이전 실행과 속도 제어 방식이 다르면 현재 방식에 맞춰 출력 (릴레이 상태는 그대로)
+    if (restored && shared_data.is_running) {
+        ventilation_set_duty(shared_data.fan_duty);
+        shared_data.fan_duty = get_fan_duty();
+    }
 
-    // 4. 스레드 간 공유 데이터 및 GUI 위젯 구조체 생성
-    SharedData shared_data;
-    GuiWidgets widgets;
-    g_main_shared_data_for_cleanup = &shared_data; // 정리 함수에서 사용할 수 있도록 전역 포인터에 할당
+    printf("[Main] Hardware initialized successfully.\n");
 
-    // 공유 데이터 초기화
-    shared_data.temperature = 0.0f;
-    shared_data.humidity = 0.0f;
-    shared_data.mode = AUTOMATIC;
-    shared_data.is_running = FALSE;
-    shared_data.is_alert_active = FALSE;
-    shared_data.new_data_available = FALSE;
-    shared_data.widgets = &widgets;
-    g_mutex_init(&shared_data.mutex);
-    printf("[Main] Shared data initialized.\n");
+    // 4. GUI 클라이언트가 읽을 상태 스냅샷을 공유 메모리에 게시 (실패해도 제어는 계속)
+    if (snapshot_share(SNAPSHOT_SHM_NAME) != 0) {
+        fprintf(stderr, "[Main] GUI clients will not be able to attach.\n");
+    }
 
     // 5. DHT 센서 초기화
     if (dht11_init(&shared_data) != 0) {
-        cleanup_pigpio();
+        snapshot_unshare();
+        cleanup_failed_start();
         return 1;
     }
     printf("[Main] DHT sensor initialized.\n");
@@ -98,33 +210,39 @@ int main(int argc, char *argv[]) {
     pthread_t worker_thread;
     if (pthread_create(&worker_thread, NULL, worker_thread_func, &shared_data) != 0) {
         perror("[Error] pthread_create failed");
+        motor_fan_off_on_exit(1);
         cleanup_all_resources();
         return -1;
     }
     printf("[Main] Worker thread created.\n");
 
-    // 7. GTK 'activate' 시그널에 GUI 생성 함수 연결
-    g_signal_connect(g_app, "activate", G_CALLBACK(create_gui), &shared_data);
-
-    printf("[Main] Starting GTK application. GUI window will open now.\n");
-    // 8. GTK 애플리케이션 실행 (GUI 창이 닫힐 때까지 이 함수에서 대기)
-    int status = g_application_run(G_APPLICATION(g_app), argc, argv);
-    
-    // --- 이하는 GUI 창이 닫힌 후 실행되는 코드 ---
-    printf("\n[Main] GTK application has been closed. Starting final cleanup routine...\n");
-    
-    // 9. 워커 스레드 종료
-    pthread_cancel(worker_thread);
+    // 실시간 모드: 제어 스레드를 RT 코어에 SCHED_FIFO로 고정
+    if (rt_is_enabled() && rt_make_realtime(worker_thread, RT_CONTROL_PRIORITY) == 0) {
+        printf("[Main] Worker thread switched to SCHED_FIFO %d.\n", RT_CONTROL_PRIORITY);
+    }
+
+    // BMS 연동용 Modbus/TCP 서버 시작 (실패해도 나머지 기능은 계속 동작)
+    if (modbus_server_start(MODBUS_TCP_PORT, &shared_data) != 0) {
+        fprintf(stderr, "[Main] Modbus/TCP server unavailable.\n");
+    }
+
+    proc_report_startup("Main");
+
+    // 7. 종료 시그널(Ctrl+C, SIGTERM)이 올 때까지 대기
+    int signum = 0;
+    sigwait(&exit_signals, &signum);
+    printf("\n[Signal] Caught signal %d. Initiating graceful shutdown...\n", signum);
+
+    // 8. 워커 스레드 종료 (다음 판독 주기 안에 루프를 빠져나옴)
+    pthread_mutex_lock(&shared_data.mutex);
+    shared_data.shutdown_requested = true;
+    pthread_mutex_unlock(&shared_data.mutex);
     pthread_join(worker_thread, NULL);
     printf("[Main] Worker thread terminated.\n");
-    
-    // 10. GTK 객체 참조 해제
-    g_object_unref(g_app);
-    printf("[Main] GTK application object unreferenced.\n");
 
-    // 11. 모든 리소스 정리 (가장 중요)
+    // 9. 모든 리소스 정리 (가장 중요)
     cleanup_all_resources();
 
-    printf("[Main] Program finished with status %d. Exiting.\n", status);
-    return status;
-}
\ No newline at end of file
+    printf("[Main] Program finished. Exiting.\n");
+    return 0;
+}
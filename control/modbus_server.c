@@ -0,0 +1,303 @@
+#include "modbus_server.h"
+#include "status_snapshot.h"
+#include "control_logic.h"
+#include "clock_source.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define MODBUS_MAX_CLIENTS   16
+#define MODBUS_MAX_ADU       260 // MBAP(7) + PDU(최대 253)
+#define MODBUS_MBAP_SIZE     7
+
+#define MODBUS_INPUT_REGISTERS 8
+#define MODBUS_COILS           3
+#define MODBUS_DISCRETE_INPUTS 3
+
+// 기능 코드
+#define FC_READ_COILS            0x01
+#define FC_READ_DISCRETE_INPUTS  0x02
+#define FC_READ_HOLDING          0x03
+#define FC_READ_INPUT            0x04
+#define FC_WRITE_SINGLE_COIL     0x05
+#define FC_WRITE_MULTIPLE_COILS  0x0F
+
+// 예외 코드
+#define EX_ILLEGAL_FUNCTION      0x01
+#define EX_ILLEGAL_ADDRESS       0x02
+#define EX_ILLEGAL_VALUE         0x03
+
+typedef struct {
+    int fd;
+    uint8_t buf[MODBUS_MAX_ADU];
+    size_t len;
+} ModbusClient;
+
+static SharedData *g_shared_data = NULL;
+static pthread_t server_thread;
+static int listen_fd = -1;
+static volatile int server_running = 0;
+static ModbusClient clients[MODBUS_MAX_CLIENTS];
+
+static const char *coil_commands[MODBUS_COILS] = { "REMOTE_ON", "REMOTE_OFF", "REMOTE_AUTO" };
+
+static uint16_t get_u16be(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+static void put_u16be(uint8_t *p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+
+static void snapshot_registers(uint16_t *regs) {
+    StatusSnapshot s;
+    snapshot_read(&s);
+
+    double age = s.reading_time > 0.0 ? clock_now() - s.reading_time : 65535.0;
+    if (age < 0.0) age = 0.0;
+    if (age > 65535.0) age = 65535.0;
+
+    regs[0] = (uint16_t)(int16_t)(s.temperature * 10.0f + (s.temperature >= 0 ? 0.5f : -0.5f));
+    regs[1] = (uint16_t)(int16_t)(s.humidity * 10.0f + 0.5f);
+    regs[2] = s.fan_on;
+    regs[3] = s.mode;
+    regs[4] = s.alert;
+    regs[5] = (uint16_t)age;
+    regs[6] = (uint16_t)(s.version & 0xFFFF);
+    regs[7] = s.fan_duty;
+}
+
+static void snapshot_bits(uint8_t *coils, uint8_t *inputs) {
+    StatusSnapshot s;
+    snapshot_read(&s);
+
+    coils[0] = s.mode == MANUAL && s.fan_on;
+    coils[1] = s.mode == MANUAL && !s.fan_on;
+    coils[2] = s.mode == AUTOMATIC;
+    inputs[0] = s.fan_on;
+    inputs[1] = s.mode == MANUAL;
+    inputs[2] = s.alert;
+}
+
+static size_t exception_response(uint8_t *pdu_out, uint8_t function, uint8_t code) {
+    pdu_out[0] = function | 0x80;
+    pdu_out[1] = code;
+    return 2;
+}
+
+static size_t read_bits(const uint8_t *values, int total, const uint8_t *pdu, size_t pdu_len, uint8_t *out) {
+    if (pdu_len < 5) return exception_response(out, pdu[0], EX_ILLEGAL_VALUE);
+    uint16_t start = get_u16be(pdu + 1);
+    uint16_t count = get_u16be(pdu + 3);
+    if (count == 0 || count > 2000) return exception_response(out, pdu[0], EX_ILLEGAL_VALUE);
+    if (start + count > total) return exception_response(out, pdu[0], EX_ILLEGAL_ADDRESS);
+
+    uint8_t bytes = (count + 7) / 8;
+    out[0] = pdu[0];
+    out[1] = bytes;
+    memset(out + 2, 0, bytes);
+    for (int i = 0; i < count; i++) {
+        if (values[start + i]) out[2 + i / 8] |= 1 << (i % 8);
+    }
+    return 2 + bytes;
+}
+
+// PDU 하나를 처리하고 응답 PDU 길이를 반환
+static size_t handle_pdu(const uint8_t *pdu, size_t pdu_len, uint8_t *out) {
+    uint8_t function = pdu[0];
+
+    switch (function) {
+    case FC_READ_HOLDING:
+    case FC_READ_INPUT: {
+        if (pdu_len < 5) return exception_response(out, function, EX_ILLEGAL_VALUE);
+        uint16_t start = get_u16be(pdu + 1);
+        uint16_t count = get_u16be(pdu + 3);
+        if (count == 0 || count > 125) return exception_response(out, function, EX_ILLEGAL_VALUE);
+        if (start + count > MODBUS_INPUT_REGISTERS) return exception_response(out, function, EX_ILLEGAL_ADDRESS);
+
+        uint16_t regs[MODBUS_INPUT_REGISTERS];
+        snapshot_registers(regs);
+        out[0] = function;
+        out[1] = count * 2;
+        for (int i = 0; i < count; i++) put_u16be(out + 2 + 2 * i, regs[start + i]);
+        return 2 + count * 2;
+    }
+    case FC_READ_COILS:
+    case FC_READ_DISCRETE_INPUTS: {
+        uint8_t coils[MODBUS_COILS], inputs[MODBUS_DISCRETE_INPUTS];
+        snapshot_bits(coils, inputs);
+        if (function == FC_READ_COILS) return read_bits(coils, MODBUS_COILS, pdu, pdu_len, out);
+        return read_bits(inputs, MODBUS_DISCRETE_INPUTS, pdu, pdu_len, out);
+    }
+    case FC_WRITE_SINGLE_COIL: {
+        if (pdu_len < 5) return exception_response(out, function, EX_ILLEGAL_VALUE);
+        uint16_t addr = get_u16be(pdu + 1);
+        uint16_t value = get_u16be(pdu + 3);
+        if (value != 0xFF00 && value != 0x0000) return exception_response(out, function, EX_ILLEGAL_VALUE);
+        if (addr >= MODBUS_COILS) return exception_response(out, function, EX_ILLEGAL_ADDRESS);
+
+        // 1을 쓰면 명령 실행, 0은 무시 (명령형 코일)
+        if (value == 0xFF00) control_handle_remote_command(g_shared_data, coil_commands[addr]);
+        memcpy(out, pdu, 5); // 요청을 그대로 응답
+        return 5;
+    }
+    case FC_WRITE_MULTIPLE_COILS: {
+        if (pdu_len < 6) return exception_response(out, function, EX_ILLEGAL_VALUE);
+        uint16_t start = get_u16be(pdu + 1);
+        uint16_t count = get_u16be(pdu + 3);
+        uint8_t bytes = pdu[5];
+        if (count == 0 || count > 1968 || bytes != (count + 7) / 8 || pdu_len < 6u + bytes) {
+            return exception_response(out, function, EX_ILLEGAL_VALUE);
+        }
+        if (start + count > MODBUS_COILS) return exception_response(out, function, EX_ILLEGAL_ADDRESS);
+
+        for (int i = 0; i < count; i++) {
+            if (pdu[6 + i / 8] & (1 << (i % 8))) {
+                control_handle_remote_command(g_shared_data, coil_commands[start + i]);
+            }
+        }
+        memcpy(out, pdu, 5);
+        return 5;
+    }
+    default:
+        return exception_response(out, function, EX_ILLEGAL_FUNCTION);
+    }
+}
+
+// 수신 버퍼에 쌓인 완전한 요청들을 처리 (실패 시 -1: 연결 종료)
+static int process_client(ModbusClient *client) {
+    while (client->len >= MODBUS_MBAP_SIZE) {
+        uint16_t protocol = get_u16be(client->buf + 2);
+        uint16_t length = get_u16be(client->buf + 4);
+        if (protocol != 0 || length < 2 || length > MODBUS_MAX_ADU - 6) return -1;
+
+        size_t frame_len = 6 + length;
+        if (client->len < frame_len) return 0; // 나머지 수신 대기
+
+        uint8_t response[MODBUS_MAX_ADU];
+        size_t pdu_len = handle_pdu(client->buf + MODBUS_MBAP_SIZE, length - 1, response + MODBUS_MBAP_SIZE);
+
+        memcpy(response, client->buf, 4); // 트랜잭션 ID, 프로토콜 ID
+        put_u16be(response + 4, (uint16_t)(pdu_len + 1));
+        response[6] = client->buf[6]; // 유닛 ID
+
+        if (send(client->fd, response, MODBUS_MBAP_SIZE + pdu_len, MSG_NOSIGNAL) < 0) return -1;
+
+        memmove(client->buf, client->buf + frame_len, client->len - frame_len);
+        client->len -= frame_len;
+    }
+    return 0;
+}
+
+static void close_client(ModbusClient *client) {
+    close(client->fd);
+    client->fd = -1;
+    client->len = 0;
+}
+
+static void *modbus_thread_func(void *arg) {
+    (void)arg;
+    struct pollfd fds[MODBUS_MAX_CLIENTS + 1];
+
+    while (server_running) {
+        int nfds = 0;
+        fds[nfds].fd = listen_fd;
+        fds[nfds].events = POLLIN;
+        nfds++;
+        for (int i = 0; i < MODBUS_MAX_CLIENTS; i++) {
+            fds[nfds].fd = clients[i].fd; // -1이면 poll이 무시
+            fds[nfds].events = POLLIN;
+            nfds++;
+        }
+
+        int ret = poll(fds, nfds, 500);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            perror("[Modbus] poll failed");
+            break;
+        }
+        if (ret == 0) continue;
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0) {
+                int slot = -1;
+                for (int i = 0; i < MODBUS_MAX_CLIENTS; i++) {
+                    if (clients[i].fd < 0) { slot = i; break; }
+                }
+                if (slot < 0) {
+                    close(fd); // 동시 접속 수 초과
+                } else {
+                    int on = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                    clients[slot].fd = fd;
+                    clients[slot].len = 0;
+                }
+            }
+        }
+
+        for (int i = 0; i < MODBUS_MAX_CLIENTS; i++) {
+            ModbusClient *client = &clients[i];
+            if (client->fd < 0 || !(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            ssize_t n = recv(client->fd, client->buf + client->len, sizeof(client->buf) - client->len, 0);
+            if (n <= 0) {
+                close_client(client);
+                continue;
+            }
+            client->len += n;
+            if (process_client(client) != 0) close_client(client);
+        }
+    }
+    return NULL;
+}
+
+int modbus_server_start(int port, SharedData *data) {
+    g_shared_data = data;
+    for (int i = 0; i < MODBUS_MAX_CLIENTS; i++) clients[i].fd = -1;
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        perror("[Error] Modbus socket failed");
+        return -1;
+    }
+    int on = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 8) < 0) {
+        perror("[Error] Modbus bind/listen failed");
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+
+    server_running = 1;
+    if (pthread_create(&server_thread, NULL, modbus_thread_func, NULL) != 0) {
+        perror("[Error] Modbus thread creation failed");
+        server_running = 0;
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+    printf("[Modbus] Modbus/TCP server listening on port %d\n", port);
+    return 0;
+}
+
+void modbus_server_stop() {
+    if (!server_running) return;
+    server_running = 0;
+    pthread_join(server_thread, NULL);
+
+    for (int i = 0; i < MODBUS_MAX_CLIENTS; i++) {
+        if (clients[i].fd >= 0) close_client(&clients[i]);
+    }
+    close(listen_fd);
+    listen_fd = -1;
+    printf("[Modbus] Server stopped.\n");
+}
@@ -0,0 +1,24 @@
+#ifndef MODBUS_SERVER_H
+#define MODBUS_SERVER_H
+
+#include "shared_data.h" // SharedData 구조체를 사용하기 위함
+
+// 건물 관리 시스템(BMS) 연동용 Modbus/TCP 서버
+// 상태 조회는 status_snapshot 만 읽으므로 고속 폴링이 제어 뮤텍스나 센서에 영향을 주지 않는다.
+//
+// 입력 레지스터 (FC04, FC03으로도 동일하게 읽기 가능)
+//   0: 온도 x10 (int16)       1: 습도 x10 (int16)
+//   2: 팬 상태 (0/1)          3: 모드 (0: AUTO, 1: MANUAL)
+//   4: 경고 상태 (0/1)        5: 마지막 센서 값 이후 경과 시간(초, 최대 65535)
+//   6: 스냅샷 버전 (하위 16비트)  7: 팬 속도 (%)
+// 코일 (FC01 읽기, FC05/FC15 쓰기 - 1을 쓰면 해당 명령 실행)
+//   0: ON (수동 켜기)         1: OFF (수동 끄기)        2: AUTO (자동 모드)
+// 이산 입력 (FC02)
+//   0: 팬 상태                1: 수동 모드              2: 경고 상태
+
+#define MODBUS_TCP_PORT 502
+
+int modbus_server_start(int port, SharedData *data); // 서버 스레드 시작 (실패 시 -1)
+void modbus_server_stop(); // 서버 스레드 종료 및 소켓 정리
+
+#endif
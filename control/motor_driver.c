@@ -1,12 +1,21 @@
 #include "motor_driver.h"
 #include <stdio.h>
 #include <pigpiod_if2.h>
+#include "clock_source.h"
 
-#define RELAY_PIN 24
 #define RELAY_ON_SIGNAL  PI_HIGH
 #define RELAY_OFF_SIGNAL PI_LOW
 
+#define FAN_PWM_FREQUENCY 25000   // 4선식 팬 규격 (25 kHz)
+#define FAN_PWM_RANGE     1000000 // pigpio hardware_PWM 듀티 범위
+
 static int pi_handle = -1;
+static int relay_pin = 24; // 설정 파일의 relay_pin (motor_set_relay_pin)
+static int relay_state = 0; // 현재 릴레이 출력 상태
+static int pwm_enabled = 0;
+static float fan_duty = 0.0f;
+static unsigned int fan_toggle_count = 0;
+static int fan_off_on_exit = 0; // 종료 시 릴레이/PWM 출력을 끔 (기본은 그대로 두고 재시작 후 체크포인트에서 이어감)
 
 int init_pigpio() {
     pi_handle = pigpio_start(NULL, NULL);
@@ -22,31 +31,103 @@ int get_pi_handle() {
 
 int setup_gpio() {
     if (pi_handle < 0) return -1;
-    if (set_mode(pi_handle, RELAY_PIN, PI_OUTPUT) != 0) {
-        fprintf(stderr, "Failed to set GPIO %d to OUTPUT.\n", RELAY_PIN);
+    if (set_mode(pi_handle, relay_pin, PI_OUTPUT) != 0) {
+        fprintf(stderr, "Failed to set GPIO %d to OUTPUT.\n", relay_pin);
+        return -1;
+    }
+    // 초기 상태: OFF (재시작 시 복원한 상태가 있으면 그 상태를 유지)
+    gpio_write(pi_handle, relay_pin, relay_state ? RELAY_ON_SIGNAL : RELAY_OFF_SIGNAL);
+    return 0;
+}
+
+void motor_set_initial_state(float duty) {
+    relay_state = duty > 0.0f;
+    fan_duty = relay_state ? duty : 0.0f;
+}
+
+void motor_fan_off_on_exit(int off) {
+    fan_off_on_exit = off;
+}
+
+int motor_set_relay_pin(int pin) {
+    if (pi_handle >= 0 && pin != relay_pin) {
+        if (set_mode(pi_handle, pin, PI_OUTPUT) != 0) {
+            fprintf(stderr, "Failed to set GPIO %d to OUTPUT.\n", pin);
+            return -1;
+        }
+        // 현재 출력 상태를 새 핀으로 옮기고 이전 핀은 OFF로 둠
+        gpio_write(pi_handle, pin, relay_state ? RELAY_ON_SIGNAL : RELAY_OFF_SIGNAL);
+        gpio_write(pi_handle, relay_pin, RELAY_OFF_SIGNAL);
+        printf("[Motor] Relay moved from GPIO %d to GPIO %d\n", relay_pin, pin);
+    }
+    relay_pin = pin;
+    return 0;
+}
+
+int setup_fan_pwm() {
+    if (pi_handle < 0) return -1;
+    unsigned initial = relay_state ? (unsigned)(fan_duty * FAN_PWM_RANGE) : 0;
+    if (hardware_PWM(pi_handle, FAN_PWM_PIN, FAN_PWM_FREQUENCY, initial) != 0) {
+        fprintf(stderr, "Failed to start hardware PWM on GPIO %d.\n", FAN_PWM_PIN);
         return -1;
     }
-    gpio_write(pi_handle, RELAY_PIN, RELAY_OFF_SIGNAL); // 초기 상태: OFF
+    pwm_enabled = 1;
     return 0;
 }
 
+int fan_pwm_enabled() {
+    return pwm_enabled;
+}
+
+void ventilation_set_duty(float duty) {
+    if (duty < 0.0f) duty = 0.0f;
+    if (duty > 1.0f) duty = 1.0f;
+    if (!pwm_enabled && duty > 0.0f) duty = 1.0f;
+
+    int on = duty > 0.0f;
+    if (pi_handle >= 0) {
+        // 켤 때는 속도를 먼저 정하고 릴레이를, 끌 때는 릴레이를 먼저 차단
+        if (on && pwm_enabled) hardware_PWM(pi_handle, FAN_PWM_PIN, FAN_PWM_FREQUENCY, (unsigned)(duty * FAN_PWM_RANGE));
+        gpio_write(pi_handle, relay_pin, on ? RELAY_ON_SIGNAL : RELAY_OFF_SIGNAL);
+        if (!on && pwm_enabled) hardware_PWM(pi_handle, FAN_PWM_PIN, FAN_PWM_FREQUENCY, 0);
+    }
+    if (on != relay_state) fan_toggle_count++;
+    relay_state = on;
+    fan_duty = duty;
+}
+
+float get_fan_duty() {
+    return fan_duty;
+}
+
 void ventilation_on() {
-    if (pi_handle >= 0) gpio_write(pi_handle, RELAY_PIN, RELAY_ON_SIGNAL);
+    ventilation_set_duty(1.0f);
 }
 
 void ventilation_off() {
-    if (pi_handle >= 0) gpio_write(pi_handle, RELAY_PIN, RELAY_OFF_SIGNAL);
+    ventilation_set_duty(0.0f);
+}
+
+unsigned int get_fan_toggle_count() {
+    return fan_toggle_count;
 }
 
 void cleanup_pigpio() {
-    if (pi_handle >= 0) {
+    if (pi_handle >= 0 && !fan_off_on_exit) {
+        // 재시작 후 체크포인트에서 이어서 동작하도록 출력은 그대로 두고 연결만 해제 (핀 상태는 pigpiod가 유지)
+        printf("Leaving fan output %s and stopping pigpio...\n", relay_state ? "ON" : "OFF");
+        pigpio_stop(pi_handle);
+        pi_handle = -1;
+        printf("pigpio stopped.\n");
+    } else if (pi_handle >= 0) {
         printf("Cleaning up GPIO and stopping pigpio...\n");
         // 확실하게 릴레이 핀을 출력으로 설정
-        set_mode(pi_handle, RELAY_PIN, PI_OUTPUT);
+        set_mode(pi_handle, relay_pin, PI_OUTPUT);
         // 확실하게 OFF 신호를 보냄
-        gpio_write(pi_handle, RELAY_PIN, RELAY_OFF_SIGNAL);
+        gpio_write(pi_handle, relay_pin, RELAY_OFF_SIGNAL);
+        if (pwm_enabled) hardware_PWM(pi_handle, FAN_PWM_PIN, 0, 0); // PWM 출력 정지
         // 약간의 딜레이를 주어 신호가 처리될 시간을 보장
-        time_sleep(0.1); 
+        clock_sleep(0.1); 
         
         // pigpio 연결 해제
         pigpio_stop(pi_handle);
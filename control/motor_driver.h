@@ -1,11 +1,22 @@
 #ifndef MOTOR_DRIVER_H
 #define MOTOR_DRIVER_H
 
+// 4선식 PWM 팬 속도 입력 (GPIO 18 = 하드웨어 PWM0, 설정 파일의 다른 핀과 겹치면 안 됨)
+#define FAN_PWM_PIN 18
+
 int init_pigpio(); // pigpio 라이브러리 연결
 int get_pi_handle(); // 다른 모듈에서 pigpio 핸들을 쓰기 위함
 int setup_gpio(); // 릴레이 핀 초기 설정
-void ventilation_on(); // 팬 켜기
+int motor_set_relay_pin(int pin); // 릴레이 핀 지정 (setup_gpio 전이면 핀만 바꾸고, 이후면 현재 상태를 새 핀으로 옮김)
+void motor_set_initial_state(float duty); // setup_gpio 전에 호출: 초기 출력 (재시작 시 이전 상태 유지, 기본 OFF)
+void motor_fan_off_on_exit(int off); // 1이면 cleanup_pigpio에서 팬을 끔 (기본은 출력을 그대로 둠, 철거/점검용)
+void ventilation_on(); // 팬 켜기 (PWM 모드에서는 최대 속도)
 void ventilation_off(); // 팬 끄기
-void cleanup_pigpio(); // pigpio 연결 해제 및 정리
+int setup_fan_pwm(); // 하드웨어 PWM 속도 제어 활성화 (릴레이는 전원 차단용으로 계속 사용)
+int fan_pwm_enabled(); // PWM 속도 제어 사용 여부
+void ventilation_set_duty(float duty); // 팬 속도 0.0~1.0 (0이면 릴레이 OFF, 릴레이 전용이면 0보다 크면 ON)
+float get_fan_duty(); // 현재 출력 중인 듀티
+unsigned int get_fan_toggle_count(); // 팬 켜짐/꺼짐 전환 횟수
+void cleanup_pigpio(); // pigpio 연결 해제 (motor_fan_off_on_exit(1)이면 팬 OFF)
 
 #endif
\ No newline at end of file
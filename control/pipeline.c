@@ -0,0 +1,205 @@
+#include "pipeline.h"
+#include "rt_sched.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t mono_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void pipeline_init(Pipeline *p, const char *name) {
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+}
+
+int pipeline_add_stage(Pipeline *p, const char *name, PipelineStageFunc run, int isolated) {
+    if (p->count >= PIPELINE_MAX_STAGES) {
+        fprintf(stderr, "[Pipeline] Too many stages in %s, dropping %s\n", p->name, name);
+        return -1;
+    }
+    PipelineStage *s = &p->stages[p->count++];
+    memset(s, 0, sizeof(*s));
+    s->name = name;
+    s->run = run;
+    s->isolated = isolated;
+    return 0;
+}
+
+int pipeline_add_stateful_stage(Pipeline *p, const char *name, PipelineStageFunc run, void *state,
+                                size_t state_size) {
+    if (pipeline_add_stage(p, name, run, 1) != 0) return -1;
+    p->stages[p->count - 1].state = state;
+    p->stages[p->count - 1].state_size = state_size;
+    return 0;
+}
+
+static void record_time(PipelineStage *s, uint64_t ns) {
+    // 보고는 다른 스레드에서 읽으므로 원자적으로 갱신 (기록자는 단계마다 하나)
+    __atomic_store_n(&s->runs, s->runs + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&s->total_ns, s->total_ns + ns, __ATOMIC_RELAXED);
+    if (ns > s->max_ns) __atomic_store_n(&s->max_ns, ns, __ATOMIC_RELAXED);
+}
+
+int pipeline_run(Pipeline *p, void *record) {
+    int result = PIPELINE_NEXT;
+    for (int i = 0; i < p->count; i++) {
+        PipelineStage *s = &p->stages[i];
+        uint64_t start = mono_ns();
+        result = s->run(record);
+        if (result != PIPELINE_SKIP) record_time(s, mono_ns() - start);
+        if (result == PIPELINE_STOP) break;
+    }
+    return result;
+}
+
+double pipeline_bench_stage(Pipeline *p, int index, const void *template_record, size_t record_size,
+                            int iterations) {
+    if (index < 0 || index >= p->count || !p->stages[index].isolated || iterations <= 0) return -1.0;
+
+    PipelineStage *s = &p->stages[index];
+    void *scratch = malloc(record_size);
+    void *saved = s->state ? malloc(s->state_size) : NULL;
+    if (scratch == NULL || (s->state && saved == NULL)) {
+        free(scratch);
+        free(saved);
+        return -1.0;
+    }
+    if (saved) memcpy(saved, s->state, s->state_size);
+    uint64_t total = 0;
+    for (int i = 0; i < iterations; i++) {
+        memcpy(scratch, template_record, record_size);
+        if (saved) memcpy(s->state, saved, s->state_size); // 매번 같은 상태에서 시작
+        uint64_t start = mono_ns();
+        s->run(scratch);
+        total += mono_ns() - start;
+    }
+    if (saved) memcpy(s->state, saved, s->state_size);
+    free(saved);
+    free(scratch);
+    return (double)total / iterations;
+}
+
+void pipeline_report(const Pipeline *p, FILE *out) {
+    fprintf(out, "[Pipeline] %s stages:\n", p->name);
+    for (int i = 0; i < p->count; i++) {
+        const PipelineStage *s = &p->stages[i];
+        uint64_t runs = __atomic_load_n(&s->runs, __ATOMIC_RELAXED);
+        uint64_t total = __atomic_load_n(&s->total_ns, __ATOMIC_RELAXED);
+        uint64_t max = __atomic_load_n(&s->max_ns, __ATOMIC_RELAXED);
+        fprintf(out, "[Pipeline]   %-10s n=%-8llu avg=%.1fus max=%.1fus\n", s->name, (unsigned long long)runs,
+                runs ? total / 1000.0 / runs : 0.0, max / 1000.0);
+    }
+}
+
+int pipeline_format_json(const Pipeline *p, char *buf, size_t len) {
+    size_t used = 0;
+    for (int i = 0; i < p->count && used < len; i++) {
+        const PipelineStage *s = &p->stages[i];
+        uint64_t runs = __atomic_load_n(&s->runs, __ATOMIC_RELAXED);
+        uint64_t total = __atomic_load_n(&s->total_ns, __ATOMIC_RELAXED);
+        uint64_t max = __atomic_load_n(&s->max_ns, __ATOMIC_RELAXED);
+        used += snprintf(buf + used, len - used, "%s\"%s\": {\"runs\": %llu, \"avg_us\": %.1f, \"max_us\": %.1f}",
+                         i ? ", " : "", s->name, (unsigned long long)runs,
+                         runs ? total / 1000.0 / runs : 0.0, max / 1000.0);
+    }
+    if (used >= len) { // 버퍼 부족: 멤버 없이 기록
+        if (len > 0) buf[0] = '\0';
+        return 0;
+    }
+    return (int)used;
+}
+
+/* --- 게시 링 --- */
+
+void pipeline_ring_init(PipelineRing *ring, Pipeline *sinks, void *slots, size_t record_size) {
+    memset(ring, 0, sizeof(*ring));
+    ring->sinks = sinks;
+    ring->slots = slots;
+    ring->record_size = record_size;
+    pthread_mutex_init(&ring->mutex, NULL);
+    pthread_cond_init(&ring->cond, NULL);
+}
+
+static void *slot_at(PipelineRing *ring, uint64_t pos) {
+    return ring->slots + (pos % PIPELINE_RING_SIZE) * ring->record_size;
+}
+
+static void *publisher_thread_func(void *arg) {
+    PipelineRing *ring = (PipelineRing *)arg;
+    // 실시간 제어 스레드에서 생성되어도 일반 코어/일반 스케줄링으로 실행
+    rt_make_general(pthread_self());
+
+    pthread_mutex_lock(&ring->mutex);
+    while (1) {
+        while (ring->tail == ring->head && !ring->stopping) pthread_cond_wait(&ring->cond, &ring->mutex);
+        if (ring->tail == ring->head) break; // 종료 요청 + 남은 레코드 없음
+
+        // 꺼낼 칸은 tail을 옮기기 전까지 생산자가 덮어쓰지 않으므로 잠금 없이 처리
+        void *record = slot_at(ring, ring->tail);
+        pthread_mutex_unlock(&ring->mutex);
+        pipeline_run(ring->sinks, record);
+        pthread_mutex_lock(&ring->mutex);
+        ring->tail++;
+    }
+    ring->running = 0; // 이후 push는 호출 스레드에서 바로 처리
+    pthread_mutex_unlock(&ring->mutex);
+    return NULL;
+}
+
+int pipeline_ring_start(PipelineRing *ring) {
+    pthread_mutex_lock(&ring->mutex);
+    ring->stopping = 0;
+    ring->running = 1;
+    if (pthread_create(&ring->thread, NULL, publisher_thread_func, ring) != 0) {
+        ring->running = 0;
+        pthread_mutex_unlock(&ring->mutex);
+        perror("[Pipeline] Failed to start publisher thread");
+        return -1;
+    }
+    pthread_mutex_unlock(&ring->mutex);
+    return 0;
+}
+
+int pipeline_ring_push(PipelineRing *ring, const void *record) {
+    pthread_mutex_lock(&ring->mutex);
+    if (!ring->running) {
+        // 게시 스레드가 없으면 (가상 시계, 종료 후 Modbus 명령 등) 호출 스레드에서 순서대로 처리
+        ring->pushed++;
+        pipeline_run(ring->sinks, (void *)record);
+        pthread_mutex_unlock(&ring->mutex);
+        return 0;
+    }
+    uint64_t depth = ring->head - ring->tail;
+    if (depth >= PIPELINE_RING_SIZE) {
+        uint64_t dropped = ++ring->dropped;
+        pthread_mutex_unlock(&ring->mutex);
+        if (dropped == 1 || dropped % 100 == 0) {
+            log_warn("[Pipeline] Publisher backlog full, %llu records dropped", (unsigned long long)dropped);
+        }
+        return -1;
+    }
+    memcpy(slot_at(ring, ring->head), record, ring->record_size);
+    ring->head++;
+    ring->pushed++;
+    if (depth + 1 > ring->max_depth) ring->max_depth = depth + 1;
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+    return 0;
+}
+
+void pipeline_ring_stop(PipelineRing *ring) {
+    pthread_mutex_lock(&ring->mutex);
+    if (!ring->running) {
+        pthread_mutex_unlock(&ring->mutex);
+        return;
+    }
+    ring->stopping = 1;
+    pthread_cond_signal(&ring->cond);
+    pthread_mutex_unlock(&ring->mutex);
+
+    pthread_join(ring->thread, NULL);
+}
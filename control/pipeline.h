@@ -0,0 +1,99 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+
+// 샘플 처리 파이프라인 (단계 표 + 단계별 처리 시간 + 게시 링)
+//
+// 단계는 레코드 하나를 받아 처리하는 함수이며 등록한 순서대로 실행된다. 단계 사이의 값은 모두
+// 레코드에 담겨 전달되므로 표에 새 단계를 끼워 넣거나, 한 단계만 따로 반복 실행해 비용을 잴 수 있다.
+// 제어 단계(워커 스레드)와 게시 단계(LCD, 상태 파일, 아카이브, 텔레메트리)는 미리 할당한 고정 크기
+// 링으로 분리되어, 느린 게시 단계가 판단/구동 단계를 붙잡지 않는다 (링이 가득 차면 새 레코드를 버리고 셈).
+// 처리 시간은 CLOCK_MONOTONIC 기준이므로 가상 시계로 실행해도 실제 비용이 집계된다.
+
+#define PIPELINE_MAX_STAGES 8
+#define PIPELINE_RING_SIZE  32 // 게시 대기 레코드 수 (판독 주기 3초 기준 약 1.5분)
+
+// 단계 함수 반환값
+enum {
+    PIPELINE_NEXT = 0, // 다음 단계로
+    PIPELINE_SKIP,     // 이 레코드에는 할 일이 없었음 (시간 집계에서 제외하고 다음 단계로)
+    PIPELINE_STOP,     // 이 레코드의 처리를 여기서 끝냄
+};
+
+typedef int (*PipelineStageFunc)(void *record);
+
+typedef struct {
+    const char *name;
+    PipelineStageFunc run;
+    int isolated;       // 하드웨어나 state 밖의 공유 상태를 건드리지 않아 단독으로 반복 실행 가능
+    void *state;        // 단계가 바꾸는 상태 (벤치마크가 반복마다 실행 전 값으로 되돌림, 없으면 NULL)
+    size_t state_size;
+    uint64_t runs;      // 아래 집계는 실행 스레드만 갱신하고 보고 시에는 잠금 없이 읽음
+    uint64_t total_ns;
+    uint64_t max_ns;
+} PipelineStage;
+
+typedef struct {
+    const char *name;
+    PipelineStage stages[PIPELINE_MAX_STAGES];
+    int count;
+} Pipeline;
+
+void pipeline_init(Pipeline *p, const char *name);
+
+// 단계 추가 (실행 전에 호출, 표가 가득 차면 -1)
+int pipeline_add_stage(Pipeline *p, const char *name, PipelineStageFunc run, int isolated);
+
+// 레코드 외에 state만 바꾸는 단계 추가 (단독 실행 가능한 단계로 등록)
+int pipeline_add_stateful_stage(Pipeline *p, const char *name, PipelineStageFunc run, void *state,
+                                size_t state_size);
+
+// 레코드를 모든 단계에 순서대로 통과시킴 (마지막 단계의 반환값)
+int pipeline_run(Pipeline *p, void *record);
+
+// index 단계만 template 레코드 복사본으로 iterations번 실행하고 1회당 평균 시간(ns) 반환
+// (단계 집계에는 반영하지 않음, isolated가 아닌 단계는 -1)
+// 단계의 state는 매 반복 전과 끝난 뒤 원래 값으로 되돌리므로, 파이프라인을 실행하는 스레드가 멈춘 뒤에 호출
+double pipeline_bench_stage(Pipeline *p, int index, const void *template_record, size_t record_size,
+                            int iterations);
+
+// 단계별 실행 횟수와 평균/최대 처리 시간
+void pipeline_report(const Pipeline *p, FILE *out);
+
+// JSON 객체 멤버로 기록: "acquire": {"runs": .., "avg_us": .., "max_us": ..}, ... (기록한 길이)
+int pipeline_format_json(const Pipeline *p, char *buf, size_t len);
+
+/* --- 게시 링 --- */
+
+typedef struct {
+    Pipeline *sinks;        // 링에서 꺼낸 레코드를 처리할 게시 단계
+    unsigned char *slots;   // record_size x PIPELINE_RING_SIZE (호출자가 미리 할당)
+    size_t record_size;
+    uint64_t head;          // 다음에 넣을 위치 (생산자)
+    uint64_t tail;          // 다음에 꺼낼 위치 (게시 스레드)
+    uint64_t pushed;
+    uint64_t dropped;       // 링이 가득 차 버린 레코드 수
+    uint64_t max_depth;     // 최대 대기 레코드 수
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    int running;            // 게시 스레드 실행 중 (아니면 push가 호출 스레드에서 바로 처리)
+    int stopping;
+} PipelineRing;
+
+void pipeline_ring_init(PipelineRing *ring, Pipeline *sinks, void *slots, size_t record_size);
+
+// 게시 스레드 시작 (실패 시 -1, 이 경우 push는 호출 스레드에서 바로 처리됨)
+int pipeline_ring_start(PipelineRing *ring);
+
+// 레코드를 복사해 넣음 (여러 스레드에서 호출 가능, 링이 가득 차면 버리고 -1)
+int pipeline_ring_push(PipelineRing *ring, const void *record);
+
+// 남은 레코드를 모두 처리한 뒤 게시 스레드 종료
+void pipeline_ring_stop(PipelineRing *ring);
+
+#endif
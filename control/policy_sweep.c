@@ -0,0 +1,527 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include "history_archive.h"
+#include "psychrometrics.h"
+#include "trend.h"
+#include "fan_policy.h"
+
+// 자동 팬 설정 후보 비교 도구 (what-if)
+//   policy_sweep <archive.sva | trace.csv> [options]
+//     --temp LIST        온도 임계값 (C)              기본: 28
+//     --humi LIST        습도 임계값 (%)              기본: 70
+//     --dew LIST         이슬점 임계값 (C, off: 끔)   기본: off
+//     --hyst-temp LIST   온도 히스테리시스 (C)        기본: 0
+//     --hyst-humi LIST   습도 히스테리시스 (%)        기본: 0
+//     --hyst-dew LIST    이슬점 히스테리시스 (C)      기본: 0
+//     --min-on LIST      최소 가동 시간 (초)          기본: 0
+//     --min-off LIST     최소 정지 시간 (초)          기본: 0
+//     --prestart LIST    선행 가동 예측 구간 (초, 0: 끔) 기본: 120
+//     --limit-temp T, --limit-humi H : 초과 노출 시간 기준 (기본: 28 C, 70 %)
+//     --interval S       S초 간격으로만 판독 (제어기 판독 주기 재현, 기본: 모든 샘플)
+//     --threads N        평가 스레드 수 (기본: 온라인 코어 수)
+//     --sort runtime|toggles|exposure, --top N, --csv
+//   LIST: 값 하나, 쉼표 목록(26,27,28) 또는 범위 시작:끝:간격(26:30:0.5)
+//         쉼표 목록의 off는 해당 조건을 끈 후보 (--dew off,18,20)
+//
+// 기록된 판독값을 후보 설정마다 제어 데몬과 같은 판단 로직(fan_policy.h)으로 재생하여
+// 팬 가동 시간, 전환 횟수, 기준을 넘었는데 팬이 꺼져 있던 시간(노출)을 비교한다.
+// 이력은 청크 단위로 한 번만 디코딩하고(이슬점/추세 포함), 각 청크를 모든 코어가 후보를 나눠
+// 평가하는 동안 다음 청크를 준비한다. 청크가 캐시에 머무를 크기라 후보 수가 늘어도 메모리 대역폭에 묶이지 않는다.
+// 판독값은 기록된 그대로 재생하므로 팬이 실내 환경에 주는 영향은 반영되지 않고, 스케줄 강제 환기와
+// 수동 모드 구간도 고려하지 않는다.
+
+#define CHUNK_SAMPLES   4096  // 청크당 최대 판독 수 (약 230KB)
+#define MAX_GAP_SECONDS 60.0  // 이보다 긴 판독 간격은 기록 공백으로 보고 집계하지 않음
+#define MAX_LIST_VALUES 256
+#define MAX_THREADS     64
+
+typedef struct {
+    FanPolicy policy;
+    FanPolicyState state;
+    int fan_on;
+    int prev_above;       // 직전 판독이 노출 기준을 넘었는지
+    double last_time;     // 직전 판독 시각 (음수면 없음)
+    double on_seconds;
+    double exposed_seconds;
+    unsigned int toggles;
+} Candidate;
+
+typedef struct {
+    FanPolicyInput in[CHUNK_SAMPLES];
+    unsigned char above[CHUNK_SAMPLES];
+    float temperature[CHUNK_SAMPLES]; // 이슬점 배치 계산용
+    float humidity[CHUNK_SAMPLES];
+    float dew_point[CHUNK_SAMPLES];
+    int count;
+} Chunk;
+
+// 입력 (아카이브 또는 시뮬레이터 트레이스 CSV)
+typedef struct {
+    ArchiveMap *map;
+    FILE *csv;
+    ArchiveSample block[ARCHIVE_BLOCK_SAMPLES];
+    int block_count;
+    int block_pos;
+    double interval;
+    double last_used;
+    int need_trend;
+    TrendEstimator temp_trend;
+    TrendEstimator humi_trend;
+    // 기록된 팬 상태 (아카이브만)
+    int has_recorded;
+    int rec_fan_on;
+    int rec_prev_above;
+    double rec_last;
+    double rec_on_seconds;
+    double rec_exposed_seconds;
+    unsigned int rec_toggles;
+    // 전체
+    long samples;
+    double covered_seconds; // 기록 공백을 제외한 시간
+    double above_seconds;   // 노출 기준을 넘은 시간 (팬 상태와 무관)
+    int prev_above;
+} Source;
+
+static float g_limit_temp = TEMPERATURE_THRESHOLD;
+static float g_limit_humi = HUMIDITY_THRESHOLD;
+
+static Candidate *g_candidates = NULL;
+static int g_candidate_count = 0;
+static Chunk *g_chunks = NULL; // 두 개: 평가 중인 청크와 준비 중인 청크
+static pthread_barrier_t g_barrier;
+
+typedef struct {
+    pthread_t thread;
+    int first;
+    int last;
+} SweepThread;
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* --- 입력 --- */
+
+static int source_open(Source *src, const char *path) {
+    size_t len = strlen(path);
+    if (len > 4 && strcasecmp(path + len - 4, ".csv") == 0) {
+        src->csv = fopen(path, "r");
+        if (src->csv == NULL) {
+            perror("[Sweep] Failed to open trace");
+            return -1;
+        }
+        return 0;
+    }
+    src->map = archive_map_open(path);
+    if (src->map == NULL) return -1;
+    src->has_recorded = 1;
+    return 0;
+}
+
+static void source_close(Source *src) {
+    if (src->map) archive_map_close(src->map);
+    if (src->csv) fclose(src->csv);
+}
+
+// 판독값 하나 (1: 샘플, 0: 끝, -1: 오류)
+static int source_next(Source *src, double *t, float *temp, float *humi, int *fan_on) {
+    if (src->csv) {
+        char line[256];
+        while (fgets(line, sizeof(line), src->csv)) {
+            if (line[0] == '#' || line[0] == '\n') continue;
+            // 시뮬레이터 트레이스(오프셋,온도,습도[,명령]) 또는 archive_tool dump 출력
+            if (sscanf(line, "%lf,%f,%f", t, temp, humi) != 3) continue;
+            *fan_on = -1;
+            return 1;
+        }
+        return 0;
+    }
+    if (src->block_pos >= src->block_count) {
+        int n = archive_map_next_block(src->map, INT64_MIN, INT64_MAX, src->block);
+        if (n <= 0) return n;
+        src->block_count = n;
+        src->block_pos = 0;
+    }
+    const ArchiveSample *s = &src->block[src->block_pos++];
+    *t = (double)s->timestamp;
+    *temp = s->temperature;
+    *humi = s->humidity;
+    *fan_on = s->fan_on;
+    return 1;
+}
+
+static int above_limit(float temp, float humi) {
+    return temp > g_limit_temp || humi > g_limit_humi;
+}
+
+// 기록 공백을 제외한 시간 집계 (후보 평가와 같은 규칙)
+static double covered_dt(double last, double now) {
+    double dt = now - last;
+    return (last >= 0.0 && dt > 0.0 && dt <= MAX_GAP_SECONDS) ? dt : 0.0;
+}
+
+// 다음 청크 준비: 판독값 디코딩, 이슬점 배치 계산, 추세 적합 (반환: 판독 수, 오류 -1)
+static int fill_chunk(Source *src, Chunk *c) {
+    double t;
+    float temp, humi;
+    int fan_on, ret = 0;
+    c->count = 0;
+    while (c->count < CHUNK_SAMPLES && (ret = source_next(src, &t, &temp, &humi, &fan_on)) == 1) {
+        if (src->interval > 0.0 && src->last_used >= 0.0 && t - src->last_used < src->interval) continue;
+        int above = above_limit(temp, humi);
+        double dt = covered_dt(src->last_used, t);
+        src->covered_seconds += dt;
+        if (src->prev_above) src->above_seconds += dt; // 설정과 무관한 기준 초과 시간
+        src->prev_above = above;
+        src->samples++;
+
+        if (fan_on >= 0) {
+            double rdt = covered_dt(src->rec_last, t);
+            if (src->rec_fan_on) src->rec_on_seconds += rdt;
+            else if (src->rec_prev_above) src->rec_exposed_seconds += rdt;
+            if (src->rec_last >= 0.0 && fan_on != src->rec_fan_on) src->rec_toggles++;
+            src->rec_fan_on = fan_on;
+            src->rec_prev_above = above;
+            src->rec_last = t;
+        }
+
+        int i = c->count++;
+        c->in[i].time = t;
+        c->temperature[i] = temp;
+        c->humidity[i] = humi;
+        c->above[i] = (unsigned char)above;
+        src->last_used = t;
+    }
+    if (ret < 0) return -1;
+
+    psychro_dew_point_batch(c->temperature, c->humidity, c->dew_point, (size_t)c->count);
+    for (int i = 0; i < c->count; i++) {
+        FanPolicyInput *in = &c->in[i];
+        in->temperature = c->temperature[i];
+        in->humidity = c->humidity[i];
+        in->dew_point = c->dew_point[i];
+        in->trend_valid = 0;
+        if (!src->need_trend) continue;
+        trend_add(&src->temp_trend, in->time, in->temperature);
+        trend_add(&src->humi_trend, in->time, in->humidity);
+        if (trend_fit(&src->temp_trend, in->time, &in->temp_slope, &in->temp_value) == 0) in->trend_valid |= 1;
+        if (trend_fit(&src->humi_trend, in->time, &in->humi_slope, &in->humi_value) == 0) in->trend_valid |= 2;
+    }
+    return c->count;
+}
+
+/* --- 평가 --- */
+
+// 후보 하나를 청크 전체에 대해 진행 (상태는 지역 변수로 복사해 레지스터에서 갱신)
+static void run_candidate(Candidate *cand, const Chunk *c) {
+    Candidate k = *cand;
+    int prestart = k.policy.prestart_horizon > 0.0f;
+    for (int i = 0; i < c->count; i++) {
+        const FanPolicyInput *in = &c->in[i];
+        double dt = covered_dt(k.last_time, in->time);
+        if (k.fan_on) k.on_seconds += dt;
+        else if (k.prev_above) k.exposed_seconds += dt;
+        k.last_time = in->time;
+        k.prev_above = c->above[i];
+
+        if (prestart) fan_policy_predict(&k.policy, &k.state, in, NULL);
+        int want = fan_policy_decide(&k.policy, &k.state, in, k.fan_on, 0, NULL);
+        if (want != k.fan_on) {
+            k.fan_on = want;
+            k.toggles++;
+        }
+    }
+    *cand = k;
+}
+
+// 청크마다 장벽에서 만나 자기 몫의 후보를 평가 (청크 k는 g_chunks[k % 2], 판독 수 0이면 끝)
+static void *sweep_thread_func(void *arg) {
+    SweepThread *t = (SweepThread *)arg;
+    for (long k = 0;; k++) {
+        pthread_barrier_wait(&g_barrier);
+        const Chunk *c = &g_chunks[k % 2];
+        if (c->count == 0) break;
+        for (int j = t->first; j < t->last; j++) run_candidate(&g_candidates[j], c);
+    }
+    return NULL;
+}
+
+/* --- 후보 목록 --- */
+
+// "28", "26,27,28", "26:30:0.5" 형식, 쉼표 목록의 "off"는 FAN_POLICY_OFF (값 개수, 오류 시 -1)
+static int parse_list(const char *spec, float *out, int max) {
+    float a, b, step;
+    if (sscanf(spec, "%f:%f:%f", &a, &b, &step) == 3) {
+        if (step <= 0.0f || b < a) return -1;
+        int n = 0;
+        // 간격 누적 오차로 끝값이 빠지지 않도록 인덱스로 계산
+        for (int i = 0; n < max; i++) {
+            float v = a + step * (float)i;
+            if (v > b + step * 1e-3f) break;
+            out[n++] = v;
+        }
+        return n;
+    }
+    int n = 0;
+    const char *p = spec;
+    while (*p && n < max) {
+        char *end;
+        if (strncmp(p, "off", 3) == 0) {
+            out[n++] = FAN_POLICY_OFF;
+            end = (char *)p + 3;
+        } else {
+            out[n++] = strtof(p, &end);
+            if (end == p) return -1;
+        }
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return -1;
+    }
+    return n;
+}
+
+typedef struct {
+    const char *option;
+    float values[MAX_LIST_VALUES];
+    int count;
+} GridAxis;
+
+enum {
+    AXIS_TEMP, AXIS_HUMI, AXIS_DEW, AXIS_HYST_TEMP, AXIS_HYST_HUMI, AXIS_HYST_DEW, AXIS_MIN_ON, AXIS_MIN_OFF,
+    AXIS_PRESTART, AXIS_COUNT
+};
+
+static void set_axis(FanPolicy *p, int axis, float v) {
+    switch (axis) {
+    case AXIS_TEMP:      p->temperature_threshold = v; break;
+    case AXIS_HUMI:      p->humidity_threshold = v; break;
+    case AXIS_DEW:       p->dew_point_threshold = v; break;
+    case AXIS_HYST_TEMP: p->temperature_hysteresis = v; break;
+    case AXIS_HYST_HUMI: p->humidity_hysteresis = v; break;
+    case AXIS_HYST_DEW:  p->dew_point_hysteresis = v; break;
+    case AXIS_MIN_ON:    p->min_on_seconds = v; break;
+    case AXIS_MIN_OFF:   p->min_off_seconds = v; break;
+    default:             p->prestart_horizon = v; break;
+    }
+}
+
+static int build_candidates(GridAxis *axes) {
+    long total = 1;
+    for (int a = 0; a < AXIS_COUNT; a++) total *= axes[a].count;
+    if (total > 1000000) {
+        fprintf(stderr, "[Sweep] Too many candidates (%ld)\n", total);
+        return -1;
+    }
+    g_candidates = calloc((size_t)total, sizeof(Candidate));
+    if (g_candidates == NULL) return -1;
+
+    for (long idx = 0; idx < total; idx++) {
+        Candidate *c = &g_candidates[idx];
+        fan_policy_defaults(&c->policy);
+        long rest = idx;
+        for (int a = AXIS_COUNT - 1; a >= 0; a--) {
+            set_axis(&c->policy, a, axes[a].values[rest % axes[a].count]);
+            rest /= axes[a].count;
+        }
+        fan_policy_reset(&c->state);
+        c->last_time = -1.0;
+    }
+    g_candidate_count = (int)total;
+    return 0;
+}
+
+/* --- 결과 --- */
+
+static int g_sort_key = -1; // 0: runtime, 1: toggles, 2: exposure
+
+static int compare_candidates(const void *pa, const void *pb) {
+    const Candidate *a = (const Candidate *)pa, *b = (const Candidate *)pb;
+    double ka, kb;
+    if (g_sort_key == 1) {
+        ka = a->toggles;
+        kb = b->toggles;
+    } else if (g_sort_key == 2) {
+        ka = a->exposed_seconds;
+        kb = b->exposed_seconds;
+        if (ka == kb) { // 노출이 같으면 가동 시간이 짧은 쪽
+            ka = a->on_seconds;
+            kb = b->on_seconds;
+        }
+    } else {
+        ka = a->on_seconds;
+        kb = b->on_seconds;
+    }
+    return (ka > kb) - (ka < kb);
+}
+
+static void print_results(const Source *src, int top, int csv) {
+    double days = src->covered_seconds / 86400.0;
+    if (csv) {
+        printf("temp,humi,dew,hyst_temp,hyst_humi,hyst_dew,min_on,min_off,prestart,fan_hours,fan_pct,toggles,toggles_per_day,exposed_hours\n");
+    } else {
+        printf("%5s %5s %5s %6s %6s %6s %6s %7s %8s | %9s %6s %8s %8s %9s\n", "temp", "humi", "dew", "hyst_t",
+               "hyst_h", "hyst_d", "min_on", "min_off", "prestart", "fan_h", "fan_%", "toggles", "per_day", "exposed_h");
+    }
+    int n = top > 0 && top < g_candidate_count ? top : g_candidate_count;
+    for (int i = 0; i < n; i++) {
+        const Candidate *c = &g_candidates[i];
+        const FanPolicy *p = &c->policy;
+        double pct = src->covered_seconds > 0.0 ? 100.0 * c->on_seconds / src->covered_seconds : 0.0;
+        double per_day = days > 0.0 ? c->toggles / days : 0.0;
+        char dew[16];
+        if (isnan(p->dew_point_threshold)) snprintf(dew, sizeof(dew), "off");
+        else snprintf(dew, sizeof(dew), "%.1f", p->dew_point_threshold);
+        printf(csv ? "%.1f,%.1f,%s,%.2f,%.2f,%.2f,%.0f,%.0f,%.0f,%.2f,%.2f,%u,%.2f,%.2f\n"
+                   : "%5.1f %5.1f %5s %6.2f %6.2f %6.2f %6.0f %7.0f %8.0f | %9.1f %6.1f %8u %8.2f %9.2f\n",
+               p->temperature_threshold, p->humidity_threshold, dew, p->temperature_hysteresis,
+               p->humidity_hysteresis, p->dew_point_hysteresis, p->min_on_seconds, p->min_off_seconds,
+               p->prestart_horizon, c->on_seconds / 3600.0, pct, c->toggles, per_day,
+               c->exposed_seconds / 3600.0);
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <archive.sva|trace.csv> [--temp LIST] [--humi LIST] [--dew LIST]\n"
+                    "       [--hyst-temp LIST] [--hyst-humi LIST] [--hyst-dew LIST] [--min-on LIST] [--min-off LIST] [--prestart LIST]\n"
+                    "       [--limit-temp T] [--limit-humi H] [--interval S] [--threads N]\n"
+                    "       [--sort runtime|toggles|exposure] [--top N] [--csv]\n"
+                    "LIST: value, comma list (26,27,28) or range start:stop:step (26:30:0.5), off disables --dew\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FanPolicy defaults;
+    fan_policy_defaults(&defaults);
+    GridAxis axes[AXIS_COUNT] = {
+        { "--temp", { defaults.temperature_threshold }, 1 },
+        { "--humi", { defaults.humidity_threshold }, 1 },
+        { "--dew", { defaults.dew_point_threshold }, 1 },
+        { "--hyst-temp", { defaults.temperature_hysteresis }, 1 },
+        { "--hyst-humi", { defaults.humidity_hysteresis }, 1 },
+        { "--hyst-dew", { defaults.dew_point_hysteresis }, 1 },
+        { "--min-on", { defaults.min_on_seconds }, 1 },
+        { "--min-off", { defaults.min_off_seconds }, 1 },
+        { "--prestart", { defaults.prestart_horizon }, 1 },
+    };
+    Source src;
+    memset(&src, 0, sizeof(src));
+    src.last_used = -1.0;
+    src.rec_last = -1.0;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int top = 0, csv = 0;
+
+    for (int i = 2; i < argc; i++) {
+        int matched = 0;
+        for (int a = 0; a < AXIS_COUNT; a++) {
+            if (strcmp(argv[i], axes[a].option) == 0 && i + 1 < argc) {
+                axes[a].count = parse_list(argv[++i], axes[a].values, MAX_LIST_VALUES);
+                if (axes[a].count <= 0) {
+                    fprintf(stderr, "[Sweep] Invalid value list for %s: %s\n", axes[a].option, argv[i]);
+                    return 1;
+                }
+                matched = 1;
+                break;
+            }
+        }
+        if (matched) continue;
+        if (strcmp(argv[i], "--limit-temp") == 0 && i + 1 < argc) {
+            g_limit_temp = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--limit-humi") == 0 && i + 1 < argc) {
+            g_limit_humi = strtof(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            src.interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--top") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sort") == 0 && i + 1 < argc) {
+            const char *key = argv[++i];
+            if (strcmp(key, "runtime") == 0) g_sort_key = 0;
+            else if (strcmp(key, "toggles") == 0) g_sort_key = 1;
+            else if (strcmp(key, "exposure") == 0) g_sort_key = 2;
+            else {
+                fprintf(stderr, "[Sweep] Unknown sort key %s\n", key);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    if (build_candidates(axes) != 0) return 1;
+    if (threads > g_candidate_count) threads = g_candidate_count;
+    for (int a = 0; a < axes[AXIS_PRESTART].count; a++) {
+        if (axes[AXIS_PRESTART].values[a] > 0.0f) src.need_trend = 1;
+    }
+    trend_init(&src.temp_trend);
+    trend_init(&src.humi_trend);
+
+    if (source_open(&src, argv[1]) != 0) return 1;
+    g_chunks = malloc(2 * sizeof(Chunk));
+    if (g_chunks == NULL) {
+        source_close(&src);
+        return 1;
+    }
+
+    // 후보를 스레드 수만큼 연속 구간으로 나눔
+    SweepThread workers[MAX_THREADS];
+    pthread_barrier_init(&g_barrier, NULL, (unsigned)threads + 1);
+    for (int t = 0; t < threads; t++) {
+        workers[t].first = (int)((long)g_candidate_count * t / threads);
+        workers[t].last = (int)((long)g_candidate_count * (t + 1) / threads);
+        if (pthread_create(&workers[t].thread, NULL, sweep_thread_func, &workers[t]) != 0) {
+            perror("[Sweep] pthread_create failed");
+            return 1;
+        }
+    }
+
+    double start = wall_seconds();
+    int failed = fill_chunk(&src, &g_chunks[0]) < 0;
+    for (long k = 0;; k++) {
+        // 장벽 통과: 스레드들이 청크 k를 평가하기 시작 (청크 k-1 평가는 끝남)
+        pthread_barrier_wait(&g_barrier);
+        if (g_chunks[k % 2].count == 0) break;
+        if (fill_chunk(&src, &g_chunks[(k + 1) % 2]) < 0) {
+            failed = 1;
+            g_chunks[(k + 1) % 2].count = 0;
+        }
+    }
+    for (int t = 0; t < threads; t++) pthread_join(workers[t].thread, NULL);
+    double elapsed = wall_seconds() - start;
+    pthread_barrier_destroy(&g_barrier);
+    source_close(&src);
+    if (failed) fprintf(stderr, "[Sweep] Input ended with a read error, results cover the samples before it.\n");
+
+    double steps = (double)src.samples * g_candidate_count;
+    fprintf(stderr, "[Sweep] %ld readings over %.1f days, %d candidates, %ld threads: %.2f s (%.0f M candidate-readings/s)\n",
+            src.samples, src.covered_seconds / 86400.0, g_candidate_count, threads, elapsed,
+            elapsed > 0.0 ? steps / elapsed / 1e6 : 0.0);
+    fprintf(stderr, "[Sweep] Above limit (%.1f C / %.0f %%): %.2f h\n", g_limit_temp, g_limit_humi,
+            src.above_seconds / 3600.0);
+    if (src.has_recorded) {
+        fprintf(stderr, "[Sweep] Recorded: fan %.1f h, %u toggles, exposed %.2f h\n",
+                src.rec_on_seconds / 3600.0, src.rec_toggles, src.rec_exposed_seconds / 3600.0);
+    }
+
+    if (g_sort_key >= 0) qsort(g_candidates, (size_t)g_candidate_count, sizeof(Candidate), compare_candidates);
+    print_results(&src, top, csv);
+
+    free(g_chunks);
+    free(g_candidates);
+    return failed;
+}
@@ -0,0 +1,46 @@
+#include "proc_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+long proc_rss_kb() {
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (fp == NULL) return -1;
+
+    char line[128];
+    long rss = -1;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "VmRSS: %ld", &rss) == 1) break;
+    }
+    fclose(fp);
+    return rss;
+}
+
+double proc_elapsed_seconds() {
+    FILE *fp = fopen("/proc/self/stat", "r");
+    if (fp == NULL) return -1.0;
+
+    char buf[512];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, fp);
+    fclose(fp);
+    buf[n] = '\0';
+
+    // 실행 파일 이름에 공백이 있을 수 있으므로 마지막 ')' 이후부터 필드를 셈 (22번째: starttime)
+    char *p = strrchr(buf, ')');
+    if (p == NULL) return -1.0;
+    unsigned long long start_ticks;
+    if (sscanf(p + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d %*d %*d %*d %*d %llu",
+               &start_ticks) != 1) {
+        return -1.0;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    double boot_now = ts.tv_sec + ts.tv_nsec / 1e9;
+    return boot_now - (double)start_ticks / sysconf(_SC_CLK_TCK);
+}
+
+void proc_report_startup(const char *tag) {
+    printf("[%s] Ready after %.0f ms, RSS %ld kB\n", tag, proc_elapsed_seconds() * 1000.0, proc_rss_kb());
+}
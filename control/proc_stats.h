@@ -0,0 +1,12 @@
+#ifndef PROC_STATS_H
+#define PROC_STATS_H
+
+// 프로세스 자원 사용량 (데몬/GUI 클라이언트 기동 비용 비교용, /proc 기반)
+
+long proc_rss_kb();             // 현재 상주 메모리(VmRSS, kB). 확인 불가 시 -1
+double proc_elapsed_seconds();  // 프로세스 생성(동적 링크 포함) 이후 경과 시간. 확인 불가 시 -1
+
+// "[tag] Ready after N ms, RSS M kB" 형식으로 기동 비용 출력
+void proc_report_startup(const char *tag);
+
+#endif
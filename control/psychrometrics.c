@@ -0,0 +1,124 @@
+#include "psychrometrics.h"
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+// Magnus 계수 (-45~60°C 구간에서 0.35°C 이내)
+#define MAGNUS_B 17.62f
+#define MAGNUS_C 243.12f
+#define MAGNUS_E0 6.112f // 0°C 포화 수증기압 (hPa)
+
+#define LN2 0.69314718f
+#define LOG2E 1.44269504f
+
+/* --- 벡터화 가능한 exp/log 근사 --- */
+// 비트 재해석은 memcpy로 수행 (컴파일러가 레지스터 이동으로 바꾸며 루프 벡터화를 막지 않음)
+
+static inline float bits_to_float(int32_t i) {
+    float f;
+    memcpy(&f, &i, sizeof(f));
+    return f;
+}
+
+static inline int32_t float_to_bits(float f) {
+    int32_t i;
+    memcpy(&i, &f, sizeof(i));
+    return i;
+}
+
+// e^x = 2^i × 2^f (i 정수부, f ∈ [0,1)), 2^f는 6차 테일러 다항식
+static inline float fast_expf(float x) {
+    x = x < -80.0f ? -80.0f : (x > 80.0f ? 80.0f : x);
+    float y = x * LOG2E;
+    int32_t i = (int32_t)y;
+    i -= (y < (float)i); // 음수 쪽 내림
+    float f = (y - (float)i) * LN2;
+    float p = 1.0f + f * (1.0f + f * (0.5f + f * (1.6666667e-1f + f * (4.1666668e-2f +
+              f * (8.3333338e-3f + f * 1.3888889e-3f)))));
+    return bits_to_float(float_to_bits(p) + (i << 23));
+}
+
+// ln x = e·ln2 + ln m (m ∈ [√½, √2)), ln m = 2·atanh((m-1)/(m+1)) 급수. x > 0 가정
+static inline float fast_logf(float x) {
+    int32_t bits = float_to_bits(x);
+    int32_t e = ((bits >> 23) & 0xFF) - 127;
+    float m = bits_to_float((bits & 0x007FFFFF) | 0x3F800000);
+    int32_t big = (m > 1.41421356f);
+    m = big ? m * 0.5f : m;
+    e += big;
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float series = s * (2.0f + s2 * (0.6666667f + s2 * (0.4f + s2 * 0.2857143f)));
+    return (float)e * LN2 + series;
+}
+
+/* --- 지표별 식 (스칼라/배치 공용) --- */
+
+static inline float clamp_humidity(float rh) {
+    return rh < 1.0f ? 1.0f : (rh > 100.0f ? 100.0f : rh);
+}
+
+static inline float dew_point(float t, float rh) {
+    float gamma = fast_logf(clamp_humidity(rh) * 0.01f) + MAGNUS_B * t / (MAGNUS_C + t);
+    return MAGNUS_C * gamma / (MAGNUS_B - gamma);
+}
+
+static inline float abs_humidity(float t, float rh) {
+    // 수증기 분압(hPa) × 100 / (R_v × T) × 1000, R_v = 461.5 J/(kg·K) → 216.7 계수
+    float vapour = MAGNUS_E0 * fast_expf(MAGNUS_B * t / (MAGNUS_C + t)) * clamp_humidity(rh) * 0.01f;
+    return 216.7f * vapour / (273.15f + t);
+}
+
+static inline float heat_index(float t, float rh) {
+    float tf = t * 1.8f + 32.0f;
+    float r = clamp_humidity(rh);
+
+    // 서늘한 구간은 Steadman 단순식
+    float simple = 0.5f * (tf + 61.0f + (tf - 68.0f) * 1.2f + r * 0.094f);
+
+    float hi = -42.379f + 2.04901523f * tf + 10.14333127f * r
+               - 0.22475541f * tf * r - 6.83783e-3f * tf * tf - 5.481717e-2f * r * r
+               + 1.22874e-3f * tf * tf * r + 8.5282e-4f * tf * r * r
+               - 1.99e-6f * tf * tf * r * r;
+
+    // 건조/고온 보정: RH < 13%, 80~112°F
+    float span = 17.0f - fabsf(tf - 95.0f);
+    // (조건을 &&로 묶으면 벡터화되지 않으므로 선택을 단계별로 적용)
+    float dry = (13.0f - r) * 0.25f * sqrtf((span > 0.0f ? span : 0.0f) / 17.0f);
+    dry = (r < 13.0f) ? dry : 0.0f;
+    dry = (tf >= 80.0f) ? dry : 0.0f;
+    dry = (tf <= 112.0f) ? dry : 0.0f;
+    // 다습 보정: RH > 85%, 80~87°F
+    float wet = (r - 85.0f) * 0.1f * (87.0f - tf) * 0.2f;
+    wet = (r > 85.0f) ? wet : 0.0f;
+    wet = (tf >= 80.0f) ? wet : 0.0f;
+    wet = (tf <= 87.0f) ? wet : 0.0f;
+    hi += wet - dry;
+
+    float result = (0.5f * (simple + tf) < 80.0f) ? simple : hi;
+    return (result - 32.0f) / 1.8f;
+}
+
+/* --- 공개 함수 --- */
+
+void psychro_compute(float temperature, float humidity, PsychroValues *out) {
+    out->dew_point = dew_point(temperature, humidity);
+    out->abs_humidity = abs_humidity(temperature, humidity);
+    out->heat_index = heat_index(temperature, humidity);
+}
+
+// 지표별로 루프를 분리해 각 루프가 단순한 원소 단위 연산이 되도록 함
+void psychro_dew_point_batch(const float *restrict temperature, const float *restrict humidity,
+                             float *restrict out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = dew_point(temperature[i], humidity[i]);
+}
+
+void psychro_abs_humidity_batch(const float *restrict temperature, const float *restrict humidity,
+                                float *restrict out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = abs_humidity(temperature[i], humidity[i]);
+}
+
+void psychro_heat_index_batch(const float *restrict temperature, const float *restrict humidity,
+                              float *restrict out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = heat_index(temperature[i], humidity[i]);
+}
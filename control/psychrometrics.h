@@ -0,0 +1,32 @@
+#ifndef PSYCHROMETRICS_H
+#define PSYCHROMETRICS_H
+
+#include <stddef.h>
+
+// 온도/상대습도로부터 파생되는 습공기 지표
+//   - 이슬점(°C): Magnus 식 (b=17.62, c=243.12)
+//   - 절대습도(g/m³): 포화 수증기압 × 상대습도 / 기체 상수 × 절대온도
+//   - 체감온도(°C): 미국 기상청(NWS) Rothfusz 회귀식 및 보정항
+//
+// 배치 함수는 입력/출력을 열 단위 배열(structure-of-arrays)로 받고 분기 없는 루프로
+// 작성되어 있어 컴파일러가 NEON/SSE로 벡터화할 수 있다. exp/log는 libm 대신
+// 다항식 근사(상대 오차 < 2e-5)를 사용한다. 단일 판독값 계산도 같은 근사를 거치므로
+// 실시간 값과 이력 리포트의 값이 일치한다.
+
+#define PSYCHRO_BATCH 1024 // 이력 처리 시 한 번에 계산하는 샘플 수
+
+typedef struct {
+    float dew_point;    // 이슬점 (°C)
+    float abs_humidity; // 절대습도 (g/m³)
+    float heat_index;   // 체감온도 (°C)
+} PsychroValues;
+
+// 판독값 하나에 대한 파생 지표
+void psychro_compute(float temperature, float humidity, PsychroValues *out);
+
+// n개 샘플에 대한 파생 지표 (출력 배열은 입력과 겹치지 않아야 함)
+void psychro_dew_point_batch(const float *temperature, const float *humidity, float *dew_point, size_t n);
+void psychro_abs_humidity_batch(const float *temperature, const float *humidity, float *abs_humidity, size_t n);
+void psychro_heat_index_batch(const float *temperature, const float *humidity, float *heat_index, size_t n);
+
+#endif
@@ -0,0 +1,144 @@
+#define _GNU_SOURCE
+#include "rt_sched.h"
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define JITTER_BUCKETS 22 // 0: 1us 미만, i: [2^(i-1), 2^i) us, 마지막: 1초 이상
+
+static int rt_enabled = 0;
+static int rt_cpu = -1; // 실시간 스레드 전용 코어
+
+static unsigned long jitter_hist[JITTER_BUCKETS];
+static unsigned long jitter_count = 0;
+static double jitter_max = 0.0;
+
+int rt_enable() {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    // 이후 생성되는 스레드 스택까지 포함하여 모든 메모리를 잠금
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("[RT] mlockall failed");
+        return -1;
+    }
+
+    rt_enabled = 1;
+    rt_cpu = ncpu > 1 ? (int)ncpu - 1 : -1;
+
+    // 호출 스레드(메인)와 이후 생성되는 스레드는 RT 코어를 제외한 코어에서 실행
+    if (rt_cpu > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < rt_cpu; cpu++) CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            fprintf(stderr, "[RT] Failed to restrict general threads to CPUs 0-%d\n", rt_cpu - 1);
+        }
+    }
+    printf("[RT] Real-time mode enabled (memory locked, RT core %d)\n", rt_cpu);
+    return 0;
+}
+
+int rt_is_enabled() {
+    return rt_enabled;
+}
+
+int rt_make_realtime(pthread_t thread, int priority) {
+    if (!rt_enabled) return -1;
+
+    if (rt_cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(rt_cpu, &set);
+        if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+            fprintf(stderr, "[RT] Failed to pin thread to CPU %d\n", rt_cpu);
+        }
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    int err = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (err != 0) {
+        fprintf(stderr, "[RT] SCHED_FIFO priority %d failed: %s\n", priority, strerror(err));
+        return -1;
+    }
+    return 0;
+}
+
+void rt_make_general(pthread_t thread) {
+    if (!rt_enabled) return;
+
+    if (rt_cpu > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < rt_cpu; cpu++) CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(thread, sizeof(set), &set) != 0) {
+            fprintf(stderr, "[RT] Failed to move thread to CPUs 0-%d\n", rt_cpu - 1);
+        }
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    int err = pthread_setschedparam(thread, SCHED_OTHER, &param);
+    if (err != 0) fprintf(stderr, "[RT] SCHED_OTHER failed: %s\n", strerror(err));
+}
+
+void rt_capture_thread_hook() {
+    static int applied = 0;
+    if (!rt_enabled || applied) return;
+    applied = 1; // 콜백은 항상 같은 스레드에서 호출됨
+    if (rt_make_realtime(pthread_self(), RT_CAPTURE_PRIORITY) == 0) {
+        printf("[RT] Sensor capture thread switched to SCHED_FIFO %d\n", RT_CAPTURE_PRIORITY);
+    }
+}
+
+void rt_stats_record_wakeup(double late_seconds) {
+    double us = late_seconds * 1e6;
+    int bucket = 0;
+
+    if (us < 0.0) us = 0.0;
+    if (us >= 1.0) {
+        bucket = 1;
+        while (bucket < JITTER_BUCKETS - 1 && us >= (double)(1UL << bucket)) bucket++;
+    }
+    jitter_hist[bucket]++;
+    jitter_count++;
+    if (late_seconds > jitter_max) jitter_max = late_seconds;
+}
+
+// 히스토그램에서 분위수에 해당하는 버킷 상한(us) 추정
+static double jitter_percentile(double q) {
+    unsigned long target = (unsigned long)(q * jitter_count);
+    unsigned long seen = 0;
+    for (int i = 0; i < JITTER_BUCKETS; i++) {
+        seen += jitter_hist[i];
+        if (seen > target) return (double)(1UL << i);
+    }
+    return (double)(1UL << (JITTER_BUCKETS - 1));
+}
+
+void rt_stats_report(FILE *out, const unsigned int sensor_status_counts[4], double elapsed_seconds) {
+    fprintf(out, "[RT] ---- Timing report (%s mode, %.0f s) ----\n",
+            rt_enabled ? "real-time" : "normal", elapsed_seconds);
+
+    fprintf(out, "[RT] Control loop wakeup latency: n=%lu p50<%.0fus p99<%.0fus max=%.0fus\n",
+            jitter_count, jitter_percentile(0.50), jitter_percentile(0.99), jitter_max * 1e6);
+    for (int i = 0; i < JITTER_BUCKETS; i++) {
+        if (jitter_hist[i] == 0) continue;
+        if (i == 0) fprintf(out, "[RT]   <1us        : %lu\n", jitter_hist[i]);
+        else if (i == JITTER_BUCKETS - 1) fprintf(out, "[RT]   >=%luus : %lu\n", 1UL << (i - 1), jitter_hist[i]);
+        else fprintf(out, "[RT]   %7lu-%-7luus: %lu\n", 1UL << (i - 1), 1UL << i, jitter_hist[i]);
+    }
+
+    // DHT_GOOD=0, DHT_BAD_CHECKSUM=1, DHT_BAD_DATA=2, DHT_TIMEOUT=3
+    unsigned long total = 0;
+    for (int i = 0; i < 4; i++) total += sensor_status_counts[i];
+    double minutes = elapsed_seconds / 60.0;
+    fprintf(out, "[RT] Sensor reads: total=%lu good=%u checksum=%u bad_data=%u timeout=%u\n",
+            total, sensor_status_counts[0], sensor_status_counts[1], sensor_status_counts[2],
+            sensor_status_counts[3]);
+    fprintf(out, "[RT] Decode success rate: %.1f %%, good reads/min: %.2f\n",
+            total ? 100.0 * sensor_status_counts[0] / total : 0.0,
+            minutes > 0.0 ? sensor_status_counts[0] / minutes : 0.0);
+}
@@ -0,0 +1,27 @@
+#ifndef RT_SCHED_H
+#define RT_SCHED_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+// 선택적 실시간 모드 (--realtime)
+// - 메모리 잠금(mlockall)으로 페이지 폴트 방지
+// - 센서 캡처(pigpio 콜백) 스레드와 제어 스레드를 마지막 CPU 코어에 SCHED_FIFO로 고정
+// - Modbus 등 나머지 스레드는 다른 코어에서만 실행 (GUI 클라이언트는 별도 프로세스)
+// 효과 확인을 위해 제어 루프 깨어남 지연 히스토그램과 센서 디코딩 성공률을 집계한다.
+
+#define RT_CAPTURE_PRIORITY 80
+#define RT_CONTROL_PRIORITY 70
+
+int rt_enable(); // 실시간 모드 활성화 + 메모리 잠금 + 호출 스레드를 일반 코어로 이동 (실패 시 -1)
+int rt_is_enabled();
+
+int rt_make_realtime(pthread_t thread, int priority); // 스레드를 RT 코어에 SCHED_FIFO로 고정
+void rt_make_general(pthread_t thread); // RT 코어를 제외한 코어에서 일반 스케줄링으로 실행 (RT 스레드가 만든 보조 스레드용)
+void rt_capture_thread_hook(); // 캡처 콜백에서 호출: 처음 한 번 현재 스레드를 실시간으로 전환
+
+// 통계
+void rt_stats_record_wakeup(double late_seconds); // 예정 시각 대비 늦게 깨어난 시간
+void rt_stats_report(FILE *out, const unsigned int sensor_status_counts[4], double elapsed_seconds);
+
+#endif
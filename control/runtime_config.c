@@ -0,0 +1,279 @@
+#include "runtime_config.h"
+#include "motor_driver.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#define CONFIG_LINE_LEN 160
+
+// 현재 설정과 직전 설정 (직전 설정은 되돌리기용)
+static RuntimeConfig *g_current = NULL;
+static RuntimeConfig *g_previous = NULL;
+
+// 그 이전에 교체된 설정 (다른 스레드가 아직 가리키고 있을 수 있으므로 config_cleanup에서 해제)
+typedef struct RetiredConfig {
+    RuntimeConfig *cfg;
+    struct RetiredConfig *next;
+} RetiredConfig;
+static RetiredConfig *g_retired = NULL;
+static RuntimeConfig g_builtin;         // config_init 전에 조회한 경우
+static const char *g_path = NULL;
+static const char *g_name = NULL;       // 감시 디렉터리 안에서의 파일 이름
+static int g_watch_fd = -1;
+
+void config_defaults(RuntimeConfig *cfg) {
+    memset(cfg, 0, sizeof(*cfg)); // 변경 여부를 memcmp로 비교하므로 패딩까지 초기화
+    cfg->relay_pin = CONFIG_DEFAULT_RELAY_PIN;
+    cfg->dht_gpio = CONFIG_DEFAULT_DHT_GPIO;
+    cfg->read_interval = CONFIG_DEFAULT_READ_INTERVAL;
+    fan_policy_defaults(&cfg->policy);
+}
+
+/* --- 파싱/검증 --- */
+
+typedef struct {
+    const char *key;
+    size_t offset;
+    int is_int;
+    int allow_off;  // "off"를 받아 FAN_POLICY_OFF로 저장
+    float min;
+    float max;
+} ConfigKey;
+
+#define POLICY_KEY(field, lo, hi) { #field, offsetof(RuntimeConfig, policy.field), 0, 0, lo, hi }
+
+static const ConfigKey g_keys[] = {
+    { "relay_pin", offsetof(RuntimeConfig, relay_pin), 1, 0, 2, 27 },
+    { "dht_gpio", offsetof(RuntimeConfig, dht_gpio), 1, 0, 2, 27 },
+    { "read_interval", offsetof(RuntimeConfig, read_interval), 1, 0, 2, 600 }, // DHT11은 2초 이상 간격 필요
+    POLICY_KEY(temperature_threshold, -40.0f, 80.0f),
+    POLICY_KEY(humidity_threshold, 0.0f, 100.0f),
+    { "dew_point_threshold", offsetof(RuntimeConfig, policy.dew_point_threshold), 0, 1, -40.0f, 80.0f },
+    POLICY_KEY(temperature_hysteresis, 0.0f, 10.0f),
+    POLICY_KEY(humidity_hysteresis, 0.0f, 30.0f),
+    POLICY_KEY(dew_point_hysteresis, 0.0f, 10.0f),
+    POLICY_KEY(min_on_seconds, 0.0f, 3600.0f),
+    POLICY_KEY(min_off_seconds, 0.0f, 3600.0f),
+    POLICY_KEY(prestart_horizon, 0.0f, 3600.0f),
+};
+
+static char *trim(char *s) {
+    while (isspace((unsigned char)*s)) s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) *--end = '\0';
+    return s;
+}
+
+static int parse_line(char *line, RuntimeConfig *cfg) {
+    char *hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+    char *key = trim(line);
+    if (*key == '\0') return 0;
+    char *eq = strchr(key, '=');
+    if (eq == NULL) return -1;
+    *eq = '\0';
+    key = trim(key);
+    char *value = trim(eq + 1);
+
+    for (size_t i = 0; i < sizeof(g_keys) / sizeof(g_keys[0]); i++) {
+        const ConfigKey *k = &g_keys[i];
+        if (strcmp(key, k->key) != 0) continue;
+        if (k->allow_off && strcmp(value, "off") == 0) {
+            *(float *)((char *)cfg + k->offset) = FAN_POLICY_OFF;
+            return 0;
+        }
+        char *end;
+        errno = 0;
+        double v = k->is_int ? (double)strtol(value, &end, 10) : strtod(value, &end);
+        if (end == value || *end != '\0' || errno != 0 || !(v >= k->min && v <= k->max)) {
+            if (k->allow_off) log_warn("[Config] %s must be a number in %g..%g or off", k->key, k->min, k->max);
+            else if (k->is_int) log_warn("[Config] %s must be an integer in %g..%g", k->key, k->min, k->max);
+            else log_warn("[Config] %s must be a number in %g..%g", k->key, k->min, k->max);
+            return -1;
+        }
+        if (k->is_int) *(int *)((char *)cfg + k->offset) = (int)v;
+        else *(float *)((char *)cfg + k->offset) = (float)v;
+        return 0;
+    }
+    log_warn("[Config] Unknown key '%s'", key);
+    return -1;
+}
+
+// 항목 사이의 조건 (핀 충돌)
+static int validate(const RuntimeConfig *cfg) {
+    if (cfg->relay_pin == cfg->dht_gpio) {
+        log_warn("[Config] relay_pin and dht_gpio are both GPIO %d", cfg->relay_pin);
+        return -1;
+    }
+    if (cfg->relay_pin == FAN_PWM_PIN || cfg->dht_gpio == FAN_PWM_PIN) {
+        log_warn("[Config] GPIO %d is reserved for the fan PWM output", FAN_PWM_PIN);
+        return -1;
+    }
+    return 0;
+}
+
+int config_parse(const char *path, RuntimeConfig *out) {
+    config_defaults(out);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        log_error("[Config] Failed to open configuration file: %s", strerror(errno));
+        return -1;
+    }
+    char line[CONFIG_LINE_LEN];
+    int line_no = 0, errors = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        line_no++;
+        if (parse_line(line, out) < 0) {
+            log_warn("[Config] %s:%d: invalid setting", path, line_no);
+            errors++;
+        }
+    }
+    fclose(fp);
+    if (errors == 0 && validate(out) != 0) errors++;
+    return errors ? -1 : 0;
+}
+
+/* --- 교체 --- */
+
+static void retire(RuntimeConfig *cfg) {
+    if (cfg == NULL) return;
+    RetiredConfig *node = malloc(sizeof(*node));
+    if (node == NULL) return; // 해제하지 못한 객체는 그대로 남김 (읽는 쪽이 있을 수 있음)
+    node->cfg = cfg;
+    node->next = g_retired;
+    g_retired = node;
+}
+
+static void publish(RuntimeConfig *cfg) {
+    retire(g_previous);
+    g_previous = g_current;
+    __atomic_store_n(&g_current, cfg, __ATOMIC_RELEASE);
+}
+
+const RuntimeConfig *config_current() {
+    RuntimeConfig *cfg = __atomic_load_n(&g_current, __ATOMIC_ACQUIRE);
+    if (cfg) return cfg;
+    if (g_builtin.generation == 0) {
+        config_defaults(&g_builtin);
+        g_builtin.generation = 1;
+    }
+    return &g_builtin;
+}
+
+static void start_watch(const char *path) {
+    // 편집기가 새 파일로 바꿔치기해도 잡히도록 디렉터리를 감시
+    char dir[256];
+    const char *slash = strrchr(path, '/');
+    if (slash == NULL) {
+        snprintf(dir, sizeof(dir), ".");
+        g_name = path;
+    } else {
+        snprintf(dir, sizeof(dir), "%.*s", (int)(slash - path) > 0 ? (int)(slash - path) : 1, path);
+        g_name = slash + 1;
+    }
+    g_watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (g_watch_fd == -1) {
+        perror("[Config] inotify_init1 failed");
+        return;
+    }
+    if (inotify_add_watch(g_watch_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        fprintf(stderr, "[Config] Cannot watch %s (%s), configuration changes need a restart\n", dir,
+                strerror(errno));
+        close(g_watch_fd);
+        g_watch_fd = -1;
+        return;
+    }
+    printf("[Config] Watching %s for changes\n", path);
+}
+
+int config_init(const char *path) {
+    RuntimeConfig *cfg = malloc(sizeof(*cfg));
+    if (cfg == NULL) return -1;
+    int ret = 0;
+    g_path = path;
+    if (path == NULL) {
+        config_defaults(cfg);
+    } else if (access(path, F_OK) != 0) {
+        config_defaults(cfg);
+        printf("[Config] %s not found, using built-in defaults\n", path);
+    } else if (config_parse(path, cfg) != 0) {
+        config_defaults(cfg);
+        fprintf(stderr, "[Config] Using built-in defaults\n");
+        ret = -1;
+    } else {
+        printf("[Config] Loaded %s\n", path);
+    }
+    cfg->generation = 1;
+    publish(cfg);
+    if (path) start_watch(path);
+    return ret;
+}
+
+int config_watch_fd() {
+    return g_watch_fd;
+}
+
+int config_reload() {
+    if (g_watch_fd < 0) return 0;
+
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    int changed = 0;
+    ssize_t n;
+    while ((n = read(g_watch_fd, buf, sizeof(buf))) > 0) {
+        for (char *p = buf; p < buf + n;) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            if ((ev->mask & IN_Q_OVERFLOW) || (ev->len > 0 && strcmp(ev->name, g_name) == 0)) changed = 1;
+            p += sizeof(*ev) + ev->len;
+        }
+    }
+    if (!changed) return 0;
+
+    const RuntimeConfig *current = config_current();
+    RuntimeConfig *cfg = malloc(sizeof(*cfg));
+    if (cfg == NULL) return -1;
+    if (config_parse(g_path, cfg) != 0) {
+        free(cfg);
+        log_warn("[Config] Keeping configuration #%u", current->generation);
+        return -1;
+    }
+    cfg->generation = current->generation;
+    if (memcmp(cfg, current, sizeof(*cfg)) == 0) { // 저장만 다시 한 경우
+        free(cfg);
+        return 0;
+    }
+    cfg->generation = current->generation + 1;
+    publish(cfg);
+    log_info("[Config] Loaded configuration #%u from %s", cfg->generation, g_path);
+    return 1;
+}
+
+void config_rollback(const RuntimeConfig *previous) {
+    if (previous != g_previous) return; // 직전 설정만 되돌릴 수 있음
+    RuntimeConfig *failed = g_current;
+    __atomic_store_n(&g_current, g_previous, __ATOMIC_RELEASE);
+    g_previous = failed; // 다음 교체 때 retired 목록으로
+    log_warn("[Config] Rolled back to configuration #%u", previous->generation);
+}
+
+void config_cleanup() {
+    if (g_watch_fd != -1) {
+        close(g_watch_fd);
+        g_watch_fd = -1;
+    }
+    while (g_retired) {
+        RetiredConfig *node = g_retired;
+        g_retired = node->next;
+        free(node->cfg);
+        free(node);
+    }
+    free(g_previous);
+    free(g_current);
+    g_previous = NULL;
+    g_current = NULL;
+}
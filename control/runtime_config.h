@@ -0,0 +1,60 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include "fan_policy.h"
+
+// 실행 중 교체 가능한 설정 파일 (GPIO 핀, 자동 팬 임계값, 판독 주기)
+//
+// 형식 (한 줄에 "<key> = <value>", '#' 주석, 없는 키는 기본값):
+//   relay_pin, dht_gpio                 : BCM GPIO 번호
+//   read_interval                       : 센서 판독 주기(초)
+//   temperature_threshold, humidity_threshold, dew_point_threshold,
+//   temperature_hysteresis, humidity_hysteresis, dew_point_hysteresis,
+//   min_on_seconds, min_off_seconds, prestart_horizon : fan_policy.h의 FanPolicy 항목
+//                                         (dew_point_threshold는 "off"로 끌 수 있으며 기본값도 off)
+//
+// 설정 파일이 있는 디렉터리를 inotify로 감시하므로 편집기가 임시 파일을 쓰고 이름을 바꾸는 경우도 잡힌다.
+// 변경이 감지되면 파일 전체를 새 설정 객체로 읽어 검증하고, 통과한 경우에만 현재 설정 포인터를 원자적으로
+// 바꾼다 (검증 실패 시 기존 설정 유지). 설정 객체는 만들어진 뒤 바뀌지 않으며, 다른 스레드가 읽고 있을 수
+// 있으므로 교체된 객체는 config_cleanup까지 해제하지 않는다 (교체 한 번에 객체 하나, 수십 바이트씩 남음).
+// 교체는 워커 루프의 안전한 지점에서만 한다.
+
+#define CONFIG_FILE_PATH "/etc/smart_vent/smart_vent.conf"
+
+// 기본값 (설정 파일이 없거나 키가 빠진 경우)
+#define CONFIG_DEFAULT_RELAY_PIN     24
+#define CONFIG_DEFAULT_DHT_GPIO      27
+#define CONFIG_DEFAULT_READ_INTERVAL 3
+
+typedef struct {
+    int relay_pin;
+    int dht_gpio;
+    int read_interval;    // 판독 주기(초)
+    FanPolicy policy;     // 자동 팬 판단 (스케줄의 구간별 임계값이 있으면 그쪽이 우선)
+    unsigned generation;  // 적용 순번 (시작 시 1, 교체할 때마다 증가)
+} RuntimeConfig;
+
+void config_defaults(RuntimeConfig *cfg);
+
+// 파일을 읽어 out에 채우고 검증 (오류는 줄 번호와 함께 stderr에 출력하고 -1)
+int config_parse(const char *path, RuntimeConfig *out);
+
+// 시작 설정 적용 및 감시 시작 (path가 NULL이면 기본값만, 파일이 없거나 잘못되면 기본값으로 시작하고 -1)
+int config_init(const char *path);
+
+// 현재 설정 (항상 유효, 반환된 객체는 config_cleanup까지 유지됨)
+const RuntimeConfig *config_current();
+
+// 설정 파일 변경 시 읽기 가능해지는 inotify fd (감시하지 않으면 -1)
+int config_watch_fd();
+
+// 쌓인 변경 알림을 비우고, 설정 파일이 바뀌었으면 다시 읽어 교체
+// 교체했으면 1, 변경 없음 0, 검증 실패로 기존 설정 유지 -1
+int config_reload();
+
+// previous로 되돌림 (교체한 설정을 하드웨어에 적용하지 못한 경우)
+void config_rollback(const RuntimeConfig *previous);
+
+void config_cleanup();
+
+#endif
@@ -0,0 +1,367 @@
+#include "schedule.h"
+#include "timer_wheel.h"
+#include "logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <pthread.h>
+
+typedef enum { RULE_VENT, RULE_QUIET, RULE_THRESH } RuleType;
+
+typedef struct ScheduleRule {
+    int id;
+    int zone;
+    unsigned int days;  // 요일 비트 (bit0 = 일요일, struct tm의 tm_wday 기준)
+    int start_min;      // 자정 기준 분
+    int end_min;
+    RuleType type;
+    float temperature;  // THRESH 전용
+    float humidity;
+    int active;
+    TimerNode timer;    // 다음 경계에서 깨어날 타이머
+    char spec[SCHEDULE_SPEC_LEN];
+    struct ScheduleRule *next;
+} ScheduleRule;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static TimerWheel g_wheel;
+static int g_initialized = 0;
+static ScheduleRule *g_rules = NULL; // 추가 순서대로 연결
+static int g_next_id = 1;
+static int g_changed = 0;
+
+// 구역별 활성 규칙 수와 현재 효과
+static int g_active_vent[SCHEDULE_MAX_ZONES];
+static int g_active_quiet[SCHEDULE_MAX_ZONES];
+static ScheduleEffect g_effect[SCHEDULE_MAX_ZONES];
+
+static const char *day_names[7] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+
+/* --- 규칙 문자열 해석 --- */
+
+static int parse_day(const char *s, size_t len) {
+    for (int i = 0; i < 7; i++) {
+        if (len == 3 && strncasecmp(s, day_names[i], 3) == 0) return i;
+    }
+    return -1;
+}
+
+// "daily", "weekdays", "weekends", "mon,wed,fri", "mon-fri", "fri-mon"
+static int parse_days(const char *s, unsigned int *mask) {
+    if (strcasecmp(s, "daily") == 0) { *mask = 0x7F; return 0; }
+    if (strcasecmp(s, "weekdays") == 0) { *mask = 0x3E; return 0; }
+    if (strcasecmp(s, "weekends") == 0) { *mask = 0x41; return 0; }
+
+    *mask = 0;
+    while (*s) {
+        const char *comma = strchr(s, ',');
+        size_t len = comma ? (size_t)(comma - s) : strlen(s);
+        const char *dash = memchr(s, '-', len);
+        if (dash) {
+            int from = parse_day(s, dash - s);
+            int to = parse_day(dash + 1, len - (dash - s) - 1);
+            if (from < 0 || to < 0) return -1;
+            for (int d = from; ; d = (d + 1) % 7) {
+                *mask |= 1u << d;
+                if (d == to) break;
+            }
+        } else {
+            int d = parse_day(s, len);
+            if (d < 0) return -1;
+            *mask |= 1u << d;
+        }
+        s += len;
+        if (*s == ',') s++;
+    }
+    return *mask ? 0 : -1;
+}
+
+static int parse_rule(const char *spec, ScheduleRule *rule) {
+    char days[32], type[16];
+    int sh, sm, eh, em, consumed = 0;
+    float a = 0.0f, b = 0.0f;
+
+    if (sscanf(spec, "%d %31s %d:%d-%d:%d %15s %n", &rule->zone, days, &sh, &sm, &eh, &em, type, &consumed) < 7)
+        return -1;
+    if (rule->zone < 0 || rule->zone >= SCHEDULE_MAX_ZONES) return -1;
+    if (sh < 0 || sh > 24 || eh < 0 || eh > 24 || sm < 0 || sm > 59 || em < 0 || em > 59) return -1;
+    if ((sh == 24 && sm != 0) || (eh == 24 && em != 0)) return -1;
+    if (parse_days(days, &rule->days) != 0) return -1;
+    rule->start_min = (sh * 60 + sm) % 1440;
+    rule->end_min = (eh * 60 + em) % 1440;
+
+    if (strcasecmp(type, "VENT") == 0) rule->type = RULE_VENT;
+    else if (strcasecmp(type, "QUIET") == 0) rule->type = RULE_QUIET;
+    else if (strcasecmp(type, "THRESH") == 0) {
+        if (sscanf(spec + consumed, "%f %f", &a, &b) != 2) return -1;
+        rule->type = RULE_THRESH;
+        rule->temperature = a;
+        rule->humidity = b;
+    } else return -1;
+    return 0;
+}
+
+/* --- 경계 계산 --- */
+
+// now 시점에 규칙 구간 안인지와 다음 경계 시각. 현지 시각 기준이며 DST는 mktime에 맡김
+static void evaluate(const ScheduleRule *rule, time_t now, int *active, time_t *next_edge) {
+    struct tm today;
+    localtime_r(&now, &today);
+
+    int duration = (rule->end_min - rule->start_min + 1440) % 1440;
+    if (duration == 0) duration = 1440; // 하루 종일
+
+    *active = 0;
+    *next_edge = now + 8 * 86400;
+
+    // 자정을 넘는 구간 때문에 전날부터 확인
+    for (int d = -1; d <= 7; d++) {
+        struct tm day = today;
+        day.tm_mday += d;
+        day.tm_hour = rule->start_min / 60;
+        day.tm_min = rule->start_min % 60;
+        day.tm_sec = 0;
+        day.tm_isdst = -1;
+        time_t start = mktime(&day); // tm_wday도 정규화됨
+        if (!(rule->days & (1u << day.tm_wday))) continue;
+
+        time_t end = start + duration * 60;
+        if (start <= now && now < end) {
+            *active = 1;
+            if (end < *next_edge) *next_edge = end;
+        } else if (start > now && start < *next_edge) {
+            *next_edge = start;
+        }
+    }
+}
+
+static void recompute_thresholds(int zone) {
+    ScheduleEffect *e = &g_effect[zone];
+    e->has_thresholds = 0;
+    for (ScheduleRule *r = g_rules; r; r = r->next) {
+        if (r->zone != zone || r->type != RULE_THRESH || !r->active) continue;
+        // 겹치면 더 일찍 환기하는 쪽(낮은 값)을 적용
+        if (!e->has_thresholds || r->temperature < e->temperature_threshold) e->temperature_threshold = r->temperature;
+        if (!e->has_thresholds || r->humidity < e->humidity_threshold) e->humidity_threshold = r->humidity;
+        e->has_thresholds = 1;
+    }
+}
+
+static const char *rule_type_name(RuleType type) {
+    switch (type) {
+    case RULE_VENT:   return "VENT";
+    case RULE_QUIET:  return "QUIET";
+    case RULE_THRESH: return "THRESH";
+    }
+    return "?";
+}
+
+static void set_active(ScheduleRule *rule, int active) {
+    if (rule->active == active) return;
+    rule->active = active;
+
+    int delta = active ? 1 : -1;
+    int zone = rule->zone;
+    switch (rule->type) {
+    case RULE_VENT:
+        g_active_vent[zone] += delta;
+        g_effect[zone].force_vent = g_active_vent[zone] > 0;
+        break;
+    case RULE_QUIET:
+        g_active_quiet[zone] += delta;
+        g_effect[zone].quiet = g_active_quiet[zone] > 0;
+        break;
+    case RULE_THRESH:
+        recompute_thresholds(zone);
+        break;
+    }
+    g_changed = 1;
+    // 워커 루프에서 g_lock을 잡은 채 호출되므로 표준출력을 기다리지 않도록 로거로 출력
+    // (로그 항목의 문자열 공간이 작아 규칙 원문 대신 종류와 시간대만)
+    if (active) {
+        log_info("[Schedule] Rule %d started: %s %02d:%02d-%02d:%02d", rule->id, rule_type_name(rule->type),
+                 rule->start_min / 60, rule->start_min % 60, rule->end_min / 60, rule->end_min % 60);
+    } else {
+        log_info("[Schedule] Rule %d ended: %s %02d:%02d-%02d:%02d", rule->id, rule_type_name(rule->type),
+                 rule->start_min / 60, rule->start_min % 60, rule->end_min / 60, rule->end_min % 60);
+    }
+}
+
+static void rule_timer_cb(TimerNode *node, int64_t now, void *arg) {
+    ScheduleRule *rule = arg;
+    int active;
+    time_t next_edge;
+    (void)node;
+
+    evaluate(rule, (time_t)now, &active, &next_edge);
+    set_active(rule, active);
+    timer_wheel_add(&g_wheel, &rule->timer, next_edge);
+}
+
+/* --- 공개 함수 --- */
+
+static void init_locked(time_t now) {
+    if (g_initialized) return;
+    timer_wheel_init(&g_wheel, now);
+    memset(g_active_vent, 0, sizeof(g_active_vent));
+    memset(g_active_quiet, 0, sizeof(g_active_quiet));
+    memset(g_effect, 0, sizeof(g_effect));
+    g_initialized = 1;
+}
+
+void schedule_init(time_t now) {
+    pthread_mutex_lock(&g_lock);
+    init_locked(now);
+    pthread_mutex_unlock(&g_lock);
+}
+
+// id가 0보다 크면 그 ID를 사용 (파일에서 복원할 때 ID 유지)
+static int add_rule(const char *spec, time_t now, int id) {
+    ScheduleRule *rule = calloc(1, sizeof(ScheduleRule));
+    if (rule == NULL) return -1;
+
+    // 앞뒤 공백, 개행, 주석 제거 후 저장 (파일 저장 시 그대로 기록)
+    while (*spec == ' ' || *spec == '\t') spec++;
+    size_t len = strcspn(spec, "#\r\n");
+    if (len >= SCHEDULE_SPEC_LEN) len = SCHEDULE_SPEC_LEN - 1;
+    memcpy(rule->spec, spec, len);
+    while (len > 0 && (rule->spec[len - 1] == ' ' || rule->spec[len - 1] == '\t')) len--;
+    rule->spec[len] = '\0';
+
+    if (parse_rule(rule->spec, rule) != 0) {
+        log_warn("[Schedule] Invalid rule: %s", rule->spec);
+        free(rule);
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_lock);
+    init_locked(now);
+    if (id <= 0) id = g_next_id;
+    rule->id = id;
+    if (id >= g_next_id) g_next_id = id + 1;
+    timer_node_init(&rule->timer, rule_timer_cb, rule);
+
+    ScheduleRule **tail = &g_rules;
+    while (*tail) tail = &(*tail)->next;
+    *tail = rule;
+
+    // 현재 상태를 바로 반영하고 다음 경계에 타이머 등록
+    rule_timer_cb(&rule->timer, g_wheel.now > now ? g_wheel.now : now, rule);
+    pthread_mutex_unlock(&g_lock);
+    return id;
+}
+
+int schedule_add(const char *spec, time_t now) {
+    return add_rule(spec, now, 0);
+}
+
+static void remove_locked(ScheduleRule **link) {
+    ScheduleRule *rule = *link;
+    timer_wheel_remove(&g_wheel, &rule->timer);
+    *link = rule->next;
+    rule->next = NULL;
+    set_active(rule, 0);
+    free(rule);
+}
+
+int schedule_remove(int id) {
+    int ret = -1;
+    pthread_mutex_lock(&g_lock);
+    for (ScheduleRule **link = &g_rules; *link; link = &(*link)->next) {
+        if ((*link)->id == id) {
+            remove_locked(link);
+            ret = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_lock);
+    return ret;
+}
+
+void schedule_clear() {
+    pthread_mutex_lock(&g_lock);
+    while (g_rules) remove_locked(&g_rules);
+    pthread_mutex_unlock(&g_lock);
+}
+
+void schedule_cleanup() {
+    schedule_clear();
+}
+
+int schedule_advance(time_t now) {
+    pthread_mutex_lock(&g_lock);
+    if (g_initialized) timer_wheel_advance(&g_wheel, now);
+    int changed = g_changed;
+    g_changed = 0;
+    pthread_mutex_unlock(&g_lock);
+    return changed;
+}
+
+time_t schedule_next_wakeup() {
+    pthread_mutex_lock(&g_lock);
+    time_t next = g_initialized ? (time_t)timer_wheel_next_wakeup(&g_wheel) : -1;
+    pthread_mutex_unlock(&g_lock);
+    return next;
+}
+
+void schedule_get_effect(int zone, ScheduleEffect *out) {
+    pthread_mutex_lock(&g_lock);
+    if (zone >= 0 && zone < SCHEDULE_MAX_ZONES && g_initialized) *out = g_effect[zone];
+    else memset(out, 0, sizeof(*out));
+    pthread_mutex_unlock(&g_lock);
+}
+
+void schedule_log_rules() {
+    pthread_mutex_lock(&g_lock);
+    for (ScheduleRule *r = g_rules; r; r = r->next) {
+        if (r->active) {
+            log_info("[Schedule] Rule %d (active): %s %02d:%02d-%02d:%02d", r->id, rule_type_name(r->type),
+                     r->start_min / 60, r->start_min % 60, r->end_min / 60, r->end_min % 60);
+        } else {
+            log_info("[Schedule] Rule %d: %s %02d:%02d-%02d:%02d", r->id, rule_type_name(r->type),
+                     r->start_min / 60, r->start_min % 60, r->end_min / 60, r->end_min % 60);
+        }
+    }
+    pthread_mutex_unlock(&g_lock);
+}
+
+int schedule_load(const char *path, time_t now) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        if (errno == ENOENT) return 0; // 스케줄 없음
+        perror("[Schedule] Failed to open schedule file");
+        return -1;
+    }
+    char line[SCHEDULE_SPEC_LEN + 32];
+    int loaded = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        const char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\0') continue;
+        const char *id_tag = strstr(p, "#id=");
+        if (add_rule(p, now, id_tag ? atoi(id_tag + 4) : 0) > 0) loaded++;
+    }
+    fclose(fp);
+    printf("[Schedule] Loaded %d rules from %s\n", loaded, path);
+    return loaded;
+}
+
+int schedule_save(const char *path) {
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *fp = fopen(tmp_path, "w");
+    if (fp == NULL) {
+        log_error("[Schedule] Failed to write schedule file: %s", strerror(errno));
+        return -1;
+    }
+    fprintf(fp, "# <zone> <days> <HH:MM>-<HH:MM> VENT|QUIET|THRESH <temp> <humi>  #id=<rule id>\n");
+    pthread_mutex_lock(&g_lock);
+    for (ScheduleRule *r = g_rules; r; r = r->next) fprintf(fp, "%s  #id=%d\n", r->spec, r->id);
+    pthread_mutex_unlock(&g_lock);
+    if (fclose(fp) != 0 || rename(tmp_path, path) != 0) {
+        log_error("[Schedule] Failed to replace schedule file: %s", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
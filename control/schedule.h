@@ -0,0 +1,55 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdio.h>
+#include <time.h>
+
+// 시간대별 운전 스케줄
+//
+// 규칙 형식 (원격 명령 SCHED_ADD 및 스케줄 파일의 한 줄):
+//   <zone> <days> <HH:MM>-<HH:MM> <type> [args]
+//     days : daily | weekdays | weekends | mon,wed | mon-fri ...
+//     type : VENT                 강제 환기 구간 (자동 모드에서 팬 가동)
+//            QUIET                조용한 시간 (버저 경고 억제)
+//            THRESH <temp> <humi> 구간별 자동 팬 임계값
+//   종료 시각이 시작보다 이르면 자정을 넘는 구간, 같으면 하루 종일이다.
+//   예) 0 weekdays 08:00-09:00 VENT, 0 daily 22:00-07:00 QUIET
+//
+// 각 규칙은 다음 경계(시작/종료) 시각에 타이머 휠 노드 하나를 걸어 두므로 규칙이 수천 개여도
+// 틱당 비용은 일정하다. 경계에서만 구역별 효과(활성 규칙 수, 임계값)가 갱신된다.
+// 모든 함수는 내부 뮤텍스로 보호된다.
+
+#define SCHEDULE_MAX_ZONES 8
+#define SCHEDULE_SPEC_LEN  96
+
+typedef struct {
+    int force_vent;     // 강제 환기 구간 진행 중
+    int quiet;          // 조용한 시간 진행 중
+    int has_thresholds; // 구간별 임계값 적용 중
+    float temperature_threshold;
+    float humidity_threshold;
+} ScheduleEffect;
+
+void schedule_init(time_t now);
+void schedule_cleanup();
+
+// 규칙 추가. 규칙 ID 반환 (형식 오류 시 -1)
+int schedule_add(const char *spec, time_t now);
+int schedule_remove(int id); // 없으면 -1
+void schedule_clear();
+
+// now까지 진행. 구역 효과가 바뀌었으면 1
+int schedule_advance(time_t now);
+// 다음 경계 확인 시각 (규칙이 없으면 -1)
+time_t schedule_next_wakeup();
+
+void schedule_get_effect(int zone, ScheduleEffect *out);
+
+// 규칙 ID, 종류, 시간대를 한 줄씩 로그에 출력 (SCHED_LIST, 규칙 원문은 스케줄 파일에 있음)
+void schedule_log_rules();
+
+// 스케줄 파일 (한 줄에 규칙 하나, '#' 주석). 저장 시 줄 끝에 "#id=N"을 붙여 재시작 후에도 ID 유지
+int schedule_load(const char *path, time_t now);
+int schedule_save(const char *path);
+
+#endif
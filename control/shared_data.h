@@ -0,0 +1,30 @@
+#ifndef SHARED_DATA_H
+#define SHARED_DATA_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include "psychrometrics.h"
+
+// 시스템의 작동 모드
+typedef enum { AUTOMATIC, MANUAL } SystemMode;
+
+// 제어 데몬의 스레드 간에 공유될 데이터 구조체 (GTK 의존성 없음)
+// GUI 클라이언트는 별도 프로세스로, 이 구조체 대신 공유 메모리 스냅샷을 읽는다
+typedef struct {
+    float temperature;            // 검증/필터를 거친 값 (제어 파이프라인이 갱신)
+    float humidity;
+    float raw_temperature;        // 센서 콜백이 받은 최신 판독값
+    float raw_humidity;
+    PsychroValues derived;        // 이슬점/절대습도/체감온도 (센서 값 처리 시 갱신)
+    float threshold_eta;          // 온도/습도 임계값 도달 예상 시간(초, 예측 없음 -1)
+    bool fan_prestart;            // 예측에 따른 팬 선행 가동 여부
+    SystemMode mode;
+    bool is_running;              // 팬 작동 여부
+    float fan_duty;               // 팬 속도 (0.0~1.0, 릴레이 전용이면 0 또는 1)
+    bool is_alert_active;         // 경고 활성화 상태
+    bool new_data_available;      // 새 센서 데이터 수신 플래그
+    bool shutdown_requested;      // 워커 스레드 종료 요청 플래그
+    pthread_mutex_t mutex;        // 데이터 보호를 위한 뮤텍스
+} SharedData;
+
+#endif
@@ -0,0 +1,320 @@
+#include "sim_hw.h"
+#include "dht11_driver.h"
+#include "motor_driver.h"
+#include "buzzer_driver.h"
+#include "lcd_driver.h"
+#include "control_logic.h"
+#include "clock_source.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_COMMAND_LEN 16
+
+typedef struct {
+    double offset;      // 트레이스 시작 기준 경과 시간(초)
+    float temperature;
+    float humidity;
+    char command[SIM_COMMAND_LEN]; // 해당 시점에 주입할 원격 명령 (없으면 빈 문자열)
+} SimSample;
+
+static SimSample *samples = NULL;
+static size_t sample_count = 0;
+static size_t cursor = 0;   // 다음에 적용할 샘플 인덱스
+static double start_time = 0.0;
+
+static SharedData *g_shared_data = NULL;
+
+// 시뮬레이션 통계
+static int fan_on = 0;
+static double fan_on_since = 0.0;
+static double fan_on_total = 0.0;
+static int fan_toggles = 0;
+static int fan_pwm = 0;
+static float fan_duty = 0.0f;
+static double fan_duty_since = 0.0;
+static double fan_duty_total = 0.0; // 듀티 x 시간 적분 (최대 속도 환산 가동 시간)
+static int buzzer_count = 0;
+static int buzzer_active = 0;
+static double buzzer_on_since = 0.0;
+static double buzzer_total = 0.0;
+static int sensor_reads = 0;
+static int lcd_updates = 0;
+static int commands_applied = 0;
+static FILE *relay_log = NULL;
+
+static void print_event(const char *event) {
+    double t = clock_now() - start_time;
+    int sec = (int)t;
+    printf("[Sim] %02d:%02d:%02d (+%.0fs) %s\n", (sec / 3600) % 24, (sec / 60) % 60, sec % 60, t, event);
+}
+
+int sim_set_relay_log(const char *path) {
+    if (path == NULL) return 0;
+    relay_log = fopen(path, "w");
+    if (relay_log == NULL) {
+        perror("[Error] Failed to open relay log");
+        return -1;
+    }
+    setvbuf(relay_log, NULL, _IOLBF, 0); // 부하 시험 도구가 바로 읽을 수 있도록 줄 단위로 기록
+    return 0;
+}
+
+static void log_relay(int on, float duty) {
+    if (relay_log) fprintf(relay_log, "%.6f %s %.0f\n", clock_now(), on ? "ON" : "OFF", duty * 100.0f);
+}
+
+int sim_load_trace(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        perror("[Error] Failed to open trace file");
+        return -1;
+    }
+
+    size_t capacity = 1024;
+    samples = malloc(capacity * sizeof(SimSample));
+    if (samples == NULL) {
+        fclose(fp);
+        return -1;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        SimSample s;
+        char cmd[SIM_COMMAND_LEN] = {0};
+        int n = sscanf(line, "%lf,%f,%f,%15s", &s.offset, &s.temperature, &s.humidity, cmd);
+        if (n < 3) {
+            fprintf(stderr, "[Sim] Skipping malformed trace line: %s", line);
+            continue;
+        }
+        strcpy(s.command, cmd);
+
+        if (sample_count == capacity) {
+            capacity *= 2;
+            SimSample *grown = realloc(samples, capacity * sizeof(SimSample));
+            if (grown == NULL) {
+                fclose(fp);
+                return -1;
+            }
+            samples = grown;
+        }
+        samples[sample_count++] = s;
+    }
+    fclose(fp);
+
+    if (sample_count == 0) {
+        fprintf(stderr, "[Sim] Trace %s contains no samples.\n", path);
+        return -1;
+    }
+    printf("[Sim] Loaded %zu samples (%.0f seconds) from %s\n", sample_count, sim_trace_duration(), path);
+    return 0;
+}
+
+double sim_trace_duration() {
+    return sample_count ? samples[sample_count - 1].offset : 0.0;
+}
+
+void sim_print_summary(double wall_seconds) {
+    double now = clock_now();
+    if (fan_on) fan_on_total += now - fan_on_since;
+    fan_duty_total += fan_duty * (now - fan_duty_since);
+    fan_duty_since = now;
+
+    printf("\n[Sim] ---- Simulation summary ----\n");
+    printf("[Sim] Simulated time : %.0f s (%.2f h)\n", now - start_time, (now - start_time) / 3600.0);
+    printf("[Sim] Wall time      : %.3f s\n", wall_seconds);
+    printf("[Sim] Sensor reads   : %d\n", sensor_reads);
+    printf("[Sim] LCD updates    : %d\n", lcd_updates);
+    printf("[Sim] Remote cmds    : %d\n", commands_applied);
+    printf("[Sim] Fan toggles    : %d\n", fan_toggles);
+    printf("[Sim] Fan on-time    : %.0f s (%.1f %%)\n", fan_on_total,
+           now > start_time ? 100.0 * fan_on_total / (now - start_time) : 0.0);
+    if (fan_pwm) {
+        printf("[Sim] Fan mean duty  : %.1f %% while on (full-speed equivalent %.0f s)\n",
+               fan_on_total > 0.0 ? 100.0 * fan_duty_total / fan_on_total : 0.0, fan_duty_total);
+    }
+    printf("[Sim] Buzzer alerts  : %d (%.0f s total)\n", buzzer_count, buzzer_total);
+}
+
+/* --- motor_driver 대체 --- */
+
+int init_pigpio() {
+    return 0;
+}
+
+int get_pi_handle() {
+    return 0;
+}
+
+int setup_gpio() {
+    return 0;
+}
+
+int motor_set_relay_pin(int pin) {
+    (void)pin;
+    return 0;
+}
+
+int setup_fan_pwm() {
+    fan_pwm = 1;
+    return 0;
+}
+
+int fan_pwm_enabled() {
+    return fan_pwm;
+}
+
+void ventilation_set_duty(float duty) {
+    if (duty < 0.0f) duty = 0.0f;
+    if (duty > 1.0f) duty = 1.0f;
+    if (!fan_pwm && duty > 0.0f) duty = 1.0f;
+
+    double now = clock_now();
+    fan_duty_total += fan_duty * (now - fan_duty_since);
+    fan_duty_since = now;
+    fan_duty = duty;
+
+    if (duty > 0.0f && !fan_on) {
+        fan_on = 1;
+        fan_on_since = now;
+        fan_toggles++;
+        print_event("Fan ON");
+        log_relay(1, duty);
+    } else if (duty == 0.0f && fan_on) {
+        fan_on = 0;
+        fan_on_total += now - fan_on_since;
+        fan_toggles++;
+        print_event("Fan OFF");
+        log_relay(0, duty);
+    }
+}
+
+float get_fan_duty() {
+    return fan_duty;
+}
+
+void ventilation_on() {
+    ventilation_set_duty(1.0f);
+}
+
+void ventilation_off() {
+    ventilation_set_duty(0.0f);
+}
+
+unsigned int get_fan_toggle_count() {
+    return fan_toggles;
+}
+
+void cleanup_pigpio() {
+    ventilation_off();
+}
+
+/* --- buzzer_driver 대체 --- */
+
+int buzzer_init() {
+    return 0;
+}
+
+void buzzer_on() {
+    if (buzzer_active) return;
+    buzzer_active = 1;
+    buzzer_on_since = clock_now();
+    buzzer_count++;
+    print_event("Buzzer ON");
+}
+
+void buzzer_off() {
+    if (!buzzer_active) return;
+    buzzer_active = 0;
+    buzzer_total += clock_now() - buzzer_on_since;
+    print_event("Buzzer OFF");
+}
+
+/* --- lcd_driver 대체 --- */
+
+void lcd_display_update(const char *headline, float temp, float humi) {
+    (void)headline;
+    (void)temp;
+    (void)humi;
+    lcd_updates++;
+}
+
+/* --- dht11_driver 대체 --- */
+
+int dht11_init(SharedData *data) {
+    g_shared_data = data;
+    cursor = 0;
+    start_time = clock_now();
+    return 0;
+}
+
+int dht11_set_gpio(int gpio) {
+    (void)gpio;
+    return 0;
+}
+
+// 현재 가상 시각까지의 샘플을 적용하고 가장 최근 값을 센서 값으로 전달
+// (시뮬레이션에서는 판독이 즉시 완료되므로 완료 fd가 필요 없음)
+int dht11_start_read() {
+    if (g_shared_data == NULL || sample_count == 0) return -1;
+
+    double offset = clock_now() - start_time;
+
+    // 트레이스가 끝나면 워커 스레드 종료 요청
+    if (offset > samples[sample_count - 1].offset) {
+        pthread_mutex_lock(&g_shared_data->mutex);
+        g_shared_data->shutdown_requested = true;
+        pthread_mutex_unlock(&g_shared_data->mutex);
+        return 0;
+    }
+
+    const SimSample *latest = NULL;
+    while (cursor < sample_count && samples[cursor].offset <= offset) {
+        latest = &samples[cursor];
+        if (latest->command[0] != '\0') {
+            control_handle_remote_command(g_shared_data, latest->command);
+            commands_applied++;
+        }
+        cursor++;
+    }
+    if (latest == NULL && cursor > 0) latest = &samples[cursor - 1];
+    if (latest == NULL) return 0;
+
+    sensor_reads++;
+    pthread_mutex_lock(&g_shared_data->mutex);
+    g_shared_data->raw_temperature = latest->temperature;
+    g_shared_data->raw_humidity = latest->humidity;
+    g_shared_data->new_data_available = true;
+    pthread_mutex_unlock(&g_shared_data->mutex);
+    return 0;
+}
+
+int dht11_get_fd() {
+    return -1;
+}
+
+void dht11_complete_read() {
+}
+
+unsigned int dht11_get_error_count() {
+    return 0;
+}
+
+void dht11_get_status_counts(unsigned int counts[4]) {
+    // 트레이스 값은 항상 정상 판독으로 취급
+    counts[0] = sensor_reads;
+    counts[1] = counts[2] = counts[3] = 0;
+}
+
+void dht11_cleanup() {
+    g_shared_data = NULL;
+    if (relay_log) {
+        fclose(relay_log);
+        relay_log = NULL;
+    }
+    free(samples);
+    samples = NULL;
+    sample_count = 0;
+}
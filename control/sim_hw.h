@@ -0,0 +1,17 @@
+#ifndef SIM_HW_H
+#define SIM_HW_H
+
+// 시뮬레이션용 하드웨어 대체 구현
+// motor_driver / buzzer_driver / lcd_driver / dht11_driver 와 같은 함수를 제공하며,
+// 센서 값은 기록된 트레이스 파일에서 가상 시계 기준으로 읽어 온다.
+//
+// 트레이스 형식 (CSV, '#'으로 시작하는 줄은 주석):
+//   <경과 초>,<온도>,<습도>[,<REMOTE_ON|REMOTE_OFF|REMOTE_AUTO>]
+
+int sim_load_trace(const char *path); // 트레이스 로드 (실패 시 -1)
+double sim_trace_duration(); // 트레이스 길이(초)
+void sim_print_summary(double wall_seconds); // 시뮬레이션 결과 출력
+// 팬 릴레이 전환을 "<epoch 초> <ON|OFF> <듀티 %>" 줄로 기록 (부하 시험의 명령->릴레이 지연 측정용, NULL이면 기록 안 함)
+int sim_set_relay_log(const char *path);
+
+#endif
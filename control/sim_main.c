@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <signal.h>
+#include <errno.h>
+#include "shared_data.h"
+#include "control_logic.h"
+#include "dht11_driver.h"
+#include "clock_source.h"
+#include "sim_hw.h"
+#include "logger.h"
+#include "motor_driver.h"
+#include "runtime_config.h"
+
+// 기록된 센서 데이터로 제어 루프를 가상 시간에서 실행하는 시뮬레이터
+// 사용법: smart_ventilation_sim <trace.csv> [status_file] [archive_file] [schedule_file]
+//
+// SIM_LIVE=1 이면 가상 시계 대신 실제 시간으로 트레이스를 재생하고 원격 제어 FIFO를 열어,
+// 실제 하드웨어 없이 remote_control_server.py와 함께 원격 경로를 부하 시험할 수 있다.
+// (SIM_RELAY_LOG=<file>: 팬 릴레이 전환 시각 기록, Ctrl+C/SIGTERM으로 조기 종료)
+// SIM_PIPELINE_BENCH=<N>: 재생 후 제어 파이프라인의 단독 실행 가능한 단계를 N번씩 실행해 비용 측정
+// SIM_CONFIG=<file>: 실행 중 교체 가능한 설정 파일 (실시간 재생 중 수정하면 바로 반영, 기본: 내장 기본값)
+
+static volatile int worker_finished = 0;
+
+static void *sim_worker(void *user_data) {
+    // 가상 시계가 이 스레드의 대기를 기준으로 시간을 진행하도록 등록
+    clock_register_thread();
+    worker_thread_func(user_data);
+    clock_unregister_thread();
+    worker_finished = 1;
+    return NULL;
+}
+
+// 실시간 재생: 트레이스가 끝나거나 종료 시그널을 받을 때까지 대기
+static void wait_live_worker(SharedData *data, const sigset_t *exit_signals) {
+    struct timespec poll_interval = { 0, 200 * 1000000L };
+    while (!worker_finished) {
+        if (sigtimedwait(exit_signals, NULL, &poll_interval) > 0) {
+            printf("\n[Sim] Stopping live simulation...\n");
+            pthread_mutex_lock(&data->mutex);
+            data->shutdown_requested = true;
+            pthread_mutex_unlock(&data->mutex);
+            return;
+        }
+    }
+}
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <trace.csv> [status_file] [archive_file] [schedule_file] [alarm_rules]\n", argv[0]);
+        return 1;
+    }
+
+    if (sim_load_trace(argv[1]) != 0) return 1;
+
+    const char *live_env = getenv("SIM_LIVE");
+    bool live = live_env && strcmp(live_env, "1") == 0;
+    sigset_t exit_signals;
+    sigemptyset(&exit_signals);
+    sigaddset(&exit_signals, SIGINT);
+    sigaddset(&exit_signals, SIGTERM);
+
+    if (live) {
+        // 워커 스레드가 시그널로 중단되지 않도록 먼저 막아 둠
+        pthread_sigmask(SIG_BLOCK, &exit_signals, NULL);
+        printf("[Sim] Live mode: replaying trace in real time with the remote control FIFO.\n");
+        sim_set_relay_log(getenv("SIM_RELAY_LOG"));
+    } else {
+        // 가상 시계는 0초(자정)부터 시작, 스케줄의 요일/시각도 UTC 기준으로 해석
+        clock_use_virtual(0.0);
+        setenv("TZ", "UTC", 1);
+        tzset();
+    }
+
+    // 가상 시간에서는 원격 제어 FIFO를 사용하지 않고 (명령은 트레이스에서 주입), 상태 파일은 선택적으로 기록
+    control_set_io_paths(live ? "/tmp/smart_vent_fifo" : NULL, argc > 2 ? argv[2] : NULL);
+    control_set_archive_path(argc > 3 ? argv[3] : NULL);
+    control_set_schedule_path(argc > 4 ? argv[4] : NULL);
+    control_set_alarm_rules_path(argc > 5 ? argv[5] : NULL);
+    control_set_telemetry(NULL, 0);
+    control_set_energy_path(NULL); // 집계는 요약에만 출력하고 저장하지 않음
+    control_set_pipeline_stats_path(NULL); // 단계별 처리 시간은 타이밍 보고에만 출력
+    config_init(getenv("SIM_CONFIG"));
+
+    // PWM 속도 제어 (SIM_FAN_PWM=1), 기본은 릴레이 ON/OFF
+    const char *fan_pwm = getenv("SIM_FAN_PWM");
+    if (fan_pwm && strcmp(fan_pwm, "1") == 0) setup_fan_pwm();
+
+    // 제어 경로 로그 (SIM_LOG_LEVEL=debug 로 센서/판독 디버그 메시지 확인)
+    const char *level_name = getenv("SIM_LOG_LEVEL");
+    int level = level_name ? logger_parse_level(level_name) : -1;
+    logger_start(NULL, level >= 0 ? (LogLevel)level : LOG_LEVEL_INFO);
+
+    SharedData shared_data;
+    shared_data.temperature = 0.0f;
+    shared_data.humidity = 0.0f;
+    shared_data.raw_temperature = 0.0f;
+    shared_data.raw_humidity = 0.0f;
+    shared_data.derived = (PsychroValues){0.0f, 0.0f, 0.0f};
+    shared_data.threshold_eta = -1.0f;
+    shared_data.fan_prestart = false;
+    shared_data.mode = AUTOMATIC;
+    shared_data.is_running = false;
+    shared_data.fan_duty = 0.0f;
+    shared_data.is_alert_active = false;
+    shared_data.new_data_available = false;
+    shared_data.shutdown_requested = false;
+    pthread_mutex_init(&shared_data.mutex, NULL);
+
+    dht11_init(&shared_data);
+
+    double wall_start = wall_seconds();
+
+    pthread_t worker_thread;
+    if (pthread_create(&worker_thread, NULL, sim_worker, &shared_data) != 0) {
+        perror("[Error] pthread_create failed");
+        return 1;
+    }
+    if (live) wait_live_worker(&shared_data, &exit_signals);
+    pthread_join(worker_thread, NULL);
+
+    // 단계별 단독 실행 비용 (SIM_PIPELINE_BENCH=<반복 횟수>)
+    const char *bench = getenv("SIM_PIPELINE_BENCH");
+    if (bench && atoi(bench) > 0) control_pipeline_bench(atoi(bench));
+
+    control_logic_cleanup();
+    logger_stop();
+    sim_print_summary(wall_seconds() - wall_start);
+
+    dht11_cleanup();
+    config_cleanup();
+    pthread_mutex_destroy(&shared_data.mutex);
+    return 0;
+}
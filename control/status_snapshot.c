@@ -0,0 +1,93 @@
+#include "status_snapshot.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// 시퀀스 번호와 스냅샷을 한 영역에 두어 프로세스 간에도 같은 seqlock으로 읽음
+typedef struct {
+    uint32_t sequence; // 홀수이면 기록 중
+    StatusSnapshot current;
+} SnapshotRegion;
+
+static SnapshotRegion local_region;
+static SnapshotRegion *region = &local_region; // 공유 메모리에 게시 중이면 매핑 영역
+static const char *shared_name = NULL;
+static uint32_t next_version = 0;
+
+void snapshot_publish(const StatusSnapshot *snapshot) {
+    __atomic_add_fetch(&region->sequence, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(&region->current, snapshot, sizeof(region->current));
+    region->current.version = ++next_version;
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_add_fetch(&region->sequence, 1, __ATOMIC_RELAXED);
+}
+
+void snapshot_read(StatusSnapshot *out) {
+    uint32_t before, after;
+    do {
+        before = __atomic_load_n(&region->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) continue; // 기록 중이면 다시 시도
+        memcpy(out, &region->current, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&region->sequence, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+}
+
+static SnapshotRegion *map_region(const char *name, int writable) {
+    int fd = shm_open(name, writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd == -1) return NULL;
+    if (writable && ftruncate(fd, sizeof(SnapshotRegion)) == -1) {
+        perror("[Snapshot] ftruncate failed");
+        close(fd);
+        return NULL;
+    }
+    void *addr = mmap(NULL, sizeof(SnapshotRegion), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    return addr == MAP_FAILED ? NULL : (SnapshotRegion*)addr;
+}
+
+int snapshot_share(const char *name) {
+    SnapshotRegion *shared = map_region(name, 1);
+    if (shared == NULL) {
+        perror("[Snapshot] Failed to create shared status");
+        return -1;
+    }
+    // 지금까지 게시된 스냅샷을 옮긴 뒤 전환 (단일 기록자이므로 게시와 겹치지 않음)
+    shared->current = region->current;
+    __atomic_store_n(&shared->sequence, 0, __ATOMIC_RELEASE);
+    region = shared;
+    shared_name = name;
+    printf("[Snapshot] Publishing status to shared memory %s\n", name);
+    return 0;
+}
+
+void snapshot_unshare() {
+    if (shared_name == NULL) return;
+    SnapshotRegion *shared = region;
+    local_region.current = shared->current;
+    region = &local_region;
+    munmap(shared, sizeof(SnapshotRegion));
+    shm_unlink(shared_name);
+    shared_name = NULL;
+}
+
+int snapshot_attach(const char *name) {
+    SnapshotRegion *shared = map_region(name, 0);
+    if (shared == NULL) return -1;
+    snapshot_detach();
+    region = shared;
+    shared_name = NULL; // 읽기 전용 매핑은 해제만 하고 삭제하지 않음
+    return 0;
+}
+
+void snapshot_detach() {
+    if (region == &local_region || shared_name != NULL) return;
+    munmap(region, sizeof(SnapshotRegion));
+    region = &local_region;
+}
@@ -0,0 +1,41 @@
+#ifndef STATUS_SNAPSHOT_H
+#define STATUS_SNAPSHOT_H
+
+#include <stdint.h>
+
+// 제어 상태의 읽기 전용 스냅샷 (seqlock)
+// 제어 루프가 상태가 바뀔 때마다 게시하고, Modbus 서버 등 외부 인터페이스는
+// SharedData의 뮤텍스나 센서에 접근하지 않고 최신 스냅샷만 읽는다.
+// 제어 데몬은 스냅샷을 POSIX 공유 메모리에 게시하여 별도 프로세스인 GUI 클라이언트도
+// 같은 방식(잠금 없이 읽기)으로 상태를 확인한다.
+
+#define SNAPSHOT_SHM_NAME "/smart_vent_status"
+
+typedef struct {
+    float temperature;
+    float humidity;
+    uint8_t fan_on;       // 팬 작동 여부
+    uint8_t fan_duty;     // 팬 속도 (%, 릴레이 전용이면 0 또는 100)
+    uint8_t mode;         // SystemMode 값 (0: AUTOMATIC, 1: MANUAL)
+    uint8_t alert;        // 경고 상태
+    double reading_time;  // 마지막 센서 값 수신 시각 (clock_now 기준, 0이면 없음)
+    uint32_t fan_on_today_s; // 오늘 팬 가동 시간(초)
+    float energy_today_wh;   // 오늘 팬 추정 전력량
+    uint32_t version;     // 게시할 때마다 1씩 증가
+} StatusSnapshot;
+
+// 새 스냅샷 게시 (version은 내부에서 설정, 단일 기록자 가정 - 호출자가 직렬화)
+void snapshot_publish(const StatusSnapshot *snapshot);
+
+// 최신 스냅샷 읽기 (잠금 없이, 기록 중이면 재시도)
+void snapshot_read(StatusSnapshot *out);
+
+// 게시자: 이후 스냅샷을 공유 메모리 name에 게시 (실패 시 -1, 프로세스 내 게시는 계속 동작)
+int snapshot_share(const char *name);
+void snapshot_unshare(); // 공유 메모리 해제 및 삭제
+
+// 다른 프로세스(GUI 클라이언트): 공유 메모리 name을 읽기 전용으로 연결 (데몬이 없으면 -1)
+int snapshot_attach(const char *name);
+void snapshot_detach();
+
+#endif
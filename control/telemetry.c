@@ -0,0 +1,137 @@
+#include "telemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#define TELEMETRY_MAGIC   0x31545653u // "SVT1"
+#define TELEMETRY_VERSION 1
+
+static int sender_fd = -1;
+static struct sockaddr_in sender_dest;
+
+static void put_u32(uint8_t *p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = v >> (8 * i); }
+static void put_u64(uint8_t *p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = v >> (8 * i); }
+static uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+static uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+static void put_f32(uint8_t *p, float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    put_u32(p, u);
+}
+static float get_f32(const uint8_t *p) {
+    uint32_t u = get_u32(p);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/*
+ 프레임 레이아웃 (64바이트)
+   0 magic        4 version      5 flags       6 reserved(2)
+   8 node[16]    24 seq         28 timestamp_ms(8)
+  36 temperature 40 humidity    44 uptime_s    48 samples
+  52 fan_toggles 56 remote_commands            60 sensor_errors
+*/
+size_t telemetry_encode(const TelemetryFrame *frame, uint8_t *buf, size_t size) {
+    if (size < TELEMETRY_FRAME_SIZE) return 0;
+
+    memset(buf, 0, TELEMETRY_FRAME_SIZE);
+    put_u32(buf, TELEMETRY_MAGIC);
+    buf[4] = TELEMETRY_VERSION;
+    buf[5] = frame->flags;
+    memcpy(buf + 8, frame->node, TELEMETRY_NAME_LEN);
+    put_u32(buf + 24, frame->seq);
+    put_u64(buf + 28, frame->timestamp_ms);
+    put_f32(buf + 36, frame->temperature);
+    put_f32(buf + 40, frame->humidity);
+    put_u32(buf + 44, frame->uptime_s);
+    put_u32(buf + 48, frame->samples);
+    put_u32(buf + 52, frame->fan_toggles);
+    put_u32(buf + 56, frame->remote_commands);
+    put_u32(buf + 60, frame->sensor_errors);
+    return TELEMETRY_FRAME_SIZE;
+}
+
+int telemetry_decode(const uint8_t *buf, size_t size, TelemetryFrame *frame) {
+    if (size < TELEMETRY_FRAME_SIZE) return -1;
+    if (get_u32(buf) != TELEMETRY_MAGIC || buf[4] != TELEMETRY_VERSION) return -1;
+
+    frame->flags = buf[5];
+    memcpy(frame->node, buf + 8, TELEMETRY_NAME_LEN);
+    frame->seq = get_u32(buf + 24);
+    frame->timestamp_ms = get_u64(buf + 28);
+    frame->temperature = get_f32(buf + 36);
+    frame->humidity = get_f32(buf + 40);
+    frame->uptime_s = get_u32(buf + 44);
+    frame->samples = get_u32(buf + 48);
+    frame->fan_toggles = get_u32(buf + 52);
+    frame->remote_commands = get_u32(buf + 56);
+    frame->sensor_errors = get_u32(buf + 60);
+    return 0;
+}
+
+int telemetry_sender_open(const char *host, int port) {
+    // IPv4 주소 또는 호스트 이름 (이름은 시작할 때 한 번만 조회)
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    int err = getaddrinfo(host, NULL, &hints, &res);
+    if (err != 0) {
+        fprintf(stderr, "[Telemetry] Cannot resolve destination %s: %s\n", host, gai_strerror(err));
+        return -1;
+    }
+    memcpy(&sender_dest, res->ai_addr, sizeof(sender_dest));
+    freeaddrinfo(res);
+    sender_dest.sin_port = htons(port);
+
+    sender_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sender_fd < 0) {
+        perror("[Error] Telemetry socket failed");
+        return -1;
+    }
+
+    // 멀티캐스트 주소(224.0.0.0/4)이면 로컬 네트워크 안에서만 전달
+    if (IN_MULTICAST(ntohl(sender_dest.sin_addr.s_addr))) {
+        unsigned char ttl = 1;
+        setsockopt(sender_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    }
+
+    char addr[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &sender_dest.sin_addr, addr, sizeof(addr));
+    if (strcmp(addr, host) == 0) printf("[Telemetry] Sending frames to %s:%d\n", host, port);
+    else printf("[Telemetry] Sending frames to %s (%s):%d\n", host, addr, port);
+    return 0;
+}
+
+int telemetry_send(const TelemetryFrame *frame) {
+    if (sender_fd < 0) return -1;
+
+    uint8_t buf[TELEMETRY_FRAME_SIZE];
+    telemetry_encode(frame, buf, sizeof(buf));
+    // 네트워크가 막혀도 제어 루프를 멈추지 않도록 MSG_DONTWAIT 사용
+    if (sendto(sender_fd, buf, sizeof(buf), MSG_DONTWAIT,
+               (struct sockaddr *)&sender_dest, sizeof(sender_dest)) != sizeof(buf)) {
+        return -1;
+    }
+    return 0;
+}
+
+void telemetry_sender_close() {
+    if (sender_fd >= 0) {
+        close(sender_fd);
+        sender_fd = -1;
+    }
+}
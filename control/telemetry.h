@@ -0,0 +1,44 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 여러 제어기의 상태를 한곳에서 보기 위한 UDP 텔레메트리
+// 각 제어기는 고정 크기(64바이트) 바이너리 프레임을 유니캐스트 또는 멀티캐스트로 전송하고,
+// telemetry_aggregator 가 이를 수신하여 노드별 최신 상태와 짧은 이력을 보관한다.
+
+#define TELEMETRY_DEFAULT_GROUP "239.255.42.99" // 기본 멀티캐스트 그룹
+#define TELEMETRY_DEFAULT_PORT  5005
+#define TELEMETRY_FRAME_SIZE    64
+#define TELEMETRY_NAME_LEN      16
+
+// 상태 플래그
+#define TELEMETRY_FLAG_FAN_ON  0x01
+#define TELEMETRY_FLAG_MANUAL  0x02
+#define TELEMETRY_FLAG_ALERT   0x04
+
+typedef struct {
+    char node[TELEMETRY_NAME_LEN]; // 노드 이름 (NUL 종료 보장 안 됨)
+    uint8_t flags;
+    uint32_t seq;                  // 전송 순번 (손실 감지용)
+    uint64_t timestamp_ms;         // 전송 시각 (epoch ms)
+    float temperature;
+    float humidity;
+    uint32_t uptime_s;             // 제어 프로세스 가동 시간
+    uint32_t samples;              // 처리한 센서 샘플 수
+    uint32_t fan_toggles;          // 팬 켜짐/꺼짐 전환 횟수
+    uint32_t remote_commands;      // 수신한 원격 명령 수
+    uint32_t sensor_errors;        // 센서 오류(체크섬/타임아웃) 수
+} TelemetryFrame;
+
+// 프레임 직렬화/역직렬화 (리틀 엔디언)
+size_t telemetry_encode(const TelemetryFrame *frame, uint8_t *buf, size_t size);
+int telemetry_decode(const uint8_t *buf, size_t size, TelemetryFrame *frame);
+
+// 송신기: host는 IPv4 주소 또는 호스트 이름, 멀티캐스트 주소이면 멀티캐스트로 전송
+int telemetry_sender_open(const char *host, int port);
+int telemetry_send(const TelemetryFrame *frame); // 블로킹하지 않음 (실패 시 -1)
+void telemetry_sender_close();
+
+#endif
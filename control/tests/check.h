@@ -0,0 +1,25 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdio.h>
+
+// 단위 검사용 단정 매크로 (make check)
+// 실패해도 나머지 검사를 계속하고, main은 check_result의 반환값으로 종료한다.
+
+static int check_count = 0;
+static int check_failures = 0;
+
+#define CHECK(cond) do { \
+        check_count++; \
+        if (!(cond)) { \
+            check_failures++; \
+            fprintf(stderr, "[Check] %s:%d: FAILED: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while (0)
+
+static inline int check_result(const char *name) {
+    printf("[Check] %-12s %3d checks, %d failed\n", name, check_count, check_failures);
+    return check_failures ? 1 : 0;
+}
+
+#endif
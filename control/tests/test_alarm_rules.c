@@ -0,0 +1,168 @@
+#include "check.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// 경고 규칙 컴파일러: 해석, 비교식 중복 제거, 지속 시간 판정
+// 컴파일 결과(g_prog)를 직접 확인하기 위해 구현 파일을 포함한다.
+#include "../alarm_rules.c"
+
+static char g_rules_path[] = "/tmp/alarm_rules_check_XXXXXX";
+
+static int load_text(const char *text, double now) {
+    FILE *fp = fopen(g_rules_path, "w");
+    if (fp == NULL) return -2;
+    fputs(text, fp);
+    fclose(fp);
+    return alarm_rules_load(g_rules_path, now);
+}
+
+static void feed(double now, float temperature, float humidity) {
+    AlarmSample s = { temperature, humidity, 15.0f, 10.0f, temperature, 0 };
+    alarm_rules_sample(&s, now);
+}
+
+static const AlarmRule *rule_named(const char *name) {
+    for (int r = 0; r < g_prog.rule_count; r++) {
+        if (strcmp(g_prog.rules[r].name, name) == 0) return &g_prog.rules[r];
+    }
+    return NULL;
+}
+
+static void check_parse() {
+    int n = load_text("# comment line\n"
+                      "\n"
+                      "damp: humidity > 75 % for 10m -> notify, lcd \"DAMP # VENTING NOW!!\"  # trailing\n"
+                      "rising: rate(temperature) >= 0.5 -> notify\n"
+                      "long: temperature < 5 for 1.5h -> buzzer\n",
+                      0.0);
+    CHECK(n == 3);
+    const AlarmRule *damp = rule_named("damp");
+    CHECK(damp != NULL && damp->duration == 600.0);
+    CHECK(damp != NULL && strcmp(damp->lcd_text, "DAMP # VENTING N") == 0); // '#'는 따옴표 안이면 문구, 16자로 자름
+    CHECK(damp != NULL && damp->actions == (ACTION_NOTIFY | ACTION_LCD));
+    const AlarmRule *lng = rule_named("long");
+    CHECK(lng != NULL && lng->duration == 5400.0);
+    CHECK(g_prog.rate_mask == (1u << M_TEMPERATURE)); // 참조하는 지표만 변화율 계산
+}
+
+static void check_invalid_keeps_defaults() {
+    static const char *bad[] = {
+        "nocolon temperature > 3 -> buzzer\n",
+        "x: temperature >> 3 -> buzzer\n",
+        "x: pressure > 3 -> buzzer\n",
+        "x: rate(fan) > 0 -> notify\n",
+        "x: temperature > 3 for 5d -> notify\n",
+        "x: temperature > 3 -> siren\n",
+        "x: temperature > 3 ->\n",
+        "this_name_is_longer_than_24: temperature > 3 -> notify\n",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        char text[256];
+        snprintf(text, sizeof(text), "ok: humidity > 90 -> notify\n%s", bad[i]);
+        CHECK(load_text(text, 0.0) == -1);
+        // 일부만 컴파일된 규칙이 아니라 기본 규칙으로 동작
+        CHECK(g_prog.rule_count == 2 && rule_named("hot") && rule_named("humid") && !rule_named("ok"));
+    }
+    CHECK(alarm_rules_load("/nonexistent/alarms.conf", 0.0) == 2);
+}
+
+static void check_dedup() {
+    int n = load_text("a: humidity > 75 -> notify\n"
+                      "b: humidity > 75 and temperature >= 28 -> buzzer\n"
+                      "c: temperature >= 28 -> notify\n"
+                      "d: temperature > 28 -> notify\n",
+                      0.0);
+    CHECK(n == 4);
+    CHECK(g_prog.rule_pred_count == 5);
+    CHECK(g_prog.pred_count == 3); // humidity > 75, temperature >= 28, temperature > 28
+
+    feed(1.0, 28.0f, 80.0f);
+    AlarmOutput out;
+    alarm_rules_evaluate(1.0, &out);
+    CHECK(out.active_count == 3);  // d만 거짓
+    CHECK(!rule_named("d")->active);
+}
+
+static void check_duration() {
+    CHECK(load_text("damp: humidity > 75 for 10m -> buzzer, lcd \"DAMP\"\n", 0.0) == 1);
+    AlarmOutput out;
+
+    feed(0.0, 22.0f, 80.0f);
+    alarm_rules_evaluate(0.0, &out);
+    CHECK(out.active_count == 0 && !out.changed);
+    alarm_rules_evaluate(599.0, &out);
+    CHECK(out.active_count == 0);
+    alarm_rules_evaluate(600.0, &out); // 조건이 참이 된 뒤 정확히 10분
+    CHECK(out.active_count == 1 && out.changed && out.buzzer);
+    CHECK(out.lcd_text != NULL && strcmp(out.lcd_text, "DAMP") == 0);
+    alarm_rules_evaluate(601.0, &out); // 버저는 활성화되는 순간에만
+    CHECK(out.active_count == 1 && !out.changed && !out.buzzer);
+
+    // 한 번이라도 거짓이 되면 바로 해제되고 지속 시간은 처음부터
+    feed(610.0, 22.0f, 70.0f);
+    alarm_rules_evaluate(610.0, &out);
+    CHECK(out.active_count == 0 && out.changed && out.lcd_text == NULL);
+    feed(620.0, 22.0f, 80.0f);
+    alarm_rules_evaluate(620.0, &out);
+    alarm_rules_evaluate(1219.0, &out);
+    CHECK(out.active_count == 0);
+    alarm_rules_evaluate(1220.0, &out);
+    CHECK(out.active_count == 1 && out.buzzer);
+}
+
+static void check_stale() {
+    CHECK(load_text("stale: stale > 30 -> notify\n", 0.0) == 1);
+    AlarmOutput out;
+    feed(100.0, 22.0f, 50.0f);
+    alarm_rules_evaluate(130.0, &out); // 판독 사이에도 평가하면 갱신
+    CHECK(out.active_count == 0);
+    alarm_rules_evaluate(131.0, &out);
+    CHECK(out.active_count == 1);
+    feed(132.0, 22.0f, 50.0f);
+    alarm_rules_evaluate(132.0, &out);
+    CHECK(out.active_count == 0);
+}
+
+static void check_active_names() {
+    CHECK(load_text("hot: temperature >= 28 -> buzzer\n"
+                    "humid: humidity >= 70 -> notify\n"
+                    "cold: temperature < 5 -> notify\n",
+                    0.0) == 3);
+    AlarmOutput out;
+    feed(1.0, 30.0f, 75.0f);
+    alarm_rules_evaluate(1.0, &out);
+
+    char json[ALARM_ACTIVE_JSON_LEN], names[64];
+    CHECK(alarm_rules_format_active(json, sizeof(json)) == 15 && strcmp(json, "[\"hot\",\"humid\"]") == 0);
+    CHECK(alarm_rules_format_active(json, 12) == 7 && strcmp(json, "[\"hot\"]") == 0); // 넘치면 완전한 이름까지만
+    CHECK(alarm_rules_format_active(json, 3) == 2 && strcmp(json, "[]") == 0);
+    CHECK(alarm_rules_save_active(names, sizeof(names)) == 9 && strcmp(names, "hot,humid") == 0);
+    CHECK(alarm_rules_save_active(names, 8) == 3 && strcmp(names, "hot") == 0);
+
+    // 재시작 후 복원: 이미 활성이므로 같은 조건으로 버저가 다시 울리지 않음
+    alarm_rules_load(g_rules_path, 10.0);
+    alarm_rules_restore_active("hot,humid", 10.0);
+    feed(11.0, 30.0f, 75.0f);
+    alarm_rules_evaluate(11.0, &out);
+    CHECK(out.active_count == 2 && !out.changed && !out.buzzer);
+}
+
+int main() {
+    int fd = mkstemp(g_rules_path);
+    if (fd == -1) {
+        perror("[Check] mkstemp failed");
+        return 1;
+    }
+    close(fd);
+
+    check_parse();
+    check_invalid_keeps_defaults();
+    check_dedup();
+    check_duration();
+    check_stale();
+    check_active_names();
+
+    unlink(g_rules_path);
+    return check_result("alarm_rules");
+}
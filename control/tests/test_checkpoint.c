@@ -0,0 +1,145 @@
+#include "check.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// 상태 체크포인트: 두 칸 중 온전한 최신 칸 선택, 기록 도중 중단된 칸 복구, 변경 분류
+// 파일 안의 칸 배치를 알기 위해 구현 파일을 포함한다.
+#include "../checkpoint.c"
+
+static char g_path[] = "/tmp/checkpoint_check_XXXXXX";
+
+static CheckpointState make_state(float temperature, int fan_on) {
+    CheckpointState s;
+    memset(&s, 0, sizeof(s));
+    s.saved_at = 1000.0;
+    s.reading_time = 990.0;
+    s.temperature = temperature;
+    s.humidity = 60.0f;
+    s.fan_duty = fan_on ? 1.0f : 0.0f;
+    s.mode = 0;
+    s.fan_on = (uint8_t)fan_on;
+    strcpy(s.alarms, fan_on ? "hot" : "");
+    return s;
+}
+
+static void reopen() {
+    checkpoint_close();
+    CHECK(checkpoint_open(g_path) == 0);
+}
+
+static float loaded_temperature() {
+    CheckpointState s;
+    if (checkpoint_load(&s) != 0) return -1.0f;
+    return s.temperature;
+}
+
+// 파일의 slot번 칸 안 offset 위치 한 바이트를 뒤집음 (매핑을 닫은 뒤 디스크에서 직접)
+static void flip_byte(int slot, size_t offset) {
+    checkpoint_close();
+    int fd = open(g_path, O_RDWR);
+    off_t pos = (off_t)(slot * sizeof(CheckpointSlot) + offset);
+    uint8_t b = 0;
+    CHECK(pread(fd, &b, 1, pos) == 1);
+    b ^= 0x40;
+    CHECK(pwrite(fd, &b, 1, pos) == 1);
+    close(fd);
+    CHECK(checkpoint_open(g_path) == 0);
+}
+
+static void check_classification() {
+    CheckpointState a = make_state(24.0f, 0);
+    CHECK(checkpoint_load(&a) == -1); // 빈 파일
+    CHECK(checkpoint_save(&a) == CHECKPOINT_CONTROL);
+    CHECK(checkpoint_sync() == 1);
+    CHECK(checkpoint_sync() == 0);
+
+    a.saved_at += 3.0; // 저장 시각만 다르면 기록하지 않음
+    CHECK(checkpoint_save(&a) == CHECKPOINT_UNCHANGED);
+    a.temperature = 24.5f;
+    a.reading_time += 3.0;
+    CHECK(checkpoint_save(&a) == CHECKPOINT_READING);
+    CHECK(checkpoint_sync() == 0); // 판독값만 바뀌면 msync하지 않음
+
+    CheckpointState b = make_state(29.0f, 1);
+    CHECK(checkpoint_save(&b) == CHECKPOINT_CONTROL);
+    CHECK(checkpoint_sync() == 1);
+    CHECK(loaded_temperature() == 29.0f);
+}
+
+static void check_latest_slot() {
+    // 칸 위치가 아니라 순번으로 최신 칸을 고름 (세 번째 저장은 다시 0번 칸)
+    CheckpointState s = make_state(20.0f, 0);
+    reopen();
+    for (int i = 0; i < 3; i++) {
+        s.temperature = 20.0f + i;
+        CHECK(checkpoint_save(&s) != CHECKPOINT_UNCHANGED);
+    }
+    reopen();
+    CHECK(loaded_temperature() == 22.0f);
+    CHECK(g_file->slots[g_latest].seq > g_file->slots[1 - g_latest].seq);
+}
+
+static void check_torn_write() {
+    CheckpointState s = make_state(30.0f, 0);
+    CHECK(checkpoint_save(&s) != CHECKPOINT_UNCHANGED);
+    int newest = g_latest;
+    s.temperature = 31.0f;
+    CHECK(checkpoint_save(&s) != CHECKPOINT_UNCHANGED);
+    CHECK(g_latest != newest);
+    newest = g_latest;
+
+    // 최신 칸의 상태가 깨지면 (CRC 불일치) 이전 칸으로 복원
+    flip_byte(newest, offsetof(CheckpointSlot, state) + offsetof(CheckpointState, temperature));
+    CHECK(loaded_temperature() == 30.0f);
+
+    // 다음 저장은 깨진 칸을 덮어쓰고 순번을 이어감
+    uint64_t good_seq = g_file->slots[1 - newest].seq;
+    s.temperature = 32.0f;
+    CHECK(checkpoint_save(&s) != CHECKPOINT_UNCHANGED);
+    CHECK(g_latest == newest);
+    CHECK(g_file->slots[newest].seq == good_seq + 1);
+    reopen();
+    CHECK(loaded_temperature() == 32.0f);
+
+    // CRC를 쓰기 전에 멈춘 기록: 순번이 더 커도 CRC가 맞지 않으면 무시
+    flip_byte(1 - newest, offsetof(CheckpointSlot, seq) + 7);
+    CHECK(g_latest == newest);
+    CHECK(loaded_temperature() == 32.0f);
+
+    // 형식 버전이 다른 칸도 무시, 두 칸 모두 깨지면 복원하지 않음
+    flip_byte(newest, offsetof(CheckpointSlot, version));
+    CHECK(checkpoint_load(&s) == -1);
+    s.temperature = 33.0f;
+    CHECK(checkpoint_save(&s) == CHECKPOINT_CONTROL); // 비교할 이전 상태 없음
+    reopen();
+    CHECK(loaded_temperature() == 33.0f);
+}
+
+static void check_missing_file() {
+    checkpoint_close();
+    CheckpointState s = make_state(25.0f, 0);
+    CHECK(checkpoint_open("/nonexistent/dir/state.ckpt") == -1);
+    CHECK(checkpoint_save(&s) == CHECKPOINT_UNCHANGED); // 열지 못하면 저장은 무시
+    CHECK(checkpoint_load(&s) == -1);
+    CHECK(checkpoint_sync() == 0);
+}
+
+int main() {
+    int fd = mkstemp(g_path);
+    if (fd == -1) {
+        perror("[Check] mkstemp failed");
+        return 1;
+    }
+    close(fd);
+    CHECK(checkpoint_open(g_path) == 0);
+
+    check_classification();
+    check_latest_slot();
+    check_torn_write();
+    check_missing_file();
+
+    unlink(g_path);
+    return check_result("checkpoint");
+}
@@ -0,0 +1,105 @@
+#include "check.h"
+#include "dht_bits.h"
+
+// 고정 창 분류기(기존 DHTXXD 동작)와 적응형 분류기 비교
+
+#define ZERO_US 78  // 50us LOW + 28us HIGH
+#define ONE_US  120 // 50us LOW + 70us HIGH
+
+// 습도/온도 바이트로 체크섬이 맞는 40비트 코드
+static uint64_t make_code(uint8_t humi, uint8_t temp) {
+    uint64_t code = ((uint64_t)humi << 32) | ((uint64_t)temp << 16);
+    return code | (uint8_t)(humi + temp);
+}
+
+static void make_edges(uint64_t code, uint16_t zero, uint16_t one, uint16_t edges[DHT_FRAME_BITS]) {
+    for (int i = 0; i < DHT_FRAME_BITS; i++) {
+        edges[i] = ((code >> (DHT_FRAME_BITS - 1 - i)) & 1) ? one : zero;
+    }
+}
+
+static void check_nominal() {
+    uint16_t edges[DHT_FRAME_BITS];
+    uint64_t expected = make_code(55, 24), fixed = 0, adaptive = 0;
+    DHTBitCalib cal;
+    dht_bits_calib_init(&cal);
+    make_edges(expected, ZERO_US, ONE_US, edges);
+
+    CHECK(dht_bits_checksum_ok(expected));
+    CHECK(dht_bits_fixed(edges, &fixed) == 0);
+    CHECK(fixed == expected);
+    CHECK(dht_bits_adaptive(edges, &cal, &adaptive) == 0);
+    CHECK(adaptive == fixed);
+    CHECK(cal.by_frame == 1 && cal.by_running == 0 && cal.frames == 1);
+    CHECK(cal.split > ZERO_US && cal.split < ONE_US);
+}
+
+static void check_fixed_window() {
+    uint16_t edges[DHT_FRAME_BITS];
+    uint64_t code;
+    make_edges(0, 60, 60, edges);
+    edges[0] = 100; // 창 경계: 60~100 '0', 101~150 '1'
+    edges[1] = 101;
+    edges[2] = 150;
+    CHECK(dht_bits_fixed(edges, &code) == 0);
+    CHECK(code == ((uint64_t)3 << 37));
+
+    edges[3] = 59;
+    CHECK(dht_bits_fixed(edges, &code) == -1);
+    edges[3] = 151;
+    CHECK(dht_bits_fixed(edges, &code) == -1);
+}
+
+static void check_stretched_pulses() {
+    // 긴 배선으로 HIGH 펄스가 늘어난 경우: 고정 창은 '1'을 놓치고 적응형은 프레임 경계로 복원
+    uint16_t edges[DHT_FRAME_BITS];
+    uint64_t expected = make_code(68, 31), code = 0;
+    DHTBitCalib cal;
+    dht_bits_calib_init(&cal);
+    make_edges(expected, 95, 165, edges);
+
+    CHECK(dht_bits_fixed(edges, &code) == -1);
+    CHECK(dht_bits_adaptive(edges, &cal, &code) == 0);
+    CHECK(code == expected);
+    CHECK(cal.split == 130.0f);
+
+    // 비트가 모두 0인 프레임은 프레임 안에서 경계를 찾을 수 없어 누적 경계로 분류
+    make_edges(0, 105, 105, edges);
+    CHECK(dht_bits_adaptive(edges, &cal, &code) == 0);
+    CHECK(code == 0);
+    CHECK(cal.by_running == 1);
+
+    // 보정 전이면 기본 경계(100us)로 모두 '1'로 읽혀 체크섬 오류
+    DHTBitCalib fresh;
+    dht_bits_calib_init(&fresh);
+    CHECK(dht_bits_adaptive(edges, &fresh, &code) == 0);
+    CHECK(!dht_bits_checksum_ok(code));
+    CHECK(fresh.by_running == 0);
+}
+
+static void check_rejected() {
+    uint16_t edges[DHT_FRAME_BITS];
+    uint64_t expected = make_code(40, 20), code = 0;
+    DHTBitCalib cal;
+    dht_bits_calib_init(&cal);
+
+    // 허용 범위 밖의 에지 (누락된 에지로 두 비트가 합쳐진 경우)
+    make_edges(expected, ZERO_US, ONE_US, edges);
+    edges[10] = 260;
+    CHECK(dht_bits_adaptive(edges, &cal, &code) == -1);
+    CHECK(cal.rejected == 1);
+
+    // 뒤집힌 비트는 코드를 돌려주되 체크섬으로 걸러지고 누적 경계에 반영되지 않음
+    make_edges(expected ^ ((uint64_t)1 << 20), ZERO_US, ONE_US, edges);
+    CHECK(dht_bits_adaptive(edges, &cal, &code) == 0);
+    CHECK(!dht_bits_checksum_ok(code));
+    CHECK(cal.frames == 0);
+}
+
+int main() {
+    check_nominal();
+    check_fixed_window();
+    check_stretched_pulses();
+    check_rejected();
+    return check_result("dht_bits");
+}
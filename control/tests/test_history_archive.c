@@ -0,0 +1,206 @@
+#include "check.h"
+#include "history_archive.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// 이력 아카이브: 기록 도중 잘린 끝 블록 정리, 손상 구간 뒤의 블록 복구
+
+#define BASE_TIME 1700000000
+#define MAX_SAMPLES 2048
+
+static char g_path[] = "/tmp/archive_check_XXXXXX";
+static ArchiveSample g_read[MAX_SAMPLES];
+
+static ArchiveSample sample_at(int i) {
+    ArchiveSample s;
+    memset(&s, 0, sizeof(s));
+    s.timestamp = BASE_TIME + 3 * i;
+    s.temperature = 20.0f + (i % 50) * 0.1f;
+    s.humidity = 50.0f + (i % 7);
+    s.fan_on = (i / 100) % 2;
+    return s;
+}
+
+static int same_sample(const ArchiveSample *s) {
+    int i = (int)((s->timestamp - BASE_TIME) / 3);
+    ArchiveSample want = sample_at(i);
+    return s->timestamp == want.timestamp && s->temperature == want.temperature &&
+           s->humidity == want.humidity && s->fan_on == want.fan_on;
+}
+
+static void write_samples(int first, int count) {
+    ArchiveWriter *writer = archive_writer_open(g_path);
+    CHECK(writer != NULL);
+    if (writer == NULL) return;
+    for (int i = first; i < first + count; i++) {
+        ArchiveSample s = sample_at(i);
+        archive_writer_append(writer, &s);
+    }
+    archive_writer_close(writer);
+}
+
+// 블록 하나를 인코딩해 파일 끝에 붙임 (keep < 블록 크기면 앞부분만, 기록 도중 중단 흉내)
+static size_t append_block(int first, int count, size_t keep) {
+    static ArchiveSample samples[ARCHIVE_BLOCK_SAMPLES];
+    static uint8_t block[ARCHIVE_BLOCK_MAX_BYTES];
+    for (int i = 0; i < count; i++) samples[i] = sample_at(first + i);
+    size_t len = archive_encode_block(samples, count, block, sizeof(block));
+    CHECK(len > 0);
+    if (keep > len) keep = len;
+    int fd = open(g_path, O_WRONLY | O_APPEND);
+    CHECK(write(fd, block, keep) == (ssize_t)keep);
+    close(fd);
+    return len;
+}
+
+static off_t file_size() {
+    struct stat st;
+    return stat(g_path, &st) == 0 ? st.st_size : -1;
+}
+
+static void reset_file() {
+    CHECK(truncate(g_path, 0) == 0);
+}
+
+// 스트리밍으로 모두 읽어 g_read에 담음 (읽기 오류면 -1)
+static int read_all() {
+    ArchiveReader *reader = archive_reader_open(g_path);
+    if (reader == NULL) return -1;
+    int n = 0, ret;
+    while (n < MAX_SAMPLES && (ret = archive_reader_next(reader, &g_read[n])) == 1) n++;
+    archive_reader_close(reader);
+    return ret < 0 ? -1 : n;
+}
+
+// 메모리 매핑으로 [from, to] 구간과 겹치는 블록의 샘플을 모두 읽음
+static int map_all(int64_t from, int64_t to) {
+    static ArchiveSample block[ARCHIVE_BLOCK_SAMPLES];
+    ArchiveMap *map = archive_map_open(g_path);
+    if (map == NULL) return -1;
+    int n = 0, count;
+    while ((count = archive_map_next_block(map, from, to, block)) > 0) {
+        for (int i = 0; i < count && n < MAX_SAMPLES; i++) g_read[n++] = block[i];
+    }
+    archive_map_close(map);
+    return count < 0 ? -1 : n;
+}
+
+// 읽은 샘플이 모두 원래 값이고 시간순인지
+static int read_intact(int n) {
+    for (int i = 0; i < n; i++) {
+        if (!same_sample(&g_read[i])) return 0;
+        if (i > 0 && g_read[i].timestamp <= g_read[i - 1].timestamp) return 0;
+    }
+    return 1;
+}
+
+static void check_round_trip() {
+    reset_file();
+    write_samples(0, 1000);
+    CHECK(read_all() == 1000);
+    CHECK(read_intact(1000));
+    CHECK(map_all(INT64_MIN, INT64_MAX) == 1000);
+    CHECK(read_intact(1000));
+}
+
+static void check_torn_tail() {
+    // 마지막 블록 기록 중 전원 차단: 앞 블록들만 읽히고 오류는 아님
+    reset_file();
+    write_samples(0, 1000);
+    off_t intact = file_size();
+    CHECK(truncate(g_path, intact - 100) == 0);
+    int kept = read_all();
+    CHECK(kept > 0 && kept < 1000);
+    CHECK(read_intact(kept));
+    CHECK(map_all(INT64_MIN, INT64_MAX) == kept);
+
+    // 다시 열면 잘린 블록을 지우고 그 뒤에 이어서 기록
+    write_samples(1000, 60);
+    CHECK(read_all() == kept + 60);
+    CHECK(read_intact(kept + 60));
+    CHECK(g_read[kept + 59].timestamp == sample_at(1059).timestamp);
+    CHECK(map_all(INT64_MIN, INT64_MAX) == kept + 60);
+
+    // 첫 블록부터 잘렸으면 빈 파일로
+    reset_file();
+    append_block(0, 100, 50);
+    write_samples(100, 10);
+    CHECK(read_all() == 10);
+    CHECK(read_intact(10));
+}
+
+static void check_damage_in_middle() {
+    // 이전 버전처럼 잘린 블록 뒤에 새 블록이 붙은 파일: 손상 구간만 건너뜀
+    reset_file();
+    append_block(0, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    size_t torn = append_block(100, 100, 0);
+    append_block(100, 100, torn / 2);
+    append_block(200, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    off_t size = file_size();
+    CHECK(read_all() == 200);
+    CHECK(read_intact(200));
+    CHECK(g_read[100].timestamp == sample_at(200).timestamp);
+    CHECK(map_all(INT64_MIN, INT64_MAX) == 200);
+
+    // 헤더만 보고 건너뛴 잘린 블록의 크기가 틀려도 그 뒤 블록을 찾음
+    CHECK(map_all(sample_at(200).timestamp, sample_at(299).timestamp) == 100);
+    CHECK(g_read[0].timestamp == sample_at(200).timestamp);
+    CHECK(map_all(sample_at(120).timestamp, sample_at(150).timestamp) == 0);
+
+    // 끝이 온전하면 기록기를 열어도 아무것도 지우지 않음
+    write_samples(300, 10);
+    CHECK(file_size() > size);
+    CHECK(read_all() == 210);
+
+    // 내용이 깨진 블록(CRC 불일치)은 그 블록만 건너뜀
+    reset_file();
+    size_t first = append_block(0, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    append_block(100, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    append_block(200, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    int fd = open(g_path, O_RDWR);
+    uint8_t b = 0;
+    CHECK(pread(fd, &b, 1, (off_t)first + ARCHIVE_HEADER_SIZE + 5) == 1);
+    b ^= 0x10;
+    CHECK(pwrite(fd, &b, 1, (off_t)first + ARCHIVE_HEADER_SIZE + 5) == 1);
+    close(fd);
+    CHECK(read_all() == 200);
+    CHECK(read_intact(200));
+    CHECK(g_read[100].timestamp == sample_at(200).timestamp);
+    CHECK(map_all(INT64_MIN, INT64_MAX) == 200);
+}
+
+static void check_foreign_tail() {
+    // 중단된 기록 하나보다 큰 알 수 없는 꼬리는 지우지 않음
+    reset_file();
+    append_block(0, 100, ARCHIVE_BLOCK_MAX_BYTES);
+    static uint8_t junk[ARCHIVE_BLOCK_MAX_BYTES + 10];
+    memset(junk, 0xAA, sizeof(junk));
+    int fd = open(g_path, O_WRONLY | O_APPEND);
+    CHECK(write(fd, junk, sizeof(junk)) == (ssize_t)sizeof(junk));
+    close(fd);
+    off_t size = file_size();
+    ArchiveWriter *writer = archive_writer_open(g_path);
+    archive_writer_close(writer);
+    CHECK(file_size() == size);
+    CHECK(read_all() == 100);
+}
+
+int main() {
+    int fd = mkstemp(g_path);
+    if (fd == -1) {
+        perror("[Check] mkstemp failed");
+        return 1;
+    }
+    close(fd);
+
+    check_round_trip();
+    check_torn_tail();
+    check_damage_in_middle();
+    check_foreign_tail();
+
+    unlink(g_path);
+    return check_result("archive");
+}
@@ -0,0 +1,164 @@
+#include "check.h"
+#include "pipeline.h"
+#include <string.h>
+
+// 샘플 처리 파이프라인: 단계 실행 규칙, 단독 실행 벤치마크, 게시 링의 버림/대기 집계
+
+typedef struct {
+    int seq;
+    int value;
+} Record;
+
+/* --- 단계 실행 --- */
+
+static int g_calls[3];
+
+static int stage_next(void *record) {
+    g_calls[0]++;
+    ((Record *)record)->value += 1;
+    return PIPELINE_NEXT;
+}
+
+static int stage_skip(void *record) {
+    (void)record;
+    g_calls[1]++;
+    return PIPELINE_SKIP;
+}
+
+static int stage_stop(void *record) {
+    g_calls[2]++;
+    return ((Record *)record)->value > 1 ? PIPELINE_STOP : PIPELINE_NEXT;
+}
+
+static void check_run() {
+    Pipeline p;
+    pipeline_init(&p, "check");
+    CHECK(pipeline_add_stage(&p, "next", stage_next, 1) == 0);
+    CHECK(pipeline_add_stage(&p, "skip", stage_skip, 1) == 0);
+    CHECK(pipeline_add_stage(&p, "stop", stage_stop, 1) == 0);
+    CHECK(pipeline_add_stage(&p, "next2", stage_next, 1) == 0);
+
+    Record rec = { 0, 0 };
+    CHECK(pipeline_run(&p, &rec) == PIPELINE_NEXT);
+    CHECK(rec.value == 2);
+    CHECK(pipeline_run(&p, &rec) == PIPELINE_STOP); // 세 번째 단계에서 멈춤
+    CHECK(rec.value == 3);
+    CHECK(p.stages[0].runs == 2 && p.stages[3].runs == 1);
+    CHECK(g_calls[1] == 2 && p.stages[1].runs == 0); // SKIP은 시간 집계에서 제외
+
+    for (int i = p.count; i < PIPELINE_MAX_STAGES; i++) pipeline_add_stage(&p, "fill", stage_next, 0);
+    CHECK(pipeline_add_stage(&p, "overflow", stage_next, 0) == -1);
+}
+
+/* --- 벤치마크 --- */
+
+typedef struct {
+    int counter;
+    float last;
+} BenchState;
+
+static BenchState g_bench_state;
+
+static int stage_stateful(void *record) {
+    Record *rec = (Record *)record;
+    g_bench_state.counter++;
+    g_bench_state.last = (float)rec->value;
+    rec->value = g_bench_state.counter; // 매 반복 같은 상태에서 시작하면 항상 1
+    return PIPELINE_NEXT;
+}
+
+static void check_bench() {
+    Pipeline p;
+    pipeline_init(&p, "bench");
+    pipeline_add_stage(&p, "hardware", stage_next, 0);
+    pipeline_add_stateful_stage(&p, "stateful", stage_stateful, &g_bench_state, sizeof(g_bench_state));
+
+    Record tmpl = { 0, 7 };
+    g_bench_state.counter = 41;
+    g_bench_state.last = -1.0f;
+    CHECK(pipeline_bench_stage(&p, 0, &tmpl, sizeof(tmpl), 10) < 0.0); // 단독 실행 불가
+    CHECK(pipeline_bench_stage(&p, 1, &tmpl, sizeof(tmpl), 1000) >= 0.0);
+    CHECK(g_bench_state.counter == 41 && g_bench_state.last == -1.0f); // 상태는 원래대로
+    CHECK(tmpl.value == 7);                                            // 템플릿도 그대로
+    CHECK(p.stages[1].runs == 0);                                      // 집계에 반영하지 않음
+}
+
+/* --- 게시 링 --- */
+
+static pthread_mutex_t g_gate_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_gate_cond = PTHREAD_COND_INITIALIZER;
+static int g_gate_open = 1;
+static int g_sink_entered = 0;
+static int g_sunk[PIPELINE_RING_SIZE * 2];
+static int g_sunk_count = 0;
+
+// 문이 열릴 때까지 막히는 게시 단계 (느린 출력 대역)
+static int sink_gated(void *record) {
+    pthread_mutex_lock(&g_gate_mutex);
+    g_sink_entered = 1;
+    pthread_cond_broadcast(&g_gate_cond);
+    while (!g_gate_open) pthread_cond_wait(&g_gate_cond, &g_gate_mutex);
+    if (g_sunk_count < (int)(sizeof(g_sunk) / sizeof(g_sunk[0]))) g_sunk[g_sunk_count++] = ((Record *)record)->seq;
+    pthread_mutex_unlock(&g_gate_mutex);
+    return PIPELINE_NEXT;
+}
+
+static void check_ring() {
+    static Record slots[PIPELINE_RING_SIZE];
+    Pipeline sinks;
+    PipelineRing ring;
+    pipeline_init(&sinks, "sinks");
+    pipeline_add_stage(&sinks, "gated", sink_gated, 0);
+    pipeline_ring_init(&ring, &sinks, slots, sizeof(Record));
+
+    // 게시 스레드가 없으면 호출 스레드에서 바로 처리
+    Record rec = { 100, 0 };
+    CHECK(pipeline_ring_push(&ring, &rec) == 0);
+    CHECK(g_sunk_count == 1 && g_sunk[0] == 100);
+    CHECK(ring.pushed == 1 && ring.max_depth == 0);
+
+    // 첫 레코드가 게시 단계에 막혀 있는 동안 링을 채움 (처리 중인 칸도 비워지지 않음)
+    g_sunk_count = 0;
+    g_gate_open = 0;
+    g_sink_entered = 0;
+    CHECK(pipeline_ring_start(&ring) == 0);
+    rec.seq = 0;
+    CHECK(pipeline_ring_push(&ring, &rec) == 0);
+    pthread_mutex_lock(&g_gate_mutex);
+    while (!g_sink_entered) pthread_cond_wait(&g_gate_cond, &g_gate_mutex);
+    pthread_mutex_unlock(&g_gate_mutex);
+
+    int accepted = 1, dropped = 0;
+    for (int i = 1; i < PIPELINE_RING_SIZE + 5; i++) {
+        rec.seq = i;
+        if (pipeline_ring_push(&ring, &rec) == 0) accepted++;
+        else dropped++;
+    }
+    CHECK(accepted == PIPELINE_RING_SIZE);
+    CHECK(dropped == 5 && ring.dropped == 5);
+    CHECK(ring.max_depth == PIPELINE_RING_SIZE);
+
+    // 문을 열고 멈추면 받아 둔 레코드를 순서대로 모두 처리
+    pthread_mutex_lock(&g_gate_mutex);
+    g_gate_open = 1;
+    pthread_cond_broadcast(&g_gate_cond);
+    pthread_mutex_unlock(&g_gate_mutex);
+    pipeline_ring_stop(&ring);
+    CHECK(g_sunk_count == PIPELINE_RING_SIZE);
+    int in_order = 1;
+    for (int i = 0; i < g_sunk_count; i++) in_order &= g_sunk[i] == i;
+    CHECK(in_order);
+    CHECK(ring.head == ring.tail);
+
+    // 멈춘 뒤에는 다시 호출 스레드에서 처리
+    rec.seq = 200;
+    CHECK(pipeline_ring_push(&ring, &rec) == 0);
+    CHECK(g_sunk_count == PIPELINE_RING_SIZE + 1 && g_sunk[PIPELINE_RING_SIZE] == 200);
+}
+
+int main() {
+    check_run();
+    check_bench();
+    check_ring();
+    return check_result("pipeline");
+}
@@ -0,0 +1,163 @@
+#include "check.h"
+#include "timer_wheel.h"
+
+// 계층형 타이머 휠: 단/칸 배치, 윗단 칸 내림(cascade), 전체 재배치
+
+#define START 1000003 // 칸 경계에 맞지 않는 시작 시각
+
+typedef struct {
+    int64_t fired_at; // 콜백이 불린 틱 (-1: 아직)
+    int fires;
+    int64_t period;   // 0보다 크면 콜백에서 다시 등록
+    TimerWheel *tw;
+} Probe;
+
+static void on_timer(TimerNode *node, int64_t now, void *arg) {
+    Probe *p = (Probe *)arg;
+    p->fired_at = now;
+    p->fires++;
+    if (p->period > 0) timer_wheel_add(p->tw, node, now + p->period);
+}
+
+static void probe_init(Probe *p, TimerNode *node, TimerWheel *tw) {
+    p->fired_at = -1;
+    p->fires = 0;
+    p->period = 0;
+    p->tw = tw;
+    timer_node_init(node, on_timer, p);
+}
+
+// 한 틱씩 진행 (step 경로)
+static void advance_by_ticks(TimerWheel *tw, int64_t until) {
+    while (tw->now < until) timer_wheel_advance(tw, tw->now + 1);
+}
+
+// 만료 시각 바로 전까지는 불리지 않고 정확히 그 틱에 한 번 불리는지
+static void check_exact(int64_t delay) {
+    TimerWheel tw;
+    TimerNode node;
+    Probe p;
+    timer_wheel_init(&tw, START);
+    probe_init(&p, &node, &tw);
+    timer_wheel_add(&tw, &node, START + delay);
+
+    advance_by_ticks(&tw, START + delay - 1);
+    CHECK(p.fires == 0);
+    CHECK(tw.pending == 1);
+    advance_by_ticks(&tw, START + delay);
+    CHECK(p.fires == 1);
+    CHECK(p.fired_at == START + delay);
+    CHECK(tw.pending == 0);
+}
+
+static void check_levels() {
+    check_exact(1);
+    check_exact(63);                        // 0단 끝
+    check_exact(64);                        // 1단 시작
+    check_exact(64 * 3 + 7);
+    check_exact(4095);                      // 1단 끝
+    check_exact(4096);                      // 2단 시작
+    check_exact(5000);
+    check_exact(64 * 64 * 64 + 1);          // 3단
+}
+
+static void check_next_wakeup() {
+    TimerWheel tw;
+    TimerNode a, b;
+    Probe pa, pb;
+    timer_wheel_init(&tw, START);
+    CHECK(timer_wheel_next_wakeup(&tw) == -1);
+
+    probe_init(&pa, &a, &tw);
+    timer_wheel_add(&tw, &a, START + 10);
+    CHECK(timer_wheel_next_wakeup(&tw) == START + 10);
+
+    // 윗단에만 있으면 다음 칸 내림 시각에 깨어나 다시 확인
+    timer_wheel_remove(&tw, &a);
+    probe_init(&pb, &b, &tw);
+    timer_wheel_add(&tw, &b, START + 1000);
+    int64_t boundary = ((START >> TIMER_WHEEL_BITS) + 1) << TIMER_WHEEL_BITS;
+    CHECK(timer_wheel_next_wakeup(&tw) == boundary);
+
+    // 깨어날 때마다 그 시각까지만 진행해도 정확한 틱에 만료
+    while (pb.fires == 0 && tw.now < START + 2000) timer_wheel_advance(&tw, timer_wheel_next_wakeup(&tw));
+    CHECK(pb.fired_at == START + 1000);
+    CHECK(pa.fires == 0);
+}
+
+static void check_past_and_remove() {
+    TimerWheel tw;
+    TimerNode late, removed;
+    Probe pl, pr;
+    timer_wheel_init(&tw, START);
+    probe_init(&pl, &late, &tw);
+    probe_init(&pr, &removed, &tw);
+
+    timer_wheel_add(&tw, &late, START - 30); // 이미 지난 시각은 다음 틱에 만료
+    timer_wheel_add(&tw, &removed, START + 2);
+    timer_wheel_remove(&tw, &removed);
+    timer_wheel_remove(&tw, &removed);       // 두 번 해제해도 안전
+    CHECK(tw.pending == 1);
+
+    advance_by_ticks(&tw, START + 10);
+    CHECK(pl.fired_at == START + 1);
+    CHECK(pr.fires == 0);
+    CHECK(tw.pending == 0);
+}
+
+static void check_periodic() {
+    TimerWheel tw;
+    TimerNode node;
+    Probe p;
+    timer_wheel_init(&tw, START);
+    probe_init(&p, &node, &tw);
+    p.period = 100;
+    timer_wheel_add(&tw, &node, START + 100);
+
+    advance_by_ticks(&tw, START + 1000);
+    CHECK(p.fires == 10);
+    CHECK(p.fired_at == START + 1000);
+    CHECK(tw.pending == 1);
+}
+
+static void check_rebuild() {
+    // 큰 시간 차(절전 복귀 등)는 전체 재배치: 지난 타이머는 바로, 남은 타이머는 제 시각에
+    TimerWheel tw;
+    TimerNode soon, later, far;
+    Probe ps, pl, pf;
+    int64_t range = (int64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+    timer_wheel_init(&tw, START);
+    probe_init(&ps, &soon, &tw);
+    probe_init(&pl, &later, &tw);
+    probe_init(&pf, &far, &tw);
+    timer_wheel_add(&tw, &soon, START + 500);
+    timer_wheel_add(&tw, &later, START + 100000);
+    timer_wheel_add(&tw, &far, START + range + 10); // 휠 범위를 넘는 타이머
+
+    timer_wheel_advance(&tw, START + 50000);
+    CHECK(ps.fired_at == START + 50000);
+    CHECK(pl.fires == 0);
+
+    timer_wheel_advance(&tw, START + 99999);
+    CHECK(pl.fires == 0);
+    timer_wheel_advance(&tw, START + 100000);
+    CHECK(pl.fired_at == START + 100000);
+
+    // 시계가 뒤로 가도 재배치 후 남은 타이머 유지
+    timer_wheel_advance(&tw, START + 90000);
+    CHECK(tw.pending == 1);
+    timer_wheel_advance(&tw, START + range + 9);
+    CHECK(pf.fires == 0);
+    timer_wheel_advance(&tw, START + range + 10);
+    CHECK(pf.fired_at == START + range + 10);
+    CHECK(tw.pending == 0);
+}
+
+int main() {
+    check_levels();
+    check_next_wakeup();
+    check_past_and_remove();
+    check_periodic();
+    check_rebuild();
+    return check_result("timer_wheel");
+}
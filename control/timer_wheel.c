@@ -0,0 +1,161 @@
+#include "timer_wheel.h"
+#include <stddef.h>
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+// 단계적 진행 대신 전체 재배치를 하는 시간 차 (시스템 절전 복귀, 시계 변경 등)
+#define REBUILD_THRESHOLD ((int64_t)TIMER_WHEEL_SLOTS * TIMER_WHEEL_SLOTS)
+
+static void list_init(TimerNode *head) {
+    head->next = head->prev = head;
+}
+
+static void list_append(TimerNode *head, TimerNode *node) {
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+static void list_unlink(TimerNode *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = node->prev = NULL;
+}
+
+// tw->now 기준으로 만료 시각에 맞는 단/칸에 배치
+static void place(TimerWheel *tw, TimerNode *node) {
+    int64_t expires = node->expires;
+    int64_t delta = expires - tw->now;
+    if (delta < 0) {
+        delta = 0;
+        expires = tw->now;
+    }
+
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= ((int64_t)1 << (TIMER_WHEEL_BITS * (level + 1)))) level++;
+
+    // 최상단 범위를 넘는 타이머는 끝 칸에 두었다가 내려올 때 다시 배치
+    int64_t max_delta = ((int64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    if (delta > max_delta) expires = tw->now + max_delta;
+
+    int idx = (int)((expires >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+    list_append(&tw->slots[level][idx], node);
+}
+
+void timer_wheel_init(TimerWheel *tw, int64_t now) {
+    tw->now = now;
+    tw->pending = 0;
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++)
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++) list_init(&tw->slots[l][s]);
+}
+
+void timer_node_init(TimerNode *node, TimerCallback callback, void *arg) {
+    node->next = node->prev = NULL;
+    node->expires = 0;
+    node->callback = callback;
+    node->arg = arg;
+}
+
+void timer_wheel_add(TimerWheel *tw, TimerNode *node, int64_t expires) {
+    if (node->next) timer_wheel_remove(tw, node);
+    node->expires = expires;
+    if (expires <= tw->now) {
+        // 현재 틱은 이미 처리했으므로 다음 틱에 만료
+        list_append(&tw->slots[0][(tw->now + 1) & SLOT_MASK], node);
+    } else {
+        place(tw, node);
+    }
+    tw->pending++;
+}
+
+void timer_wheel_remove(TimerWheel *tw, TimerNode *node) {
+    if (node->next == NULL) return;
+    list_unlink(node);
+    tw->pending--;
+}
+
+static void fire(TimerWheel *tw, TimerNode *head) {
+    // 콜백이 다른 타이머를 해제할 수 있으므로 매번 리스트 머리에서 꺼냄
+    while (head->next != head) {
+        TimerNode *node = head->next;
+        list_unlink(node);
+        tw->pending--;
+        node->callback(node, tw->now, node->arg);
+    }
+}
+
+static void cascade(TimerWheel *tw, int level, int idx) {
+    TimerNode moving;
+    TimerNode *head = &tw->slots[level][idx];
+    if (head->next == head) return;
+
+    // 칸 전체를 떼어 낸 뒤 하나씩 재배치
+    moving.next = head->next;
+    moving.prev = head->prev;
+    moving.next->prev = &moving;
+    moving.prev->next = &moving;
+    list_init(head);
+
+    while (moving.next != &moving) {
+        TimerNode *node = moving.next;
+        list_unlink(node);
+        place(tw, node);
+    }
+}
+
+static void step(TimerWheel *tw) {
+    int64_t t = ++tw->now;
+
+    // 아랫단이 한 바퀴 돌 때마다 윗단 한 칸을 내림 (같은 틱에 만료될 노드는 0단 현재 칸으로 옴)
+    for (int level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        if (t & (((int64_t)1 << (TIMER_WHEEL_BITS * level)) - 1)) break;
+        cascade(tw, level, (int)((t >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK));
+    }
+    fire(tw, &tw->slots[0][t & SLOT_MASK]);
+}
+
+// 모든 노드를 새 기준 시각으로 다시 배치하고 만료된 노드는 콜백 호출
+static void rebuild(TimerWheel *tw, int64_t now) {
+    TimerNode all, expired;
+    list_init(&all);
+    list_init(&expired);
+
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++) {
+        for (int s = 0; s < TIMER_WHEEL_SLOTS; s++) {
+            TimerNode *head = &tw->slots[l][s];
+            while (head->next != head) {
+                TimerNode *node = head->next;
+                list_unlink(node);
+                list_append(&all, node);
+            }
+        }
+    }
+
+    tw->now = now;
+    while (all.next != &all) {
+        TimerNode *node = all.next;
+        list_unlink(node);
+        if (node->expires <= now) list_append(&expired, node);
+        else place(tw, node);
+    }
+    fire(tw, &expired);
+}
+
+void timer_wheel_advance(TimerWheel *tw, int64_t now) {
+    if (now < tw->now || now - tw->now > REBUILD_THRESHOLD) {
+        rebuild(tw, now);
+        return;
+    }
+    while (tw->now < now) step(tw);
+}
+
+int64_t timer_wheel_next_wakeup(const TimerWheel *tw) {
+    if (tw->pending == 0) return -1;
+
+    for (int k = 1; k < TIMER_WHEEL_SLOTS; k++) {
+        const TimerNode *head = &tw->slots[0][(tw->now + k) & SLOT_MASK];
+        if (head->next != head) return tw->now + k;
+    }
+    // 0단이 비어 있으면 다음 칸 내림 시각에 다시 확인
+    return ((tw->now >> TIMER_WHEEL_BITS) + 1) << TIMER_WHEEL_BITS;
+}
@@ -0,0 +1,46 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+
+// 계층형 타이머 휠 (1초 해상도)
+//
+// 64칸짜리 휠 4단으로 64^4초(약 194일)까지 표현한다. 타이머 등록/해제는 O(1)이고,
+// 한 틱 진행은 현재 칸의 타이머만 처리하며 64틱마다 윗단 한 칸을 아랫단으로 내린다.
+// 따라서 규칙 수와 관계없이 틱당 비용이 일정하다. 노드는 호출자 구조체에 내장(intrusive)
+// 되므로 별도 할당이 없다. 스레드 안전하지 않으므로 호출자가 직렬화해야 한다.
+
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS   6
+#define TIMER_WHEEL_SLOTS  (1 << TIMER_WHEEL_BITS)
+
+typedef struct TimerNode TimerNode;
+typedef void (*TimerCallback)(TimerNode *node, int64_t now, void *arg);
+
+struct TimerNode {
+    TimerNode *next, *prev; // 연결되지 않았으면 NULL
+    int64_t expires;        // 만료 시각(초)
+    TimerCallback callback;
+    void *arg;
+};
+
+typedef struct {
+    int64_t now; // 마지막으로 처리한 틱
+    TimerNode slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; // 각 칸의 원형 리스트 머리
+    int pending;
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel *tw, int64_t now);
+void timer_node_init(TimerNode *node, TimerCallback callback, void *arg);
+
+// expires가 이미 지났으면 다음 진행 때 바로 만료된다
+void timer_wheel_add(TimerWheel *tw, TimerNode *node, int64_t expires);
+void timer_wheel_remove(TimerWheel *tw, TimerNode *node);
+
+// now까지 진행하며 만료된 타이머의 콜백 호출 (콜백 안에서 다시 등록 가능)
+void timer_wheel_advance(TimerWheel *tw, int64_t now);
+
+// 다음에 깨어나야 할 시각 (가장 이른 만료 또는 윗단 칸 내림 시각). 타이머가 없으면 -1
+int64_t timer_wheel_next_wakeup(const TimerWheel *tw);
+
+#endif
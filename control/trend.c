@@ -0,0 +1,73 @@
+#include "trend.h"
+
+// 기준 시각과의 차이가 이보다 커지면 기준을 옮김 (Σt² 상쇄 오차 방지)
+#define TREND_REBASE_SECONDS 86400.0
+
+void trend_init(TrendEstimator *tr) {
+    tr->origin = 0.0;
+    trend_reset(tr);
+}
+
+void trend_reset(TrendEstimator *tr) {
+    tr->head = 0;
+    tr->count = 0;
+    tr->sum_t = tr->sum_y = tr->sum_ty = tr->sum_tt = 0.0;
+}
+
+// 가장 오래된 샘플 시각을 새 기준으로 삼고 합계를 다시 계산 (하루에 한 번 정도, O(N))
+static void rebase(TrendEstimator *tr, double new_origin) {
+    double shift = new_origin - tr->origin;
+    tr->origin = new_origin;
+    tr->sum_t = tr->sum_ty = tr->sum_tt = 0.0;
+    for (int k = 0; k < tr->count; k++) {
+        int i = (tr->head - tr->count + k + TREND_WINDOW) % TREND_WINDOW;
+        tr->t[i] -= shift;
+        tr->sum_t += tr->t[i];
+        tr->sum_ty += tr->t[i] * tr->y[i];
+        tr->sum_tt += tr->t[i] * tr->t[i];
+    }
+}
+
+void trend_add(TrendEstimator *tr, double t, float y) {
+    if (tr->count == 0) tr->origin = t;
+    else if (t - tr->origin > TREND_REBASE_SECONDS) {
+        int oldest = (tr->head - tr->count + TREND_WINDOW) % TREND_WINDOW;
+        rebase(tr, tr->origin + tr->t[oldest]);
+    }
+
+    double x = t - tr->origin;
+
+    // 윈도우가 차 있으면 가장 오래된 샘플 제거
+    if (tr->count == TREND_WINDOW) {
+        double ox = tr->t[tr->head];
+        double oy = tr->y[tr->head];
+        tr->sum_t -= ox;
+        tr->sum_y -= oy;
+        tr->sum_ty -= ox * oy;
+        tr->sum_tt -= ox * ox;
+    } else {
+        tr->count++;
+    }
+
+    tr->t[tr->head] = x;
+    tr->y[tr->head] = y;
+    tr->head = (tr->head + 1) % TREND_WINDOW;
+    tr->sum_t += x;
+    tr->sum_y += y;
+    tr->sum_ty += x * y;
+    tr->sum_tt += x * x;
+}
+
+int trend_fit(const TrendEstimator *tr, double t, double *slope, double *value) {
+    if (tr->count < TREND_MIN_SAMPLES) return -1;
+
+    double n = tr->count;
+    double denom = n * tr->sum_tt - tr->sum_t * tr->sum_t;
+    if (denom <= 1e-9) return -1;
+
+    double b = (n * tr->sum_ty - tr->sum_t * tr->sum_y) / denom;
+    double a = (tr->sum_y - b * tr->sum_t) / n;
+    if (slope) *slope = b;
+    if (value) *value = a + b * (t - tr->origin);
+    return 0;
+}
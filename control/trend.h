@@ -0,0 +1,29 @@
+#ifndef TREND_H
+#define TREND_H
+
+// 슬라이딩 윈도우 최소제곱 추세 추정기
+//
+// 최근 TREND_WINDOW개 샘플에 직선 y = a + b·t를 맞춘다. 합계(Σt, Σy, Σty, Σt²)를
+// 샘플 추가/제거 시 증분 갱신하므로 샘플당 O(1)이다. 시각은 기준 시각(origin)에 대한
+// 상대값으로 저장하며, 오래 실행되어 값이 커지면 기준을 옮겨 정밀도를 유지한다.
+
+#define TREND_WINDOW      40 // 3초 주기 기준 약 2분
+#define TREND_MIN_SAMPLES 10 // 예측에 필요한 최소 샘플 수
+
+typedef struct {
+    double t[TREND_WINDOW]; // origin 기준 시각(초)
+    float y[TREND_WINDOW];
+    int head;               // 다음에 쓸 위치
+    int count;
+    double origin;
+    double sum_t, sum_y, sum_ty, sum_tt;
+} TrendEstimator;
+
+void trend_init(TrendEstimator *tr);
+void trend_reset(TrendEstimator *tr);
+void trend_add(TrendEstimator *tr, double t, float y);
+
+// 기울기(단위/초)와 시각 t에서의 적합값. 샘플 부족 또는 시각이 모두 같으면 -1
+int trend_fit(const TrendEstimator *tr, double t, double *slope, double *value);
+
+#endif
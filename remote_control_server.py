@@ -1,10 +1,21 @@
 import os
+import re
 import json
+import select
+import hashlib
+import threading
+import subprocess
 import traceback
-from flask import Flask, render_template_string, jsonify
+import ctypes
+import ctypes.util
+from flask import Flask, render_template_string, jsonify, request, Response
 
 FIFO_PATH = "/tmp/smart_vent_fifo"
 STATUS_FILE_PATH = "/tmp/smart_vent_status.json"
+PIPELINE_STATS_PATH = "/tmp/smart_vent_pipeline.json"
+SCHEDULE_FILE_PATH = "/var/lib/smart_vent/schedule.conf"
+HISTORY_ARCHIVE_PATH = "/var/lib/smart_vent/history.sva"
+ARCHIVE_TOOL_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "archive_tool")
 
 app = Flask(__name__)
 
@@ -25,6 +36,7 @@ HTML_TEMPLATE = """
         .status-box h2 { font-size: 1em; margin: 0 0 5px 0; color: #555; text-transform: uppercase; }
         .status-box p { font-size: 1.5em; margin: 0; color: #007bff; font-weight: bold; }
         .status-box p#fan_status.off { color: #dc3545; }
+        .energy { color: #555; margin: 0 0 20px 0; }
         .btn-grid { display: grid; grid-template-columns: 1fr 1fr; gap: 15px; }
         .btn { padding: 15px; font-size: 1.1em; color: white; border: none; border-radius: 8px; cursor: pointer; transition: background-color 0.2s; }
         .btn-on { background-color: #28a745; }
@@ -53,6 +65,7 @@ HTML_TEMPLATE = """
                 <p id="fan_status">--</p>
             </div>
         </div>
+        <p id="energy_today" class="energy">Fan today: --</p>
         <div class="btn-grid">
             <button class="btn btn-on" onclick="sendCommand('REMOTE_ON')">Manual ON</button>
             <button class="btn btn-off" onclick="sendCommand('REMOTE_OFF')">Manual OFF</button>
@@ -63,24 +76,40 @@ HTML_TEMPLATE = """
     function sendCommand(cmd) {
         fetch('/command/' + cmd, { method: 'POST' });
     }
-    function updateStatus() {
-        fetch('/status')
-            .then(response => response.json())
+    // 상태 long-poll: 서버는 상태가 바뀔 때만 응답 본문을 보내고 (그 외에는 304)
+    let statusEtag = null;
+    function showStatus(data) {
+        document.getElementById('temp_val').innerText = data.temperature.toFixed(1);
+        document.getElementById('humi_val').innerText = data.humidity.toFixed(1);
+        document.getElementById('mode_status').innerText = data.mode.toUpperCase();
+        const fanStatus = document.getElementById('fan_status');
+        fanStatus.innerText = data.fan_on ? (data.fan_duty < 100 ? 'ON ' + data.fan_duty + '%' : 'ON') : 'OFF';
+        fanStatus.className = data.fan_on ? 'on' : 'off';
+        if (data.energy && data.energy.day) {
+            const day = data.energy.day;
+            document.getElementById('energy_today').innerText =
+                'Fan today: ' + (day.on_s / 3600).toFixed(1) + ' h, ' + day.wh.toFixed(0) + ' Wh';
+        }
+    }
+    function pollStatus() {
+        const headers = statusEtag ? { 'If-None-Match': statusEtag } : {};
+        fetch('/status?wait=25', { headers: headers, cache: 'no-store' })
+            .then(response => {
+                if (response.status === 304) return null;
+                if (!response.ok) throw new Error('HTTP ' + response.status);
+                statusEtag = response.headers.get('ETag');
+                return response.json();
+            })
             .then(data => {
-                document.getElementById('temp_val').innerText = data.temperature.toFixed(1);
-                document.getElementById('humi_val').innerText = data.humidity.toFixed(1);
-                document.getElementById('mode_status').innerText = data.mode.toUpperCase();
-                const fanStatus = document.getElementById('fan_status');
-                fanStatus.innerText = data.fan_on ? 'ON' : 'OFF';
-                fanStatus.className = data.fan_on ? 'on' : 'off';
+                if (data) showStatus(data);
+                pollStatus();
             })
-            .catch(error => console.error('Error fetching status:', error));
+            .catch(error => {
+                console.error('Error fetching status:', error);
+                setTimeout(pollStatus, 3000); // 서버 재시작 등: 3초 후 재시도
+            });
     }
-    // 페이지 로드 시 즉시 상태 업데이트하고, 3초마다 반복
-    document.addEventListener('DOMContentLoaded', function() {
-        updateStatus();
-        setInterval(updateStatus, 3000);
-    });
+    document.addEventListener('DOMContentLoaded', pollStatus);
 </script>
 </body>
 </html>
@@ -108,20 +137,159 @@ def write_to_fifo(command):
         traceback.print_exc() # 전체 에러 스택을 출력
         return f"Error: {e}", 500
 
-# C가 만든 상태 파일을 읽어서 JSON으로 반환하는 API
+# 상태 파일 캐시
+# 제어 데몬이 상태 파일을 다시 쓸 때(inotify, 사용할 수 없으면 주기적 stat)만 한 번 읽고 파싱하며,
+# 내용이 실제로 바뀐 경우에만 버전(ETag)을 올린다. 클라이언트 요청은 캐시된 응답 본문만 돌려주므로
+# 폴링하는 브라우저 수가 늘어도 파일 I/O와 JSON 파싱은 늘지 않는다.
+DEFAULT_STATUS = {"temperature": 0, "humidity": 0, "fan_on": False, "fan_duty": 0, "mode": "unknown"}
+STATUS_RECHECK_SECONDS = 5.0   # inotify 이벤트를 놓쳤을 때를 대비한 stat 확인 주기
+STATUS_POLL_SECONDS = 0.5      # inotify를 쓸 수 없을 때의 stat 확인 주기
+LONG_POLL_MAX_SECONDS = 30.0
+
+IN_CLOSE_WRITE = 0x00000008
+IN_MOVED_TO = 0x00000080
+
+def make_etag(body):
+    return '"' + hashlib.sha1(body).hexdigest()[:16] + '"'
+
+class StatusCache:
+    def __init__(self, path):
+        self.path = path
+        self.cond = threading.Condition()
+        self.stat_key = None
+        self.body = None
+        self.etag = None
+        self.version = 0
+        self._store(json.dumps(DEFAULT_STATUS).encode())
+        self.reload()
+        threading.Thread(target=self._watch, daemon=True).start()
+
+    def _store(self, body):
+        with self.cond:
+            if body == self.body:
+                return
+            self.body = body
+            self.etag = make_etag(body)
+            self.version += 1
+            self.cond.notify_all()
+
+    def reload(self):
+        try:
+            st = os.stat(self.path)
+            key = (st.st_ino, st.st_mtime_ns, st.st_size)
+            if key == self.stat_key:
+                return
+            with open(self.path, 'rb') as f:
+                raw = f.read()
+            data = json.loads(raw)
+        except FileNotFoundError:
+            self.stat_key = None
+            self._store(json.dumps(DEFAULT_STATUS).encode())
+            return
+        except (OSError, ValueError):
+            # 기록 도중 읽은 경우 - 이전 값을 유지하고 다음 이벤트에서 다시 읽음
+            return
+        self.stat_key = key
+        self._store(json.dumps(data).encode())
+
+    def _open_inotify(self):
+        try:
+            libc = ctypes.CDLL(ctypes.util.find_library("c"), use_errno=True)
+            fd = libc.inotify_init1(os.O_NONBLOCK | os.O_CLOEXEC)
+            if fd < 0:
+                return -1
+            directory = os.path.dirname(self.path) or "."
+            if libc.inotify_add_watch(fd, directory.encode(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0:
+                os.close(fd)
+                return -1
+            return fd
+        except (OSError, AttributeError):
+            return -1
+
+    def _watch(self):
+        fd = self._open_inotify()
+        if fd < 0:
+            print("[Flask] inotify unavailable, polling the status file.")
+        name = os.path.basename(self.path).encode()
+        while True:
+            if fd < 0:
+                threading.Event().wait(STATUS_POLL_SECONDS)
+                self.reload()
+                continue
+            ready, _, _ = select.select([fd], [], [], STATUS_RECHECK_SECONDS)
+            if not ready:
+                self.reload()
+                continue
+            try:
+                events = os.read(fd, 4096)
+            except BlockingIOError:
+                continue
+            # struct inotify_event { int wd; uint32 mask, cookie, len; char name[len]; }
+            offset, matched = 0, False
+            while offset + 16 <= len(events):
+                length = int.from_bytes(events[offset + 12:offset + 16], 'little')
+                if events[offset + 16:offset + 16 + length].rstrip(b'\0') == name:
+                    matched = True
+                offset += 16 + length
+            if matched:
+                self.reload()
+
+    def get(self):
+        with self.cond:
+            return self.body, self.etag
+
+    def wait_change(self, etag, timeout):
+        """etag와 다른 상태가 될 때까지 최대 timeout초 대기"""
+        with self.cond:
+            self.cond.wait_for(lambda: self.etag != etag, timeout)
+            return self.body, self.etag
+
+status_cache = StatusCache(STATUS_FILE_PATH)
+
+def client_etag():
+    value = request.headers.get('If-None-Match')
+    return value.replace('W/', '').strip() if value else None
+
+# 상태 조회 API
+#   If-None-Match가 현재 ETag와 같으면 304 (본문 없음)
+#   ?wait=<초>: 상태가 바뀌면 즉시, 바뀌지 않으면 최대 그 시간 후에 응답 (long-poll)
 @app.route('/status')
 def get_status():
+    etag = client_etag()
+    body, current = status_cache.get()
+    wait = request.args.get('wait')
+    if wait and etag == current:
+        try:
+            timeout = min(max(float(wait), 0.0), LONG_POLL_MAX_SECONDS)
+        except ValueError:
+            return "Invalid wait", 400
+        body, current = status_cache.wait_change(etag, timeout)
+    headers = {"ETag": current, "Cache-Control": "no-cache"}
+    if etag == current:
+        return Response(b"", status=304, headers=headers)
+    return Response(body, mimetype="application/json", headers=headers)
+
+# 제어 파이프라인 단계별 처리 시간 (제어기가 주기 타이밍 보고 때 갱신, 상태와 달리 ETag 없이 그대로 전달)
+@app.route('/pipeline')
+def get_pipeline_stats():
     try:
-        with open(STATUS_FILE_PATH, 'r') as f:
-            data = json.load(f)
-        return jsonify(data)
-    except (FileNotFoundError, json.JSONDecodeError):
-        # 파일이 없거나 내용이 비어있을 때 기본값 반환
-        return jsonify({"temperature": 0, "humidity": 0, "fan_on": False, "mode": "unknown"})
+        with open(PIPELINE_STATS_PATH, 'rb') as f:
+            body = f.read()
+    except FileNotFoundError:
+        return "No pipeline stats yet", 404
+    return Response(body, mimetype="application/json", headers={"Cache-Control": "no-cache"})
+
+# 페이지는 시작 시 한 번만 렌더링
+with app.app_context():
+    INDEX_PAGE = render_template_string(HTML_TEMPLATE).encode()
+INDEX_ETAG = make_etag(INDEX_PAGE)
 
 @app.route('/')
 def index():
-    return render_template_string(HTML_TEMPLATE)
+    headers = {"ETag": INDEX_ETAG, "Cache-Control": "no-cache"}
+    if client_etag() == INDEX_ETAG:
+        return Response(b"", status=304, headers=headers)
+    return Response(INDEX_PAGE, mimetype="text/html", headers=headers)
 
 @app.route('/command/<string:cmd>', methods=['POST'])
 def command(cmd):
@@ -129,5 +297,79 @@ def command(cmd):
         return write_to_fifo(cmd)
     return "Invalid command", 400
 
+# 스케줄 규칙 목록 (제어기가 저장한 스케줄 파일을 읽음)
+@app.route('/schedule', methods=['GET'])
+def get_schedule():
+    rules = []
+    try:
+        with open(SCHEDULE_FILE_PATH, 'r') as f:
+            for line in f:
+                line = line.strip()
+                if not line or line.startswith('#'):
+                    continue
+                rule, _, tag = line.partition('#id=')
+                rules.append({"id": int(tag) if tag.isdigit() else None, "rule": rule.strip()})
+    except FileNotFoundError:
+        pass
+    return jsonify(rules)
+
+# 규칙 추가: {"rule": "0 weekdays 08:00-09:00 VENT"}
+@app.route('/schedule', methods=['POST'])
+def add_schedule():
+    body = request.get_json(silent=True) or {}
+    rule = str(body.get("rule", "")).strip()
+    if not rule or len(rule) > 90 or '\n' in rule or '#' in rule:
+        return "Invalid rule", 400
+    return write_to_fifo("SCHED_ADD " + rule)
+
+@app.route('/schedule/<int:rule_id>', methods=['DELETE'])
+def delete_schedule(rule_id):
+    return write_to_fifo(f"SCHED_DEL {rule_id}")
+
+# 이력 내보내기: /export?from=2024-06-01&to=2024-06-30&format=csv|columnar
+# archive_tool이 아카이브를 mmap으로 블록 단위 디코딩해 표준출력으로 보내는 것을 그대로 흘려보내므로
+# 기간이 길어도 서버 메모리는 늘지 않는다. 다운로드가 중단되면 도구 프로세스도 종료한다.
+EXPORT_TIME_PATTERN = re.compile(r'^(\d+|\d{4}-\d{2}-\d{2}(T\d{2}:\d{2}(:\d{2})?)?)$')
+
+@app.route('/export')
+def export_history():
+    fmt = request.args.get('format', 'csv')
+    if fmt not in ("csv", "columnar"):
+        return "Invalid format", 400
+    args = [ARCHIVE_TOOL_PATH, "export", HISTORY_ARCHIVE_PATH, "--format", fmt]
+    for key in ("from", "to"):
+        value = request.args.get(key)
+        if value is None:
+            continue
+        if not EXPORT_TIME_PATTERN.match(value):
+            return f"Invalid '{key}' time", 400
+        args += ["--" + key, value]
+
+    try:
+        proc = subprocess.Popen(args, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    except OSError as e:
+        print(f"[Flask Error] Failed to start archive_tool: {e}")
+        return "Export unavailable", 503
+
+    def generate():
+        try:
+            while True:
+                chunk = proc.stdout.read(64 * 1024)
+                if not chunk:
+                    break
+                yield chunk
+        finally:
+            proc.stdout.close()
+            if proc.poll() is None:
+                proc.terminate()
+            proc.wait()
+
+    if fmt == "csv":
+        mimetype, filename = "text/csv", "smart_vent_history.csv"
+    else:
+        mimetype, filename = "application/octet-stream", "smart_vent_history.svcx"
+    return Response(generate(), mimetype=mimetype,
+                    headers={"Content-Disposition": f"attachment; filename={filename}"})
+
 if __name__ == '__main__':
     app.run(host='0.0.0.0', port=5000)
\ No newline at end of file
@@ -0,0 +1,365 @@
+#!/usr/bin/env python3
+# 원격 제어 경로 부하 시험 도구
+#
+# 여러 휴대폰/자동화 클라이언트가 동시에 remote_control_server.py를 사용하는 상황을 재현한다.
+#   - 상태 조회 클라이언트(pollers): GET /status 를 주기적으로 호출 (3초 간격이 기본)
+#     --conditional: ETag로 조건부 요청 (바뀌지 않았으면 304), --long-poll N: 웹 페이지처럼 ?wait=N long-poll
+#   - 명령 클라이언트(writers): FIFO로 전달되는 명령을 초당 지정 횟수만큼 전송
+#   - 릴레이 프로브: REMOTE_ON/REMOTE_OFF를 번갈아 보내고 팬 릴레이가 실제로 바뀔 때까지의 지연 측정
+# 결과로 처리량, p50/p99 지연, 유실되거나 합쳐진 명령 수, 명령->릴레이 지연을 출력한다.
+#
+# --spawn 을 주면 시뮬레이션 하드웨어(smart_ventilation_sim, SIM_LIVE=1)와 Flask 서버를 직접 띄우므로
+# 라즈베리 파이 없이 빌드 머신에서 실행할 수 있다 (make sim 필요).
+#   python3 remote_load_test.py --spawn --pollers 200 --writers 20 --duration 30
+# 실행 중인 시스템에 대해서는 --url 만 지정한다 (이 경우 릴레이 지연은 --relay-log가 있을 때만 측정).
+
+import argparse
+import http.client
+import json
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from urllib.parse import urlsplit
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+READ_INTERVAL_SECONDS = 3   # 제어 루프 판독 주기 (상태 파일 갱신 주기)
+PROBE_TIMEOUT = 2.0         # 이 시간 안에 릴레이가 바뀌지 않으면 명령 유실로 판단
+NOOP_RULE_ID = 65000        # 존재하지 않는 스케줄 규칙 (삭제 명령이 아무 효과 없이 FIFO 경로만 통과)
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+class RequestStats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.errors = 0
+        self.invalid = 0  # 빈/깨진 상태 응답 (상태 파일을 쓰는 도중 읽은 경우)
+        self.not_modified = 0
+
+    def record(self, latency, ok, valid=True, not_modified=False):
+        with self.lock:
+            if not_modified:
+                self.not_modified += 1
+            if ok:
+                self.latencies.append(latency)
+                if not valid:
+                    self.invalid += 1
+            else:
+                self.errors += 1
+
+    def summary(self, name, duration):
+        n = len(self.latencies)
+        line = (f"[Load] {name:<16}: {n} ok ({n / duration:.1f} req/s), "
+                f"p50 {percentile(self.latencies, 50) * 1000:.1f} ms, "
+                f"p99 {percentile(self.latencies, 99) * 1000:.1f} ms, "
+                f"max {max(self.latencies, default=0.0) * 1000:.1f} ms, errors {self.errors}")
+        if self.invalid:
+            line += f", empty/torn {self.invalid}"
+        if self.not_modified:
+            line += f", 304 {self.not_modified}"
+        return line
+
+
+class Client:
+    """스레드별 HTTP 연결 (서버가 연결을 닫으면 다음 요청에서 다시 연결)"""
+
+    def __init__(self, url, timeout=10.0):
+        parts = urlsplit(url)
+        self.host = parts.hostname or "127.0.0.1"
+        self.port = parts.port or 80
+        self.timeout = timeout
+        self.conn = None
+        self.etag = None  # 마지막 응답의 ETag
+
+    def request(self, method, path, headers=None):
+        for attempt in range(2):
+            if self.conn is None:
+                self.conn = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+            try:
+                self.conn.request(method, path, headers=headers or {})
+                response = self.conn.getresponse()
+                body = response.read()
+                self.etag = response.getheader("ETag")
+                if response.will_close:
+                    self.conn.close()
+                    self.conn = None
+                return response.status, body
+            except (http.client.HTTPException, OSError):
+                self.conn.close()
+                self.conn = None
+                if attempt == 1:
+                    raise
+        return None, b""
+
+
+def read_status(url):
+    try:
+        status, body = Client(url, timeout=3.0).request("GET", "/status")
+        return json.loads(body) if status == 200 else None
+    except (OSError, ValueError, http.client.HTTPException):
+        return None
+
+
+class RelayLog:
+    """시뮬레이터가 기록하는 릴레이 전환 로그를 따라 읽음 ("<epoch 초> <ON|OFF> <듀티>")"""
+
+    def __init__(self, path):
+        self.path = path
+        self.events = []
+        self.cond = threading.Condition()
+        self.stopped = False
+        self.thread = threading.Thread(target=self._follow, daemon=True)
+        self.thread.start()
+
+    def _follow(self):
+        while not os.path.exists(self.path) and not self.stopped:
+            time.sleep(0.05)
+        with open(self.path) as f:
+            pending = ""
+            while not self.stopped:
+                chunk = f.readline()
+                if not chunk:
+                    time.sleep(0.005)
+                    continue
+                pending += chunk
+                if not pending.endswith("\n"):
+                    continue
+                fields = pending.split()
+                pending = ""
+                if len(fields) >= 2:
+                    with self.cond:
+                        self.events.append((float(fields[0]), fields[1] == "ON"))
+                        self.cond.notify_all()
+
+    def wait_for(self, state, since, timeout):
+        """since 이후 state로 바뀐 시각 (timeout 내에 없으면 None)"""
+        deadline = time.time() + timeout
+        with self.cond:
+            while True:
+                for t, on in reversed(self.events):
+                    if t < since:
+                        break
+                    if on == state:
+                        return t
+                remaining = deadline - time.time()
+                if remaining <= 0:
+                    return None
+                self.cond.wait(remaining)
+
+    def stop(self):
+        self.stopped = True
+
+
+def status_poller(url, interval, conditional, long_poll, stop, stats):
+    client = Client(url, timeout=10.0 + long_poll)
+    path = f"/status?wait={long_poll:g}" if long_poll > 0 else "/status"
+    etag = None
+    # 모든 클라이언트가 같은 순간에 몰리지 않도록 시작 시점을 분산
+    time.sleep(random.uniform(0, interval))
+    while not stop.is_set():
+        start = time.monotonic()
+        try:
+            headers = {"If-None-Match": etag} if etag else None
+            status, body = client.request("GET", path, headers)
+            if status == 304:
+                stats.record(time.monotonic() - start, True, not_modified=True)
+            else:
+                valid = True
+                try:
+                    valid = json.loads(body).get("mode") in ("auto", "manual")
+                except ValueError:
+                    valid = False
+                stats.record(time.monotonic() - start, status == 200, valid)
+            if conditional or long_poll > 0:
+                etag = client.etag
+        except (OSError, http.client.HTTPException):
+            stats.record(time.monotonic() - start, False)
+        if interval > 0 and long_poll <= 0:
+            stop.wait(max(0.0, interval - (time.monotonic() - start)))
+
+
+def command_writer(url, rate, command, stop, stats, counters):
+    client = Client(url)
+    if command == "noop":
+        method, path = "DELETE", f"/schedule/{NOOP_RULE_ID}"
+    else:
+        method, path = "POST", f"/command/{command}"
+    interval = 1.0 / rate
+    next_send = time.monotonic() + random.uniform(0, interval)
+    while not stop.is_set():
+        stop.wait(max(0.0, next_send - time.monotonic()))
+        if stop.is_set():
+            break
+        next_send += interval
+        start = time.monotonic()
+        try:
+            status, _ = client.request(method, path)
+            ok = status == 200
+        except (OSError, http.client.HTTPException):
+            ok = False
+        stats.record(time.monotonic() - start, ok)
+        with counters["lock"]:
+            counters["sent"] += 1
+            counters["accepted" if ok else "rejected"] += 1
+
+
+def relay_probe(url, relay, interval, stop, counters, delays):
+    client = Client(url)
+    state = True
+    while not stop.is_set():
+        command = "REMOTE_ON" if state else "REMOTE_OFF"
+        sent_at = time.time()
+        try:
+            status, _ = client.request("POST", f"/command/{command}")
+            ok = status == 200
+        except (OSError, http.client.HTTPException):
+            ok = False
+        with counters["lock"]:
+            counters["sent"] += 1
+            counters["accepted" if ok else "rejected"] += 1
+        if ok and relay is not None:
+            changed_at = relay.wait_for(state, sent_at, PROBE_TIMEOUT)
+            if changed_at is None:
+                counters["probe_lost"] += 1
+            else:
+                delays.append(changed_at - sent_at)
+        state = not state
+        stop.wait(interval)
+
+
+def write_flat_trace(path, duration):
+    # 자동 모드에서 팬이 켜지지 않는 쾌적한 값 (릴레이 전환은 프로브 명령으로만 발생)
+    with open(path, "w") as f:
+        f.write("# remote_load_test: constant comfortable readings\n")
+        for t in range(0, int(duration) + 1, READ_INTERVAL_SECONDS):
+            f.write(f"{t},22.0,45.0\n")
+
+
+def spawn_stack(args, workdir):
+    trace = os.path.join(workdir, "flat_trace.csv")
+    relay_log = os.path.join(workdir, "relay.log")
+    write_flat_trace(trace, args.duration + 60)
+
+    env = dict(os.environ, SIM_LIVE="1", SIM_RELAY_LOG=relay_log)
+    sim_out = open(os.path.join(workdir, "sim.log"), "w")
+    sim = subprocess.Popen([args.sim, trace, "/tmp/smart_vent_status.json"],
+                           stdout=sim_out, stderr=subprocess.STDOUT, env=env)
+    server_out = open(os.path.join(workdir, "server.log"), "w")
+    server = subprocess.Popen([sys.executable, os.path.join(SCRIPT_DIR, "remote_control_server.py")],
+                              stdout=server_out, stderr=subprocess.STDOUT)
+    return [sim, server], relay_log
+
+
+def wait_ready(url, timeout=20.0):
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        status = read_status(url)
+        if status is not None and "remote_commands" in status:
+            return status
+        time.sleep(0.5)
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Remote control load test")
+    parser.add_argument("--url", default="http://127.0.0.1:5000")
+    parser.add_argument("--pollers", type=int, default=200, help="concurrent /status clients")
+    parser.add_argument("--poll-interval", type=float, default=3.0, help="seconds between polls (0: flood)")
+    parser.add_argument("--conditional", action="store_true", help="send If-None-Match with the last ETag")
+    parser.add_argument("--long-poll", type=float, default=0.0, help="use /status?wait=N like the web page")
+    parser.add_argument("--writers", type=int, default=20, help="concurrent command clients")
+    parser.add_argument("--command-rate", type=float, default=2.0, help="commands per second per writer")
+    parser.add_argument("--writer-command", default="noop", choices=["noop", "REMOTE_AUTO"],
+                        help="noop: delete an unused schedule rule (does not disturb the relay probe)")
+    parser.add_argument("--probe-interval", type=float, default=1.0)
+    parser.add_argument("--duration", type=float, default=30.0)
+    parser.add_argument("--spawn", action="store_true", help="start the simulated daemon and the Flask server")
+    parser.add_argument("--sim", default=os.path.join(SCRIPT_DIR, "smart_ventilation_sim"))
+    parser.add_argument("--relay-log", help="relay transition log written by the simulator (SIM_RELAY_LOG)")
+    args = parser.parse_args()
+
+    processes = []
+    workdir = None
+    relay_log_path = args.relay_log
+    if args.spawn:
+        workdir = tempfile.mkdtemp(prefix="smart_vent_load_")
+        processes, relay_log_path = spawn_stack(args, workdir)
+        print(f"[Load] Started simulated daemon and server (logs in {workdir})")
+
+    try:
+        baseline = wait_ready(args.url)
+        if baseline is None:
+            print("[Load] Server or control daemon not ready (no remote_commands in /status).", file=sys.stderr)
+            return 1
+        relay = RelayLog(relay_log_path) if relay_log_path else None
+
+        stop = threading.Event()
+        poll_stats, command_stats = RequestStats(), RequestStats()
+        counters = {"lock": threading.Lock(), "sent": 0, "accepted": 0, "rejected": 0, "probe_lost": 0}
+        delays = []
+        threads = [threading.Thread(target=status_poller,
+                                    args=(args.url, args.poll_interval, args.conditional, args.long_poll,
+                                          stop, poll_stats))
+                   for _ in range(args.pollers)]
+        threads += [threading.Thread(target=command_writer,
+                                     args=(args.url, args.command_rate, args.writer_command, stop,
+                                           command_stats, counters))
+                    for _ in range(args.writers)]
+        threads.append(threading.Thread(target=relay_probe,
+                                        args=(args.url, relay, args.probe_interval, stop, counters, delays)))
+
+        print(f"[Load] Running {args.pollers} pollers, {args.writers} writers for {args.duration:.0f} s...")
+        started = time.monotonic()
+        for t in threads:
+            t.daemon = True
+            t.start()
+        time.sleep(args.duration)
+        stop.set()
+        for t in threads:
+            t.join(timeout=PROBE_TIMEOUT + 10)
+        elapsed = time.monotonic() - started
+
+        # 제어 루프가 처리한 명령 수는 다음 판독 때 상태 파일에 반영됨
+        time.sleep(READ_INTERVAL_SECONDS + 1)
+        final = read_status(args.url) or {}
+        processed = final.get("remote_commands", baseline["remote_commands"]) - baseline["remote_commands"]
+        if relay:
+            relay.stop()
+
+        print("\n[Load] ---- Remote control load test ----")
+        print(f"[Load] Duration        : {elapsed:.1f} s, {args.pollers} pollers, {args.writers} writers "
+              f"x {args.command_rate:g}/s ({args.writer_command})")
+        print(poll_stats.summary("GET /status", elapsed))
+        print(command_stats.summary("Commands (HTTP)", elapsed))
+        print(f"[Load] Commands        : sent {counters['sent']}, accepted {counters['accepted']}, "
+              f"rejected {counters['rejected']}, processed {processed}, "
+              f"dropped/merged {max(0, counters['accepted'] - processed)}")
+        if relay:
+            print(f"[Load] Command->relay  : {len(delays)} probes, p50 {percentile(delays, 50) * 1000:.1f} ms, "
+                  f"p99 {percentile(delays, 99) * 1000:.1f} ms, max {max(delays, default=0.0) * 1000:.1f} ms, "
+                  f"lost {counters['probe_lost']}")
+        else:
+            print("[Load] Command->relay  : not measured (use --spawn or --relay-log)")
+        return 0
+    finally:
+        for p in reversed(processes):
+            p.terminate()
+            try:
+                p.wait(timeout=10)
+            except subprocess.TimeoutExpired:
+                p.kill()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -34,5 +34,73 @@ lsmod | grep "fpga"
 echo "Kernel module loading process finished."
 
 # --- 3. Run the Compiled Application ---
-echo "[3/3] Running the Smart Ventilation System GUI application..."
-sudo ./smart_ventilation
\ No newline at end of file
+# Directory for the compressed sensor history archive
+mkdir -p /var/lib/smart_vent
+# Alarm rules (LCD/buzzer warnings); install the example once, keep local edits
+mkdir -p /etc/smart_vent
+if [ ! -f /etc/smart_vent/alarms.conf ]; then
+    cp ./alarms.conf /etc/smart_vent/alarms.conf
+fi
+# GPIO pins, thresholds and read interval; edits are applied by the running daemon
+if [ ! -f /etc/smart_vent/smart_vent.conf ]; then
+    cp ./smart_vent.conf /etc/smart_vent/smart_vent.conf
+fi
+# Optional real-time mode (sudo REALTIME=1 ./start.sh):
+# move pigpiod to the last core with FIFO priority, the application pins its
+# capture/control threads there and keeps GUI/network threads on the other cores.
+APP_ARGS=""
+if [ "$REALTIME" = "1" ]; then
+    RT_CPU=$(( $(nproc) - 1 ))
+    echo "Real-time mode: pinning pigpiod to CPU ${RT_CPU}"
+    taskset -a -pc ${RT_CPU} $(pidof pigpiod) > /dev/null
+    chrt -a -f -p 85 $(pidof pigpiod)
+    APP_ARGS="--realtime"
+fi
+# Variable-speed 4-wire fan on GPIO 18 hardware PWM (sudo FAN_PWM=1 ./start.sh);
+# the relay on GPIO 24 still switches fan power.
+if [ "$FAN_PWM" = "1" ]; then
+    APP_ARGS="${APP_ARGS} --pwm"
+fi
+# Rated fan power used for the energy estimate in status/GUI (default 24 W), e.g. sudo FAN_WATTS=40 ./start.sh
+if [ -n "$FAN_WATTS" ]; then
+    APP_ARGS="${APP_ARGS} --fan-watts ${FAN_WATTS}"
+fi
+# Stopping the daemon leaves the fan as it is, so restarts and upgrades are invisible; the next start
+# resumes mode, fan state and alarms from /var/lib/smart_vent/state.ckpt. To switch the fan off on exit,
+# e.g. before removing the controller: sudo FAN_OFF_ON_EXIT=1 ./start.sh
+if [ "$FAN_OFF_ON_EXIT" = "1" ]; then
+    APP_ARGS="${APP_ARGS} --fan-off-on-exit"
+fi
+# DHT bit decoder: adaptive per-frame boundary (default) or the fixed pulse windows,
+# e.g. sudo DHT_DECODER=fixed ./start.sh
+if [ -n "$DHT_DECODER" ]; then
+    APP_ARGS="${APP_ARGS} --dht-decoder ${DHT_DECODER}"
+fi
+# Telemetry target as IPv4 address or host name (default multicast 239.255.42.99:5005),
+# e.g. sudo TELEMETRY=collector.local:5005 ./start.sh;
+# TELEMETRY=off disables it.
+if [ "$TELEMETRY" = "off" ]; then
+    APP_ARGS="${APP_ARGS} --no-telemetry"
+elif [ -n "$TELEMETRY" ]; then
+    APP_ARGS="${APP_ARGS} --telemetry ${TELEMETRY}"
+fi
+# Control-loop log destination (file path or "syslog" for journald), e.g. sudo LOG=syslog ./start.sh
+if [ -n "$LOG" ]; then
+    APP_ARGS="${APP_ARGS} --log ${LOG}"
+fi
+echo "[3/3] Running the Smart Ventilation System control daemon..."
+sudo ./smart_ventilation ${APP_ARGS} &
+DAEMON_PID=$!
+
+# The panel GUI is a separate client; ventilation keeps running if it exits.
+# Panel-less installations: sudo HEADLESS=1 ./start.sh
+if [ "$HEADLESS" != "1" ] && [ -x ./smart_vent_gui ]; then
+    echo "Starting the GUI client..."
+    ./smart_vent_gui &
+fi
+
+# Forward Ctrl+C to the daemon so it can save its state and flush its archive
+trap 'kill -TERM ${DAEMON_PID}' INT TERM
+while kill -0 ${DAEMON_PID} 2> /dev/null; do
+    wait ${DAEMON_PID}
+done
\ No newline at end of file